@@ -0,0 +1,60 @@
+/*
+* Header file for arena.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator whose allocations are all released together
+typedef struct Arena Arena;
+
+// Usage statistics of one arena
+typedef struct ArenaStats {
+    size_t num_allocs;  // allocations served
+    size_t bytes_requested;  // sum of requested sizes
+    size_t bytes_reserved;  // bytes currently held in blocks
+    size_t peak_reserved;  // largest bytes_reserved seen
+    size_t num_blocks;  // blocks currently held
+    size_t num_resets;  // calls to arena_reset
+} ArenaStats;
+
+// Create an arena that grows in blocks of block_size bytes (0 for default)
+// - returns NULL if failed
+Arena *arena_new(size_t block_size);
+
+// Allocate size bytes, aligned for any type, valid until reset/free
+// - returns NULL if failed
+void *arena_alloc(Arena *arena, size_t size);
+
+// Copy a string into the arena
+// - returns NULL if failed
+char *arena_strdup(Arena *arena, const char *s);
+
+// Release every allocation but keep the first block for reuse
+void arena_reset(Arena *arena);
+
+// Move all blocks and statistics of child into arena, then free child
+// - allocations made from child stay valid until arena is freed
+void arena_adopt(Arena *arena, Arena *child);
+
+// Copy the arena's usage statistics into out
+void arena_stats(const Arena *arena, ArenaStats *out);
+
+// Free the arena and everything allocated from it
+void arena_free(Arena *arena);
+
+// Set the calling thread's current arena (NULL for plain malloc)
+// - row and hmap constructors allocate from the current arena
+void arena_set_current(Arena *arena);
+
+// Get the calling thread's current arena
+// - returns NULL if none is set
+Arena *arena_current(void);
+
+#endif
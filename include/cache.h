@@ -0,0 +1,55 @@
+/*
+* Header file for cache.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include "table.h"
+
+// Suffix of the cache image written next to a source file
+#define CACHE_SUFFIX ".cache"
+
+// Identity of a source file: an image is only used for the same inode,
+// size and modification time
+typedef struct CacheKey {
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+} CacheKey;
+
+// Mapped cache image of a parsed table
+typedef struct CacheImage CacheImage;
+
+// Get the identity of a source file
+// - returns 0 on success, -1 if it is not a readable regular file
+int cache_key(const char *source_path, CacheKey *key);
+
+// Map the cache image of source_path if it was written for key
+// - returns NULL if the image is missing, stale or corrupt
+CacheImage *cache_open(const char *source_path, const CacheKey *key);
+
+// Create a table over the image (free with table_free before cache_close)
+// - returns NULL if failed
+Table *cache_table(const CacheImage *image);
+
+// Unmap the image
+void cache_close(CacheImage *image);
+
+// Write the image of a freshly loaded table (before any operator) next to
+// source_path; the image only replaces an older one once complete
+// - returns 0 on success, -1 if failed or the source changed since key was taken
+int cache_save(const char *source_path, const CacheKey *key, const Table *table);
+
+// Rename a completely written sidecar (cache image, index, zone map) from
+// tmp_path to path if source_path still matches key, else remove tmp_path
+// - returns 0 on success, -1 if the source changed or the rename failed
+int cache_commit(const char *tmp_path, const char *path, const char *source_path, const CacheKey *key);
+
+#endif
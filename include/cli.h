@@ -9,12 +9,24 @@
 *   --select name,age or numeric indices (0,2)
 *   --where expressions like age>=18
 *   --group-by <name|index>
-*   --order-by <name|index[:asc|:desc]> (defaults to asc)
+*   --order-by <name|index[:asc|:desc]>[,...] (defaults to asc)
+*   --threads <n> threads for parsing --file input and for ORDER BY (defaults to 1)
+*   --stats prints memory statistics to stderr
+*   --output <path> writes the result to a file (defaults to stdout)
+*   --columnar loads GROUP BY/ORDER BY queries into a column-oriented Table
+*   --cache maps <file>.cache instead of parsing --file input (written on first use)
+*   --build-index <name|index> writes <file>.<index>.idx for equality WHERE lookups
+*   --build-zonemap <name|index> writes <file>.<index>.zmap for range WHERE filters
+*   --io-uring reads --file input through io_uring when the kernel allows it
+*   --limit <n> / --offset <n> write at most n data rows after skipping n
+*   --memory-limit <size> sorts ORDER BY rows within size bytes (K/M/G suffix)
 */
 
 #ifndef CLI_H
 #define CLI_H
 
+#include <stddef.h>
+
 int cli_parse_args(int argc, char* argv[]);
 void cli_init(void);
 void cli_cleanup(void);
@@ -27,6 +39,17 @@ extern char* g_where_cond;
 extern int g_help_flag;
 extern int g_use_stdin;
 extern char* g_group_by_col;
-extern char* g_order_by_col;
+extern char* g_order_by_col;  // one or more comma-separated columns
+extern int g_threads;
+extern int g_stats;
+extern char* g_output_path;
+extern int g_columnar;
+extern int g_cache;
+extern char* g_build_index_col;
+extern char* g_build_zonemap_col;
+extern int g_io_uring;
+extern long g_limit;  // -1 without --limit
+extern long g_offset;
+extern size_t g_memory_limit;  // 0 without --memory-limit
 
 #endif
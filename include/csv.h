@@ -5,6 +5,18 @@
 *
 * CSV parsing/writing helpers:
 * - csv_read trims tokens, strips newlines, pads missing trailing cells with ""
+* - quoted fields follow RFC 4180 (commas, newlines and "" escapes inside quotes)
+* - a quote that does not start a field is an ordinary character
+* - csv_map_open/csv_read_mapped parse an mmap'd file in place (cells are
+*   NUL-terminated in a private mapping, so parsed pages are copied on write)
+* - csv_read_mapped_parallel splits a mapped file across threads
+* - csv_reader_project/csv_reader_filter parse only the columns a query uses
+*   and skip records failing its WHERE before tokenizing them (pushdown);
+*   csv_read_pushdown/csv_read_mapped_pushdown set them up from the header
+* - csv_read_table/csv_read_mapped_table load a column-oriented Table
+* - csv_reader_open/next/close stream rows one at a time (seek/offset on mapped files)
+* - csv_write_row writes one row, csv_write a whole Vec
+* - csv_write_row_to/csv_write_to format into a buffered Writer (writer.h)
 * - csv_validate_columns checks name or numeric indices in a comma list
 * - csv_write accepts name or numeric selections and returns -1 on invalid selection
 */
@@ -15,16 +27,121 @@
 #include <stdio.h>
 #include "vec.h"
 #include "row.h"
+#include "writer.h"
+#include "table.h"
+#include "where.h"
 
-#define MAX_LINE_LENGTH 2048
+// Memory-mapped input file
+typedef struct CsvMap CsvMap;
+
+// Pull-based row reader (one row at a time)
+typedef struct CsvReader CsvReader;
+
+// Called once the header is read, before any data row, to limit the reader
+// (see csv_reader_project and csv_reader_filter)
+// - returns 0 on success, -1 to fail the read
+typedef int (*CsvHeaderFn)(const Row *header, CsvReader *reader, void *arg);
 
 // Read CSV from file
 Vec* csv_read(FILE *input);
 
+// Read CSV from file, with the projection and filter on_header sets on the
+// reader once the header is read (the header row itself stays whole)
+// - returns NULL if failed
+Vec *csv_read_pushdown(FILE *input, CsvHeaderFn on_header, void *arg);
+
+// Map a regular file privately for reading in place
+// - parsed pages are copied on write (about the file size for a full table)
+// - returns NULL if the file cannot be opened or mapped
+CsvMap *csv_map_open(const char *path);
+
+// Read CSV from a mapped file into view rows pointing into the mapping
+// - rows must be freed before the map is closed
+Vec *csv_read_mapped(CsvMap *map);
+
+// Parse a mapped file with up to num_threads threads (rows in file order)
+// - small files fall back to csv_read_mapped
+// - returns NULL if failed
+Vec *csv_read_mapped_parallel(CsvMap *map, int num_threads);
+
+// Same as csv_read_mapped_parallel, with the projection and filter on_header
+// sets once the header is read (copied to every parse thread)
+// - returns NULL if failed
+Vec *csv_read_mapped_pushdown(CsvMap *map, int num_threads, CsvHeaderFn on_header, void *arg);
+
+// Read CSV from a FILE* into a column-oriented table (record 0 is the header)
+// - empty input gives a table without rows
+// - returns NULL if failed
+Table *csv_read_table(FILE *input);
+
+// Read CSV from a mapped file into a column-oriented table (cells are copied)
+// - returns NULL if failed
+Table *csv_read_mapped_table(CsvMap *map);
+
+// Unmap a file mapped with csv_map_open
+void csv_map_close(CsvMap *map);
+
+// Open a row reader over a stream or a mapped file
+// - returns NULL if failed
+CsvReader *csv_reader_open(FILE *input);
+CsvReader *csv_reader_open_mapped(CsvMap *map);
+
+// Get the next row (caller frees it with row_free)
+// - the row's cells are only valid until the next call or close
+// - returns NULL at end of input or on error
+Row *csv_reader_next(CsvReader *reader);
+
+// Parse only the columns with keep[i] != 0 in the rows read from now on
+// - other columns read as "", columns past the last kept one are missing
+// - keeping every column (or none) parses whole rows
+// - returns 0 on success, -1 if failed
+int csv_reader_project(CsvReader *reader, const unsigned char *keep, int num_cols);
+
+// Skip the rows that do not satisfy cond from now on, checking the raw
+// target field before a row is tokenized (NULL returns every row again)
+// - cond must outlive the reader; do not combine with csv_reader_seek
+// - returns 0 on success, -1 if failed
+int csv_reader_filter(CsvReader *reader, const WhereCond *cond);
+
+// Check whether the last NULL from csv_reader_next was an error
+// - returns 1 on error, 0 at end of input
+int csv_reader_failed(const CsvReader *reader);
+
+// Get the byte offset in the file of the last row returned
+// - returns SIZE_MAX for stream readers or before the first row
+size_t csv_reader_offset(const CsvReader *reader);
+
+// Move a mapped reader to the row starting at offset (read each row at most once)
+// - returns 0 on success, -1 for stream readers or invalid offsets
+int csv_reader_seek(CsvReader *reader, size_t offset);
+
+// Close a reader (does not close the FILE* or map)
+void csv_reader_close(CsvReader *reader);
+
 // Validate column names
 int csv_validate_columns(Row* header, const char* selected_cols);
 
+// Check whether a cell must be quoted on output
+// - returns 1 if it contains a comma or newline, starts with a quote, or has edge blanks
+int csv_needs_quotes(const char *val);
+
+// Write one row (cells at indices, or the first count cells if indices is NULL)
+// - returns 0 on success, -1 if failed
+int csv_write_row(FILE* output, const Row* row, const int* indices, int count);
+
 // Write output (selected columns or all)
 int csv_write(FILE* output, Vec* rows, const char* selected_cols);
 
+// Write the visible rows and columns of a table (header first)
+// - returns 0 on success, -1 if failed
+int csv_write_table(Writer* writer, const Table* table);
+
+// Append one row to a buffered writer (same format as csv_write_row)
+// - returns 0 on success, -1 if failed
+int csv_write_row_to(Writer* writer, const Row* row, const int* indices, int count);
+
+// Append rows to a buffered writer (same selection rules as csv_write)
+// - returns 0 on success, -1 if failed
+int csv_write_to(Writer* writer, Vec* rows, const char* selected_cols);
+
 #endif
@@ -0,0 +1,55 @@
+/*
+* Header file for extsort.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include "row.h"
+#include "sort.h"
+#include <stddef.h>
+
+// Smallest memory budget (smaller budgets are raised to it)
+#define EXTSORT_MIN_MEMORY (1u << 20)
+
+// Runs merged at once; this many runs of one size are merged into one run
+#define EXTSORT_MERGE_WIDTH 64
+
+// Sorter that buffers rows up to a memory budget and spills sorted runs to
+// temporary files (see extsort.c)
+typedef struct ExtSort ExtSort;
+
+// Callback receiving the sorted rows (the row is only valid during the call)
+// - returns 0 to continue, nonzero to stop
+typedef int (*ExtSortFn)(const Row *row, void *arg);
+
+// Create a sorter ordering rows by columns cols like sort_by_columns
+// - memory_limit bounds the bytes of buffered rows and sort scratch
+// - runs are sorted with up to num_threads threads
+// - temporary files go to $TMPDIR (or /tmp) and are unlinked at once
+// - returns NULL if failed, also when no temporary file can be created there
+ExtSort *extsort_new(const SortColumn *cols, int num_cols, size_t memory_limit, int num_threads);
+
+// Add a copy of row, writing the buffered rows out as a sorted run first
+// when they fill the budget
+// - NULL cells inside the row read back as empty cells
+// - returns 0 on success, -1 if failed (a run could not be written)
+int extsort_add(ExtSort *sorter, const Row *row);
+
+// Get the number of runs written to temporary files so far
+size_t extsort_num_runs(const ExtSort *sorter);
+
+// Pass every added row to fn in sorted order (equal keys in the order they
+// were added), merging the runs with the rows still buffered
+// - stops early when fn returns nonzero
+// - returns 0 on success, -1 if failed (a run could not be written or read)
+int extsort_finish(ExtSort *sorter, ExtSortFn fn, void *arg);
+
+// Free the sorter, its rows and its temporary files
+void extsort_free(ExtSort *sorter);
+
+#endif
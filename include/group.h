@@ -10,6 +10,7 @@
 #include "vec.h"
 #include "row.h"
 #include "hmap.h"
+#include "table.h"
 
 /* Groups rows by a specific column index.
  * Returns a new Vec* containing one representative Row* per group.
@@ -29,6 +30,14 @@
  */
 Vec* group_by_column(Vec* rows, int col_index);
 
+/* Groups the visible rows of a table by a column, in place.
+ * Keeps the first row of each key, like group_by_column.
+ *
+ * RETURNS:
+ *  0 on success, -1 on invalid arguments or allocation failure
+ */
+int group_table_by_column(Table* table, int col_index);
+
 /* Placeholder for aggregation functionality.
  * To be implemented. 
  *
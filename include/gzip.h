@@ -0,0 +1,31 @@
+/*
+* Header file for gzip.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <stdio.h>
+
+// Decompressed bytes per queued buffer
+#define GZIP_BUFFER_SIZE (256u << 10)
+
+// Buffers the inflate thread may fill ahead of the reader
+#define GZIP_QUEUE_DEPTH 4
+
+// Check whether a file starts with the gzip magic bytes
+// - returns 1 if it does, 0 otherwise (also if it cannot be read)
+int gzip_detect(const char *path);
+
+// Open a stream of the decompressed contents of a gzip file (concatenated
+// members are read back to back); a thread inflates ahead of the reader
+// - read errors and corrupt data set the stream's error indicator (ferror)
+// - fclose() stops the thread, which then closes the file
+// - returns NULL if the file cannot be opened or the thread not started
+FILE *gzip_open(const char *path);
+
+#endif
@@ -16,6 +16,7 @@
 typedef struct HMap HMap;
 
 // Create new hash map with initial capacity
+// - allocates from the thread's current arena if one is set
 // - returns NULL if failed
 HMap *hmap_new(size_t capacity);
 
@@ -35,11 +36,16 @@ void *hmap_get_or_default(const HMap *map, const char *key, void *default_value)
 // - returns removed value if key existed, NULL if key not found
 void *hmap_remove(HMap *map, const char *key);
 
+// Hash a string key the way the map does (djb2)
+// - returns 0 for NULL
+size_t hmap_hash(const char *key);
+
 // Get number of key-value pairs
 size_t hmap_size(const HMap *map);
 
 // Free hash map
 // - does not free value pointers
+// - no-op for maps owned by an arena (freed with the arena)
 void hmap_free(HMap *map);
 
 #endif
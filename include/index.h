@@ -0,0 +1,40 @@
+/*
+* Header file for index.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stddef.h>
+#include "cache.h"
+#include "csv.h"
+
+// Suffix of an index file: "<source>.<column>.idx"
+#define INDEX_SUFFIX ".idx"
+
+// Mapped hash index of one column of a source file
+typedef struct Index Index;
+
+// Build the index of column from the rest of a mapped reader (header already
+// read) and write it next to source_path
+// - key is the source's identity taken before it was read (see cache_key)
+// - returns 0 on success, -1 if failed or the source changed meanwhile
+int index_build(CsvReader *reader, int column, const char *source_path, const CacheKey *key);
+
+// Map the index of column if it was built for key
+// - returns NULL if the index is missing, stale or corrupt
+Index *index_open(const char *source_path, int column, const CacheKey *key);
+
+// Find the byte offsets of the records whose cell may equal value, in
+// increasing order (hash matches; callers recheck the cell)
+// - returns a newly allocated array of *count offsets, NULL if failed
+size_t *index_lookup(const Index *index, const char *value, size_t *count);
+
+// Unmap the index
+void index_close(Index *index);
+
+#endif
@@ -0,0 +1,41 @@
+/*
+* Header file for prefetch.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Bytes per buffer of a read-ahead stream over a FILE*
+#define PREFETCH_STREAM_BUFFER_SIZE (1u << 20)
+
+// Buffers of a read-ahead stream over a FILE* (one filled while one is parsed)
+#define PREFETCH_STREAM_DEPTH 2
+
+// Fill callback: writes up to cap bytes of the source into buf
+// - returns the number of bytes written (0 at end of input), -1 if failed
+typedef long (*PrefetchFill)(void *source, char *buf, size_t cap);
+
+// Release callback: frees the source once nothing reads it any more
+typedef void (*PrefetchRelease)(void *source);
+
+// Open a stream whose bytes a separate thread reads ahead from source into
+// a queue of depth buffers of buffer_size bytes
+// - a failed fill sets the stream's error indicator (ferror) once the bytes
+//   before it are read
+// - fclose() returns at once; release (may be NULL) runs when the thread stops
+// - returns NULL if failed (source is then not released)
+FILE *prefetch_open(PrefetchFill fill, PrefetchRelease release, void *source, size_t buffer_size, int depth);
+
+// Open a double-buffered read-ahead stream over source (stdin, a pipe)
+// - fclose() also closes source if close_source is nonzero
+// - returns NULL if failed
+FILE *prefetch_stream(FILE *source, int close_source);
+
+#endif
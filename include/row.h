@@ -10,15 +10,37 @@
 #define ROW_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 // Row structure for storing CSV row data
 typedef struct Row Row;
 
+// Largest line (or total cell bytes) a single row can address
+#define ROW_MAX_BYTES ((size_t)0x7fffffff)
+
+// Rows are allocated from the thread's current arena when one is set
+// (see arena.h); row_free leaves those to the arena
+
 // Create a new row with num_cols columns
 // - returns NULL if failed
 Row *row_new(int num_cols);
 
+// Create a row from a tokenized line in one allocation (bytes are copied)
+// - line[0..len) must hold every cell NUL-terminated, offsets[i] is cell i's start
+// - returns NULL if failed
+Row *row_new_packed(const char *line, size_t len, const uint32_t *offsets, int num_cols);
+
+// Create a view row whose cells borrow bytes from a tokenized line (not copied)
+// - line must stay valid for the lifetime of the row
+// - returns NULL if failed
+Row *row_new_view(const char *line, const uint32_t *offsets, int num_cols);
+
+// Create a row holding copies of num_cols strings in one allocation
+// - returns NULL if failed
+Row *row_new_from_cells(const char *const *values, int num_cols);
+
 // Set cell at column col (0-based) to value
+// - may invalidate pointers returned by row_get_cell for this row
 // - returns 0 on success, -1 if failed
 int row_set_cell(Row *row, int col, const char *value);
 
@@ -0,0 +1,53 @@
+/*
+* Header file for scan.c
+* 
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of bytes classified by one scan_block() call
+#define SCAN_BLOCK_SIZE 64
+
+// Positions of structural characters in one block (bit i = byte i)
+typedef struct ScanMasks {
+    uint64_t comma;  // bytes equal to ','
+    uint64_t newline;  // bytes equal to '\n'
+    uint64_t quote;  // bytes equal to '"'
+    uint64_t blank;  // bytes equal to ' ' or '\t'
+} ScanMasks;
+
+// Quote state of a scan, carried from block to block
+typedef struct QuoteState {
+    int inside;  // 1 inside a quoted region
+    int field_start;  // 1 if only blanks were seen since the field began
+    int closed;  // 1 if the last byte closed a quoted region
+} QuoteState;
+
+// Quote state at the start of a record
+#define QUOTE_STATE_INIT { 0, 1, 0 }
+
+// Classify SCAN_BLOCK_SIZE bytes starting at block (all must be readable)
+void scan_block(const char *block, ScanMasks *out);
+
+// Classify the first len bytes at data (len may be < SCAN_BLOCK_SIZE)
+// - bits for bytes at or past len are cleared
+void scan_partial(const char *data, size_t len, ScanMasks *out);
+
+// Mask of the bytes inside quoted fields, from a block's masks
+// - a quote opens a quoted field only as the first non-blank byte of a field;
+//   other quotes outside quotes are literal (except the second one of "")
+// - bit i is set if byte i is an opening quote or lies after one
+// - state carries across blocks (start each record with QUOTE_STATE_INIT)
+uint64_t scan_quote_mask(const ScanMasks *masks, QuoteState *state);
+
+// Name of the implementation picked for this CPU ("avx2", "sse2" or "scalar")
+const char *scan_impl_name(void);
+
+#endif
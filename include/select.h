@@ -11,10 +11,12 @@
 #include "hmap.h"
 #include "vec.h"
 #include "row.h"
+#include "table.h"
 
 
 int select_parse_indices(const char *, const HMap *, int, int **, int *);
 Vec *select_project_rows(const Vec *, const int *, int);
+int select_project_table(Table *, const int *, int);
 
 
 #endif
\ No newline at end of file
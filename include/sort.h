@@ -9,9 +9,76 @@
 
 #include "vec.h"
 #include "row.h"
+#include "table.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Kinds of sort keys, in the order cells of different kinds are compared */
+enum {
+    SORT_KEY_MISSING,   // missing cell, sorts first in either direction
+    SORT_KEY_LOW_TEXT,  // text starting below '+' (strcmp puts it before numbers)
+    SORT_KEY_INT,       // integer that fits int64_t, num holds its value
+    SORT_KEY_DECIMAL,   // any other number (compared with integers by value)
+    SORT_KEY_TEXT,      // any other text, compared with strcmp
+    SORT_KEY_ENCODED    // several columns encoded by sort_key_encode_row
+};
+
+/* Sort key of one row: the sort column cell, parsed once before sorting */
+typedef struct SortKey {
+    int64_t num;       // value of an integer cell (length of an encoded key)
+    const char *text;  // cell text (NULL for a missing cell) or encoded key
+    size_t pos;        // position of the row before sorting (breaks ties)
+    int kind;          // SORT_KEY_*
+} SortKey;
+
+/* One column of a multi-column ORDER BY */
+typedef struct SortColumn {
+    int col_index;  // column to sort by
+    int ascending;  // 1 for ascending order, 0 for descending order
+} SortColumn;
+
+/* Bytes sort_key_encode may need beyond the length of the cell */
+#define SORT_KEY_ENCODE_EXTRA 6
+
+/* Fills in the sort key of a cell (NULL for a missing cell) at position pos.
+ * The key points at the cell, which must outlive it.
+ */
+void sort_key_init(SortKey *key, const char *cell, size_t pos);
+
+/* Compares two sort keys in the order sort_by_column sorts rows: missing
+ * cells first, then texts starting below '+', numbers by value, and other
+ * texts (texts with strcmp).
+ *
+ * RETURNS:
+ *   negative, zero or positive as a sorts before, with or after b
+ */
+int sort_key_compare(const SortKey *a, const SortKey *b, int ascending);
+
+/* Encodes a cell (NULL for a missing cell) as bytes that memcmp orders
+ * like sort_key_compare in the given direction. No encoding is a prefix
+ * of another, so encodings of several columns written one after another
+ * compare like the columns one by one.
+ * out needs room for strlen(cell) + SORT_KEY_ENCODE_EXTRA bytes.
+ *
+ * RETURNS:
+ *   number of bytes written
+ */
+size_t sort_key_encode(unsigned char *out, const char *cell, int ascending);
+
+/* Encodes the cells of a row in columns cols into one key (see
+ * sort_key_encode) in *buf, growing the buffer (*cap bytes) with realloc.
+ *
+ * RETURNS:
+ *   length of the key
+ *   0 on memory failure
+ */
+size_t sort_key_encode_row(const Row *row, const SortColumn *cols, int num_cols,
+                           unsigned char **buf, size_t *cap);
 
 /* Sorts rows by a specified column index.
  * Returns a NEW Vec* containing sorted Row* pointers.
+ * The sort is stable and keeps no global state, so it may run on
+ * several threads at once.
  * 
  * PARAMETERS:
  *   rows - Vec* of Row*
@@ -24,4 +91,69 @@
  */
 Vec *sort_by_column(Vec *rows, int col_index, int ascending);
 
+/* Sorts rows like sort_by_column, with up to num_threads threads.
+ * Partitions are sorted on separate threads and merged in parallel;
+ * the order is the same as with one thread.
+ *
+ * RETURNS:
+ *   Vec*  - newly allocated sorted vector
+ *   NULL  - on invalid arguments or memory failure
+ */
+Vec *sort_by_column_parallel(Vec *rows, int col_index, int ascending, int num_threads);
+
+/* Sorts an array of rows by a column in place, with up to num_threads
+ * threads. Same order as sort_by_column; rows missing the column sort first
+ * wherever they are.
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid arguments or memory failure
+ */
+int sort_rows(Row **rows, size_t len, int col_index, int ascending, int num_threads);
+
+/* Sorts rows by several columns, each in its own direction: by the first
+ * column, rows equal there by the second, and so on. Same rules as
+ * sort_by_column_parallel (the first row must have every column); each
+ * row's cells are encoded into one key, so rows compare with one memcmp.
+ *
+ * RETURNS:
+ *   Vec*  - newly allocated sorted vector
+ *   NULL  - on invalid arguments or memory failure
+ */
+Vec *sort_by_columns(Vec *rows, const SortColumn *cols, int num_cols, int num_threads);
+
+/* Sorts an array of rows by several columns in place, like sort_rows.
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid arguments or memory failure
+ */
+int sort_rows_by_columns(Row **rows, size_t len, const SortColumn *cols, int num_cols, int num_threads);
+
+/* Sorts the data rows of a table by a column, in place (header stays first).
+ * Uses the same ordering as sort_by_column.
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid arguments or memory failure
+ */
+int sort_table_by_column(Table *table, int col_index, int ascending);
+
+/* Sorts a table like sort_table_by_column, with up to num_threads threads.
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid arguments or memory failure
+ */
+int sort_table_by_column_parallel(Table *table, int col_index, int ascending, int num_threads);
+
+/* Sorts the data rows of a table by several columns (see sort_by_columns),
+ * in place, with up to num_threads threads.
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid arguments or memory failure
+ */
+int sort_table_by_columns(Table *table, const SortColumn *cols, int num_cols, int num_threads);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+* Header file for table.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "row.h"
+
+// Offset of a cell that is missing from its record (short rows)
+#define TABLE_NULL_CELL SIZE_MAX
+
+// Type of a column's data cells (the header is not counted)
+typedef enum ColumnType {
+    COLUMN_STRING = 0,  // text only
+    COLUMN_INT64,  // every cell is an optionally signed integer that fits int64_t
+    COLUMN_DOUBLE  // every cell is a complete strtod() number
+} ColumnType;
+
+// Cells of one column: record i's cell is the NUL-terminated string at
+// data + offsets[i] (or missing if offsets[i] is TABLE_NULL_CELL)
+// Numeric columns also keep each record's parsed value (0 for the header
+// and missing cells) in ints or reals, next to the text
+typedef struct TableColumn {
+    char *data;  // cells back to back
+    size_t len;  // bytes used in data
+    size_t cap;  // bytes allocated for data
+    size_t *offsets;  // start of each record's cell in data
+    ColumnType type;  // inferred by table_infer_types (COLUMN_STRING before)
+    int64_t *ints;  // values of a COLUMN_INT64 column
+    double *reals;  // values of a COLUMN_DOUBLE column
+} TableColumn;
+
+// Column-oriented table; record 0 is the header
+// Operators narrow, reorder or project the visible rows/columns in place
+typedef struct Table Table;
+
+// Create an empty table with num_cols columns (0 for empty input)
+// - returns NULL if failed
+Table *table_new(int num_cols);
+
+// Create a table over columns that already hold num_records records each
+// - the column buffers are borrowed: not copied, not freed, and must outlive
+//   the table (records cannot be appended)
+// - returns NULL if failed
+Table *table_new_borrowed(const TableColumn *columns, int num_cols, size_t num_records);
+
+// Append a record from a tokenized line (same layout as row_new_view)
+// - cells past num_cols are dropped, missing cells are recorded as missing
+// - only valid before the visible rows are changed
+// - returns 0 on success, -1 if failed
+int table_append_row(Table *table, const char *line, const uint32_t *offsets, int num_cells);
+
+// Infer each column's type from a sample of data records, then parse the
+// numeric columns into native arrays (a column that fails later is demoted)
+// - call once all records are appended
+// - returns 0 on success, -1 if failed (columns stay COLUMN_STRING)
+int table_infer_types(Table *table);
+
+// Get number of visible rows (header included)
+size_t table_num_rows(const Table *table);
+
+// Get number of visible columns
+int table_num_cols(const Table *table);
+
+// Get the record ids of the visible rows, in output order
+// - may be reordered or compacted in place (see table_set_num_rows)
+// - returns NULL if table is NULL
+size_t *table_rows(const Table *table);
+
+// Shrink the visible rows to the first count entries of table_rows
+// - returns 0 on success, -1 if count is larger than the current number
+int table_set_num_rows(Table *table, size_t count);
+
+// Get visible column col
+// - returns NULL if invalid index
+const TableColumn *table_column(const Table *table, int col);
+
+// Keep only the given columns (indices into the visible columns, in order)
+// - returns 0 on success, -1 if failed
+int table_project(Table *table, const int *indices, int count);
+
+// Get the cell of a column for a record id
+// - returns NULL if the cell is missing
+static inline const char *table_column_cell(const TableColumn *column, size_t record) {
+    size_t offset = column->offsets[record];
+    return offset == TABLE_NULL_CELL ? NULL : column->data + offset;
+}
+
+// Get cell at visible row and column
+// - returns NULL if invalid index or missing cell
+const char *table_get_cell(const Table *table, size_t row, int col);
+
+// Copy visible row into a new Row (e.g. the header, for name lookups)
+// - returns NULL if failed
+Row *table_get_row(const Table *table, size_t row);
+
+// Free table and all its columns (except borrowed buffers)
+void table_free(Table *table);
+
+#endif
@@ -0,0 +1,32 @@
+/*
+* Header file for uring.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef URING_H
+#define URING_H
+
+#include <stdio.h>
+
+// Reads kept in flight
+#define URING_QUEUE_DEPTH 8
+
+// Bytes per read
+#define URING_BLOCK_SIZE (1u << 20)
+
+// Check whether the kernel lets this process use io_uring
+// - returns 1 if it does, 0 otherwise
+int uring_supported(void);
+
+// Open a stream over a regular file that keeps URING_QUEUE_DEPTH reads of
+// URING_BLOCK_SIZE bytes in flight through io_uring
+// - read errors set the stream's error indicator (ferror)
+// - fclose() waits for the reads in flight and closes the file
+// - returns NULL if io_uring is unavailable or the file is not a readable
+//   regular file
+FILE *uring_open(const char *path);
+
+#endif
@@ -10,8 +10,42 @@
 
 #include "vec.h"
 #include "row.h"
+#include "table.h"
 
 
+// Condition parsed and bound to a header's column
+typedef struct WhereCond WhereCond;
+
+WhereCond *where_compile(const Row *header, const char *condition);
+int where_match(const WhereCond *cond, const Row *row);
+
+// Check one cell value of the condition's column (NULL for a missing cell)
+// - returns 1 if it satisfies cond, 0 otherwise
+int where_match_cell(const WhereCond *cond, const char *cell);
+void where_free(WhereCond *cond);
+
+// Get the column a condition tests
+// - returns the column index, -1 if cond is NULL
+int where_column(const WhereCond *cond);
+
+// Check whether a condition is an equality test (column==value)
+// - returns 1 and fills col_index/value (owned by cond) if it is, 0 otherwise
+int where_equality(const WhereCond *cond, int *col_index, const char **value);
+
+// Check whether a condition is an ordering test (column<value, <=, >, >=)
+// - returns 1 and fills col_index if it is, 0 otherwise
+int where_ordering(const WhereCond *cond, int *col_index);
+
+// Check whether a block whose target-column cells span [min_value, max_value]
+// (min > max if none are present), plus missing/empty cells if has_empty,
+// can hold a row matching cond (see zonemap.h)
+// - returns 0 if an ordering condition rules the block out, 1 otherwise
+int where_may_match_range(const WhereCond *cond, double min_value, double max_value, int has_empty);
+
 Vec *where_filter(const Vec *rows, const char *condition);
 
+// Filter a table in place (header kept), scanning only the target column
+// - returns 0 on success, -1 if failed
+int where_filter_table(Table *table, const char *condition);
+
 #endif
@@ -0,0 +1,42 @@
+/*
+* Header file for writer.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stddef.h>
+
+// Buffered output to a file descriptor (bypasses stdio)
+typedef struct Writer Writer;
+
+// Create a writer on an open file descriptor (not closed by the writer)
+// - buffer_size 0 uses the default (1 MiB)
+// - returns NULL if failed
+Writer *writer_open_fd(int fd, size_t buffer_size);
+
+// Create a writer on a new or truncated file
+// - returns NULL if the file cannot be opened or allocation failed
+Writer *writer_open_path(const char *path);
+
+// Append len bytes to the output
+// - returns 0 on success, -1 on write error
+int writer_write(Writer *writer, const char *data, size_t len);
+
+// Write all buffered bytes to the file descriptor
+// - returns 0 on success, -1 on write error
+int writer_flush(Writer *writer);
+
+// Check whether any write has failed
+// - returns 1 after a failed write, 0 otherwise
+int writer_failed(const Writer *writer);
+
+// Flush, close the file if the writer opened it, and free the writer
+// - returns 0 on success, -1 if any write (or close) failed
+int writer_close(Writer *writer);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+* Header file for zonemap.c
+*
+* AUTHOR: Billy
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#ifndef ZONEMAP_H
+#define ZONEMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cache.h"
+#include "csv.h"
+
+// Suffix of a zone map file: "<source>.<column>.zmap"
+#define ZONEMAP_SUFFIX ".zmap"
+
+// Records summarized per block
+#define ZONEMAP_BLOCK_ROWS 4096
+
+// Summary of one block of consecutive records
+typedef struct ZoneBlock {
+    uint64_t start;  // byte offset of the block's first record
+    uint64_t end;  // byte offset just past its last record
+    uint64_t num_rows;  // records in the block
+    uint64_t num_empty;  // missing or empty cells in the column
+    double min_value;  // smallest atof() of the present cells (+inf if none)
+    double max_value;  // largest atof() of the present cells (-inf if none)
+} ZoneBlock;
+
+// Mapped zone map of one column of a source file
+typedef struct ZoneMap ZoneMap;
+
+// Build the zone map of column from the rest of a mapped reader (header
+// already read) and write it next to source_path
+// - key is the source's identity taken before it was read (see cache_key)
+// - returns 0 on success, -1 if failed or the source changed meanwhile
+int zonemap_build(CsvReader *reader, int column, const char *source_path, const CacheKey *key);
+
+// Map the zone map of column if it was built for key
+// - returns NULL if the zone map is missing, stale or corrupt
+ZoneMap *zonemap_open(const char *source_path, int column, const CacheKey *key);
+
+// Get the number of blocks (in file order)
+size_t zonemap_num_blocks(const ZoneMap *zonemap);
+
+// Get block i
+// - returns NULL if out of bounds
+const ZoneBlock *zonemap_block(const ZoneMap *zonemap, size_t i);
+
+// Unmap the zone map
+void zonemap_close(ZoneMap *zonemap);
+
+#endif
@@ -0,0 +1,393 @@
+/*
+ * Provides an on-disk cache of parsed tables (--cache).
+ * After a source file is parsed once, its columns (cell bytes, offsets,
+ * inferred types and numeric arrays) are written to "<source>.cache" in
+ * the same layout the Table uses in memory. Later runs map the image and
+ * point a Table straight at its sections, so nothing is parsed or copied.
+ * The image records the source's inode, size and modification time and
+ * is ignored as soon as any of them changes. Images are native-endian and
+ * only meant to be read back on the machine that wrote them.
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "../include/cache.h"
+#include "../include/writer.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC "CSVLCACH"
+#define CACHE_VERSION 1
+#define CACHE_BYTE_ORDER 0x01020304u
+
+// Sections start on this boundary so the arrays can be used in place
+#define CACHE_ALIGN 8
+
+// File header
+typedef struct CacheHeader {
+    char magic[8];  // CACHE_MAGIC
+    uint32_t version;  // CACHE_VERSION
+    uint32_t byte_order;  // CACHE_BYTE_ORDER as stored by the writer
+    uint32_t word_size;  // sizeof(size_t) of the writer
+    uint32_t num_cols;  // number of columns
+    uint64_t num_records;  // records per column (header included)
+    CacheKey key;  // identity of the source file
+} CacheHeader;
+
+// Column descriptor, one per column after the header
+typedef struct CacheColumn {
+    uint32_t type;  // ColumnType
+    uint32_t reserved;  // 0
+    uint64_t data_pos;  // file offset of the cell bytes
+    uint64_t data_len;  // number of cell bytes
+    uint64_t offsets_pos;  // file offset of num_records size_t offsets
+    uint64_t values_pos;  // file offset of num_records values (0 for text)
+} CacheColumn;
+
+struct CacheImage {
+    void *data;  // mapped image
+    size_t size;  // size of the mapping
+    TableColumn *columns;  // columns pointing into the mapping
+    int num_cols;  // number of columns
+    size_t num_records;  // records per column
+};
+
+/*
+ * Internal helper: builds "<source_path><suffix>".
+ *
+ * RETURN: newly allocated path, NULL on allocation failure
+ */
+static char *make_path(const char *source_path, const char *suffix) {
+    size_t len = strlen(source_path);
+    size_t suffix_len = strlen(suffix);
+
+    char *path = malloc(len + suffix_len + 1);
+    if (path == NULL) return NULL;
+
+    memcpy(path, source_path, len);
+    memcpy(path + len, suffix, suffix_len + 1);
+    return path;
+}
+
+/*
+ * Internal helper: rounds a file position up to CACHE_ALIGN.
+ */
+static uint64_t align_pos(uint64_t pos) {
+    return (pos + CACHE_ALIGN - 1) & ~(uint64_t)(CACHE_ALIGN - 1);
+}
+
+/*
+ * Internal helper: checks that an aligned section lies inside the image.
+ */
+static int valid_section(uint64_t pos, uint64_t len, size_t size) {
+    return pos % CACHE_ALIGN == 0 && pos <= size && len <= size - pos;
+}
+
+/*
+ * Internal helper: compares two source identities.
+ */
+static int same_key(const CacheKey *a, const CacheKey *b) {
+    return a->inode == b->inode && a->size == b->size &&
+           a->mtime_sec == b->mtime_sec && a->mtime_nsec == b->mtime_nsec;
+}
+
+/*
+ * Reads the identity of a source file.
+ *
+ * parameters:
+ * - source_path: path of the CSV file
+ * - key: filled with the file's inode, size and modification time
+ *
+ * RETURN: 0 on success, -1 on bad input or if the path is not a regular file
+ */
+int cache_key(const char *source_path, CacheKey *key) {
+    if (source_path == NULL || key == NULL) return -1;
+
+    struct stat st;
+    if (stat(source_path, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+
+    key->inode = (uint64_t)st.st_ino;
+    key->size = (uint64_t)st.st_size;
+    key->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    key->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    return 0;
+}
+
+/*
+ * Internal helper: checks one column descriptor against the image and
+ * points a TableColumn at its sections. Every offset is checked, so a
+ * damaged image is rejected instead of read out of bounds.
+ *
+ * RETURN: 0 on success, -1 if the descriptor or its sections are invalid
+ */
+static int load_column(const CacheImage *image, const CacheColumn *desc, TableColumn *column) {
+    char *base = image->data;
+    uint64_t array_len = (uint64_t)image->num_records * sizeof(size_t);
+
+    if (desc->type != COLUMN_STRING && desc->type != COLUMN_INT64 && desc->type != COLUMN_DOUBLE) return -1;
+    if (!valid_section(desc->data_pos, desc->data_len, image->size)) return -1;
+    if (!valid_section(desc->offsets_pos, array_len, image->size)) return -1;
+    if (desc->type != COLUMN_STRING && !valid_section(desc->values_pos, array_len, image->size)) return -1;
+
+    // every cell must end inside the data section
+    char *data = base + desc->data_pos;
+    if (desc->data_len > 0 && data[desc->data_len - 1] != '\0') return -1;
+
+    size_t *offsets = (size_t *)(void *)(base + desc->offsets_pos);
+    for (size_t r = 0; r < image->num_records; r++) {
+        if (offsets[r] != TABLE_NULL_CELL && offsets[r] >= desc->data_len) return -1;
+    }
+
+    memset(column, 0, sizeof(TableColumn));
+    column->data = data;
+    column->len = (size_t)desc->data_len;
+    column->cap = (size_t)desc->data_len;
+    column->offsets = offsets;
+    column->type = (ColumnType)desc->type;
+    if (column->type == COLUMN_INT64) column->ints = (int64_t *)(void *)(base + desc->values_pos);
+    if (column->type == COLUMN_DOUBLE) column->reals = (double *)(void *)(base + desc->values_pos);
+    return 0;
+}
+
+/*
+ * Maps the cache image of a source file and checks that it belongs to the
+ * given identity and is intact.
+ *
+ * parameters:
+ * - source_path: path of the CSV file (the image is source_path + CACHE_SUFFIX)
+ * - key: current identity of the source (from cache_key)
+ *
+ * RETURN: pointer to new CacheImage on success, NULL if the image is
+ *         missing, stale, corrupt or written by a different machine type
+ */
+CacheImage *cache_open(const char *source_path, const CacheKey *key) {
+    if (source_path == NULL || key == NULL) return NULL;
+
+    char *path = make_path(source_path, CACHE_SUFFIX);
+    if (path == NULL) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(CacheHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (data == MAP_FAILED) return NULL;
+
+    CacheImage *image = calloc(1, sizeof(CacheImage));
+    if (image == NULL) {
+        munmap(data, (size_t)st.st_size);
+        return NULL;
+    }
+    image->data = data;
+    image->size = (size_t)st.st_size;
+
+    const CacheHeader *header = data;
+    size_t max_cols = (image->size - sizeof(CacheHeader)) / sizeof(CacheColumn);
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != CACHE_VERSION || header->byte_order != CACHE_BYTE_ORDER ||
+        header->word_size != sizeof(size_t) || !same_key(&header->key, key) ||
+        header->num_cols > max_cols || header->num_cols > INT_MAX ||
+        header->num_records > image->size / sizeof(size_t)) {
+        cache_close(image);
+        return NULL;
+    }
+    image->num_cols = (int)header->num_cols;
+    image->num_records = (size_t)header->num_records;
+
+    if (image->num_cols > 0) {
+        image->columns = malloc((size_t)image->num_cols * sizeof(TableColumn));
+        if (image->columns == NULL) {
+            cache_close(image);
+            return NULL;
+        }
+    }
+
+    const CacheColumn *descs = (const CacheColumn *)(header + 1);
+    for (int c = 0; c < image->num_cols; c++) {
+        if (load_column(image, &descs[c], &image->columns[c]) != 0) {
+            cache_close(image);
+            return NULL;
+        }
+    }
+    return image;
+}
+
+/*
+ * Creates a table whose columns point into the image.
+ *
+ * parameters:
+ * - image: image from cache_open
+ *
+ * RETURN: pointer to new Table on success (free with table_free before
+ *         cache_close), NULL on bad input or allocation failure
+ */
+Table *cache_table(const CacheImage *image) {
+    if (image == NULL) return NULL;
+    return table_new_borrowed(image->columns, image->num_cols, image->num_records);
+}
+
+/*
+ * Unmaps an image.
+ *
+ * parameters:
+ * - image: image to close (safe to pass NULL)
+ */
+void cache_close(CacheImage *image) {
+    if (image == NULL) return;
+
+    munmap(image->data, image->size);
+    free(image->columns);
+    free(image);
+}
+
+/*
+ * Moves a sidecar file written under a temporary name into place, but only
+ * if its source still has the identity it was read with; otherwise the
+ * temporary file is removed.
+ *
+ * parameters:
+ * - tmp_path: completely written temporary file
+ * - path: final path of the sidecar
+ * - source_path: path of the CSV file the sidecar describes
+ * - key: identity of the source taken before it was read
+ *
+ * RETURN: 0 on success, -1 if the source changed or the rename failed
+ */
+int cache_commit(const char *tmp_path, const char *path, const char *source_path, const CacheKey *key) {
+    if (tmp_path == NULL) return -1;
+
+    CacheKey now;
+    int result = -1;
+    if (path != NULL && source_path != NULL && key != NULL &&
+        cache_key(source_path, &now) == 0 && same_key(&now, key) && rename(tmp_path, path) == 0) {
+        result = 0;
+    }
+    if (result != 0) unlink(tmp_path);
+    return result;
+}
+
+/*
+ * Internal helper: writes zero bytes up to the next aligned position.
+ *
+ * RETURN: new position
+ */
+static uint64_t write_padding(Writer *out, uint64_t pos) {
+    static const char zeros[CACHE_ALIGN] = { 0 };
+    uint64_t aligned = align_pos(pos);
+    writer_write(out, zeros, (size_t)(aligned - pos));
+    return aligned;
+}
+
+/*
+ * Writes the image of a freshly loaded table next to its source file.
+ * The image is written to a temporary file and renamed into place only if
+ * the source still has the identity the table was loaded from.
+ *
+ * parameters:
+ * - source_path: path of the CSV file the table was loaded from
+ * - key: identity of the source taken before it was parsed
+ * - table: table as returned by csv_read_table (no operator applied)
+ *
+ * RETURN: 0 on success, -1 on bad input, write failure, or if the source
+ *         changed while it was being parsed
+ */
+int cache_save(const char *source_path, const CacheKey *key, const Table *table) {
+    if (source_path == NULL || key == NULL || table == NULL) return -1;
+
+    // the image holds every record and column in load order
+    size_t num_records = table_num_rows(table);
+    int num_cols = table_num_cols(table);
+    const size_t *rows = table_rows(table);
+    for (size_t r = 0; r < num_records; r++) {
+        if (rows[r] != r) return -1;
+    }
+
+    char *path = make_path(source_path, CACHE_SUFFIX);
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), "%s.%ld", CACHE_SUFFIX, (long)getpid());
+    char *tmp_path = make_path(source_path, suffix);
+    Writer *out = tmp_path != NULL ? writer_open_path(tmp_path) : NULL;
+    CacheColumn *descs = calloc(num_cols > 0 ? (size_t)num_cols : 1, sizeof(CacheColumn));
+    if (path == NULL || out == NULL || descs == NULL) {
+        if (out != NULL) {
+            writer_close(out);
+            unlink(tmp_path);
+        }
+        free(path);
+        free(tmp_path);
+        free(descs);
+        return -1;
+    }
+
+    // lay out every column's sections after the header and descriptors
+    uint64_t array_len = (uint64_t)num_records * sizeof(size_t);
+    uint64_t pos = sizeof(CacheHeader) + (uint64_t)num_cols * sizeof(CacheColumn);
+    for (int c = 0; c < num_cols; c++) {
+        const TableColumn *column = table_column(table, c);
+        descs[c].type = (uint32_t)column->type;
+        descs[c].data_pos = pos = align_pos(pos);
+        descs[c].data_len = column->len;
+        pos += column->len;
+        descs[c].offsets_pos = pos = align_pos(pos);
+        pos += array_len;
+        if (column->type != COLUMN_STRING) {
+            descs[c].values_pos = pos;
+            pos += array_len;
+        }
+    }
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    header.word_size = sizeof(size_t);
+    header.num_cols = (uint32_t)num_cols;
+    header.num_records = num_records;
+    header.key = *key;
+
+    writer_write(out, (const char *)&header, sizeof(header));
+    writer_write(out, (const char *)descs, (size_t)num_cols * sizeof(CacheColumn));
+    pos = sizeof(CacheHeader) + (uint64_t)num_cols * sizeof(CacheColumn);
+    for (int c = 0; c < num_cols; c++) {
+        const TableColumn *column = table_column(table, c);
+        pos = write_padding(out, pos);
+        writer_write(out, column->data, column->len);
+        pos = write_padding(out, pos + column->len);
+        writer_write(out, (const char *)column->offsets, (size_t)array_len);
+        pos += array_len;
+        if (column->type == COLUMN_INT64) writer_write(out, (const char *)column->ints, (size_t)array_len);
+        if (column->type == COLUMN_DOUBLE) writer_write(out, (const char *)column->reals, (size_t)array_len);
+        if (column->type != COLUMN_STRING) pos += array_len;
+    }
+    free(descs);
+
+    // a source rewritten during the parse must not be cached under the old key
+    int result = writer_close(out);
+    if (result == 0) {
+        result = cache_commit(tmp_path, path, source_path, key);
+    } else {
+        unlink(tmp_path);
+    }
+
+    free(path);
+    free(tmp_path);
+    return result;
+}
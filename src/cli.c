@@ -1,8 +1,20 @@
 /*
  * Parses command line arguments and stores them for the CSVlite tool.
  * Supports file/stdin input, column selection, filtering, grouping, and sorting.
- * --order-by accepts "col", "col:asc", "col:desc", or numeric indices (e.g., 1:desc).
+ * --order-by accepts "col", "col:asc", "col:desc", or numeric indices (e.g., 1:desc),
+ * several separated by commas (e.g., dept:asc,salary:desc,name).
  * --group-by accepts column names or numeric indices. "-" enables stdin.
+ * --threads takes a positive thread count for loading --file input and sorting.
+ * --stats prints allocator statistics to stderr after the query.
+ * --output writes the result to a file instead of stdout.
+ * --columnar runs GROUP BY/ORDER BY queries on the column-oriented engine.
+ * --cache reuses a parsed image of a --file input kept next to it.
+ * --build-index writes a hash index of one column for equality WHERE lookups.
+ * --build-zonemap writes per-block value ranges of one column for range WHERE filters.
+ * --io-uring reads a --file input through io_uring instead of mapping it.
+ * --limit/--offset write at most n data rows after skipping the first m.
+ * --memory-limit takes a byte count (K, M or G suffix) that an ORDER BY
+ * without GROUP BY keeps its rows within, spilling sorted runs to disk.
  *
  * AUTHOR: Nikhil Ranjith
  * DATE: November 30, 2025
@@ -10,6 +22,7 @@
  */
 
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "../include/cli.h"
@@ -21,6 +34,17 @@ int g_help_flag = 0;
 int g_use_stdin = 0;
 char* g_group_by_col = NULL;
 char* g_order_by_col = NULL;
+int g_threads = 1;
+int g_stats = 0;
+char* g_output_path = NULL;
+int g_columnar = 0;
+int g_cache = 0;
+char* g_build_index_col = NULL;
+char* g_build_zonemap_col = NULL;
+int g_io_uring = 0;
+long g_limit = -1;
+long g_offset = 0;
+size_t g_memory_limit = 0;
 
 /*
  * Resets all CLI option globals to their default unset state.
@@ -36,6 +60,17 @@ void cli_init(void) {
     g_use_stdin = 0;
     g_group_by_col = NULL;
     g_order_by_col = NULL;
+    g_threads = 1;
+    g_stats = 0;
+    g_output_path = NULL;
+    g_columnar = 0;
+    g_cache = 0;
+    g_build_index_col = NULL;
+    g_build_zonemap_col = NULL;
+    g_io_uring = 0;
+    g_limit = -1;
+    g_offset = 0;
+    g_memory_limit = 0;
 }
 
 /*
@@ -50,16 +85,36 @@ void cli_print_help(void) {
     printf("Usage: csvlite [--file <file> | -] [options]\n");
     printf("\n");
     printf("Options:\n");
-    printf("  --file <file>     CSV file to process (or use - for stdin)\n");
+    printf("  --file <file>     CSV file to process, plain or gzip-compressed (or use - for stdin)\n");
     printf("  --select <cols>   Columns to select (e.g. name,age or 0,1)\n");
     printf("  --where <cond>    Filter condition (e.g. age>=18)\n");
     printf("  --group-by <col>  Column name or index to group by (e.g. department or 2)\n");
-    printf("  --order-by <col>  Column to order by; supports name or index, optional :asc/:desc (defaults asc)\n");
+    printf("  --order-by <cols> Columns to order by (e.g. dept,salary:desc); name or index, optional :asc/:desc (defaults asc)\n");
+    printf("  --limit <n>       Write at most n data rows (reading stops early without GROUP BY/ORDER BY)\n");
+    printf("  --offset <n>      Skip the first n data rows of the result\n");
+    printf("  --threads <n>     Threads used to load a --file input and to sort (defaults to 1)\n");
+    printf("  --memory-limit <size> Sort within size bytes (K/M/G suffix), spilling sorted runs to $TMPDIR\n");
+    printf("  --stats           Print memory allocator statistics to stderr\n");
+    printf("  --output <file>   Write the result to a file instead of stdout\n");
+    printf("  --columnar        Load GROUP BY/ORDER BY queries into column-oriented storage\n");
+    printf("  --cache           Reuse a parsed image of the --file input (<file>.cache)\n");
+    printf("  --build-index <col> Write a hash index of a column for --where 'col==value' lookups\n");
+    printf("  --build-zonemap <col> Write block min/max of a column so range --where filters skip blocks\n");
+    printf("  --io-uring        Read the --file input with several io_uring reads in flight (falls back to mmap)\n");
     printf("  --help            Show this help message\n");
     printf("\n");
     printf("Examples:\n");
     printf("  csvlite --file data.csv --select name,age\n");
     printf("  csvlite --file data.csv --where 'age>=18' --order-by age:desc\n");
+    printf("  csvlite --file data.csv --order-by department,salary:desc,name\n");
+    printf("  csvlite --file big.csv --threads 8 --order-by id\n");
+    printf("  csvlite --file big.csv --where 'status==failed' --limit 100\n");
+    printf("  csvlite --file huge.csv --order-by ts --memory-limit 512M\n");
+    printf("  csvlite --file events.csv.gz --where 'status==failed'\n");
+    printf("  csvlite --file data.csv --where 'age>=18' --output adults.csv\n");
+    printf("  csvlite --file nightly.csv --cache --order-by amount:desc\n");
+    printf("  csvlite --file big.csv --build-index id   # then --where 'id==12345' seeks\n");
+    printf("  csvlite --file big.csv --build-zonemap ts # then --where 'ts>=1700000000' skips blocks\n");
     printf("  csvlite - < data.csv              # Read from stdin\n");
     printf("  cat data.csv | csvlite -          # Pipe input\n");
     printf("\n");
@@ -123,6 +178,76 @@ int cli_parse_args(int argc, char* argv[]) {
                 return 0;
             }
         }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            char *end = NULL;
+            long n = (++i < argc) ? strtol(argv[i], &end, 10) : 0;
+            if (end == NULL || end == argv[i] || *end != '\0' || n < 1 || n > 1024) {
+                fprintf(stderr, "Error: --threads requires a thread count between 1 and 1024\n");
+                return 0;
+            }
+            g_threads = (int)n;
+        }
+        else if (strcmp(argv[i], "--limit") == 0 || strcmp(argv[i], "--offset") == 0) {
+            const char *flag = argv[i];
+            char *end = NULL;
+            long n = (++i < argc) ? strtol(argv[i], &end, 10) : -1;
+            if (end == NULL || end == argv[i] || *end != '\0' || n < 0) {
+                fprintf(stderr, "Error: %s requires a non-negative row count\n", flag);
+                return 0;
+            }
+            if (strcmp(flag, "--limit") == 0) g_limit = n;
+            else g_offset = n;
+        }
+        else if (strcmp(argv[i], "--memory-limit") == 0) {
+            char *end = NULL;
+            unsigned long long n = (++i < argc && argv[i][0] != '-') ? strtoull(argv[i], &end, 10) : 0;
+            int shift = 0;
+            if (end != NULL && (*end == 'K' || *end == 'k')) shift = 10;
+            else if (end != NULL && (*end == 'M' || *end == 'm')) shift = 20;
+            else if (end != NULL && (*end == 'G' || *end == 'g')) shift = 30;
+            if (shift != 0) end++;
+            if (end == NULL || end == argv[i] || *end != '\0' || n == 0 || n > (SIZE_MAX >> shift)) {
+                fprintf(stderr, "Error: --memory-limit requires a size in bytes (e.g. 512M)\n");
+                return 0;
+            }
+            g_memory_limit = (size_t)n << shift;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            g_stats = 1;
+        }
+        else if (strcmp(argv[i], "--columnar") == 0) {
+            g_columnar = 1;
+        }
+        else if (strcmp(argv[i], "--cache") == 0) {
+            g_cache = 1;
+        }
+        else if (strcmp(argv[i], "--io-uring") == 0) {
+            g_io_uring = 1;
+        }
+        else if (strcmp(argv[i], "--build-index") == 0) {
+            if (++i < argc) {
+                g_build_index_col = argv[i];
+            } else {
+                fprintf(stderr, "Error: --build-index requires a column\n");
+                return 0;
+            }
+        }
+        else if (strcmp(argv[i], "--build-zonemap") == 0) {
+            if (++i < argc) {
+                g_build_zonemap_col = argv[i];
+            } else {
+                fprintf(stderr, "Error: --build-zonemap requires a column\n");
+                return 0;
+            }
+        }
+        else if (strcmp(argv[i], "--output") == 0) {
+            if (++i < argc) {
+                g_output_path = argv[i];
+            } else {
+                fprintf(stderr, "Error: --output requires a file path\n");
+                return 0;
+            }
+        }
         else if (strcmp(argv[i], "-") == 0) {
             g_use_stdin = 1;
         }
@@ -131,6 +256,15 @@ int cli_parse_args(int argc, char* argv[]) {
             return 0;
         }
     }
+
+    // Building a sidecar runs no query, so query options would be silently dropped
+    if ((g_build_index_col != NULL || g_build_zonemap_col != NULL) &&
+        (g_select_cols != NULL || g_where_cond != NULL || g_group_by_col != NULL ||
+         g_order_by_col != NULL || g_limit >= 0 || g_offset > 0 || g_output_path != NULL ||
+         g_memory_limit > 0 || g_columnar)) {
+        fprintf(stderr, "Error: --build-index and --build-zonemap cannot be combined with query options\n");
+        return 0;
+    }
     return 1;
 }
 
@@ -146,4 +280,15 @@ void cli_cleanup(void) {
     g_where_cond = NULL;
     g_group_by_col = NULL;
     g_order_by_col = NULL;
+    g_threads = 1;
+    g_stats = 0;
+    g_output_path = NULL;
+    g_columnar = 0;
+    g_cache = 0;
+    g_build_index_col = NULL;
+    g_build_zonemap_col = NULL;
+    g_io_uring = 0;
+    g_limit = -1;
+    g_offset = 0;
+    g_memory_limit = 0;
 }
@@ -2,11 +2,31 @@
  * Provides utilities for reading CSV input and writing CSV output.
  * Reads CSV data into vectors of rows, writes CSV data to stdout or files,
  * and validates column selections used by CLI options.
- * Parsing behavior:
- *   Strips trailing newline
- *   Trims whitespace around tokens
+ * Parsing behavior (RFC 4180):
+ *   Finds record ends and commas 64 bytes at a time with the scan module,
+ *   ignoring commas and newlines inside double-quoted fields
+ *   A quote opens a quoted field only as the first non-blank byte of the
+ *   field; a quote inside an unquoted field (12" ruler) is kept as it is
+ *   Strips trailing newline (and a CR before it)
+ *   Trims whitespace around tokens, then removes the quotes of a quoted
+ *   field and turns each escaped "" into "
  *   Counts commas to size the row and fills missing trailing cells with ""
  *   Returns NULL on allocation or parsing failure
+ * Files given with --file can also be memory-mapped, in which case rows are
+ * views whose cells point into the mapping instead of separate strings.
+ * Cells are NUL-terminated in place, so every page a parse touches becomes
+ * a private copy of the file page: loading a whole table costs about one
+ * file size of anonymous memory, though no per-line or per-cell copies.
+ * A pull-based reader (csv_reader_open/next/close) returns one row at a
+ * time so queries that need no full table can run in constant memory.
+ * Large mapped files can be parsed by several threads, each taking a byte
+ * range that starts on a record boundary (csv_read_mapped_parallel).
+ * A reader can be limited to the columns a query uses (projection pushdown):
+ * the other fields are still found by the comma scan, but are neither
+ * trimmed, unquoted nor copied, and a record is not split past the last
+ * column used. It can also be given a WHERE condition (predicate pushdown):
+ * the target field of each record is located from the comma offsets and
+ * checked first, and records that fail are skipped without being tokenized.
  * This module works closely with row.c and vec.c to represent
  * CSV rows and collections of rows in memory.
  *
@@ -15,10 +35,67 @@
  * VERSION: v2.0.0
  */
 
+#define _DEFAULT_SOURCE
+
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../include/csv.h"
+#include "../include/scan.h"
+#include "../include/arena.h"
+#include "../include/writer.h"
+#include "../include/table.h"
+#include "../include/where.h"
+
+// Private mapping of an input file plus the copy of its unterminated last line
+struct CsvMap {
+    char *data;  // mapped file bytes (NULL for an empty file)
+    size_t size;  // number of mapped bytes
+    char *tail;  // NUL-terminated copy of a last line without '\n'
+};
+
+// Mapped bytes a streaming reader consumes between two page releases
+#define READER_RELEASE_BYTES (64u << 20)
+
+// Bytes requested from a stream source per read
+#define READER_BLOCK_SIZE (1u << 20)
+
+// Smallest byte range worth handing to a parse thread
+#define PARALLEL_MIN_CHUNK (256u << 10)
+
+// Pull-based row reader over a FILE* or a mapped file
+struct CsvReader {
+    FILE *input;  // stream source (NULL for mapped sources)
+    CsvMap *map;  // mapped source (NULL for stream sources)
+    char *pos;  // next unread byte of the mapping
+    char *end;  // one past the last mapped byte to read
+    char *released;  // first mapped byte not yet handed back to the kernel
+    size_t page_size;  // granularity of page releases
+    int failed;  // 1 if the last NULL returned was an error
+    char *buf;  // block buffer of a stream source
+    size_t buf_cap;  // allocated size of buf
+    size_t buf_start;  // first unconsumed byte in buf
+    size_t buf_end;  // one past the last valid byte in buf
+    int eof;  // 1 once the stream source is exhausted
+    size_t *commas;  // offsets of the commas in the current record
+    size_t num_commas;  // number of valid entries in commas
+    size_t commas_cap;  // allocated entries in commas
+    uint32_t *cells;  // start offset of each cell of the current record
+    size_t cells_cap;  // allocated entries in cells
+    QuoteState quote_state;  // quote state at the end of the scanned part of the record
+    int quoted;  // 1 if the current record contains a quote character
+    size_t record_offset;  // byte offset of the last record (SIZE_MAX if unknown)
+    unsigned char *keep;  // keep[i] != 0 if column i is parsed (NULL parses all)
+    int keep_cols;  // columns up to the last kept one (records are cut there)
+    const WhereCond *filter;  // condition records must pass (NULL keeps all)
+    char *field;  // copy of the filtered field of the current record
+    size_t field_cap;  // allocated size of field
+};
 
 /* Helper: trim leading/trailing spaces/tabs in place.
  * Parameters: s (string to trim)
@@ -40,6 +117,707 @@ static void trim_inplace(char *s) {
     }
 }
 
+/* Helper: trim leading/trailing spaces/tabs of a token without moving bytes.
+ * Parameters: s (token bytes, s[*len] must be writable)
+ *             len (in: token length, out: trimmed length)
+ * Returns: pointer to the first non-blank character
+ * Side effects: writes a '\0' after the last non-blank character.
+ */
+static char *trim_span(char *s, size_t *len) {
+    size_t n = *len;
+    while (n > 0 && (*s == ' ' || *s == '\t')) {
+        s++;
+        n--;
+    }
+    while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\t')) n--;
+    s[n] = '\0';
+    *len = n;
+    return s;
+}
+
+/* Helper: removes the enclosing quotes of a quoted field in place and turns
+ * each escaped "" into a single ".
+ * Parameters: s (trimmed field starting with '"')
+ *             len (field length)
+ * Returns: void
+ * Side effects: rewrites the field; bytes after the closing quote (not valid
+ * RFC 4180) are kept as they are.
+ */
+static void unquote_field(char *s, size_t len) {
+    char *out = s;
+    size_t i = 1; // skip opening quote
+
+    while (i < len) {
+        if (s[i] == '"') {
+            if (i + 1 < len && s[i + 1] == '"') { // escaped quote
+                *out++ = '"';
+                i += 2;
+                continue;
+            }
+            i++; // closing quote
+            break;
+        }
+        *out++ = s[i++];
+    }
+    while (i < len) *out++ = s[i++];
+    *out = '\0';
+}
+
+/* Helper: length of a record without the CR of a CRLF line ending.
+ * Parameters: line (record bytes)
+ *             len (record length, newline excluded)
+ * Returns: len, minus one if the record ends with '\r'
+ */
+static size_t strip_cr(const char *line, size_t len) {
+    return (len > 0 && line[len - 1] == '\r') ? len - 1 : len;
+}
+
+/* Helper: free every row in a Vec and the Vec itself.
+ * Parameters: rows (Vec of Row pointers, may be NULL)
+ * Returns: void
+ */
+static void free_rows(Vec *rows) {
+    if (!rows) return;
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(rows);
+}
+
+/* Helper: splits one record into cells, in place, using the offsets of its
+ * field-separating commas found by scan_record().
+ * Parameters: reader (holds the record's comma offsets and quote flag;
+ *                     receives the cell offsets in reader->cells)
+ *             line (record bytes, line[len] must be writable)
+ *             len (number of bytes in the record, newline excluded)
+ * Returns: number of cells on success
+ *          -1 on allocation failure or a record longer than ROW_MAX_BYTES
+ * Side effects: overwrites separators in line with '\0' and unquotes
+ * quoted fields in place.
+ * Behavior: one cell per field (empty fields stay empty), each token
+ * trimmed and unquoted. With a projection, columns that are not kept become
+ * empty cells at their separator and fields past the last kept column are
+ * not split at all.
+ */
+static int tokenize_fields(CsvReader *reader, char *line, size_t len) {
+    if (len >= ROW_MAX_BYTES) return -1;
+
+    size_t num_commas = reader->num_commas;
+    int num_cols = (int)num_commas + 1;
+    if (reader->keep != NULL && num_cols > reader->keep_cols) num_cols = reader->keep_cols;
+
+    if ((size_t)num_cols > reader->cells_cap) {
+        uint32_t *grown = realloc(reader->cells, (size_t)num_cols * sizeof(uint32_t));
+        if (grown == NULL) return -1;
+        reader->cells = grown;
+        reader->cells_cap = (size_t)num_cols;
+    }
+
+    size_t start = 0;
+    for (int col = 0; col < num_cols; col++) {
+        size_t stop = ((size_t)col < num_commas) ? reader->commas[col] : len;
+        if (reader->keep != NULL && !reader->keep[col]) {
+            line[stop] = '\0';
+            reader->cells[col] = (uint32_t)stop;
+            start = stop + 1;
+            continue;
+        }
+        size_t tok_len = stop - start;
+
+        char *tok = trim_span(line + start, &tok_len);
+        if (reader->quoted && tok[0] == '"') unquote_field(tok, tok_len);
+
+        reader->cells[col] = (uint32_t)(tok - line);
+        start = stop + 1;
+    }
+
+    // line[len] holds the last cell's terminator
+    return num_cols;
+}
+
+/* Helper: moves the kept cells of a projected record to the front of the
+ * line, back to back, so a copied row holds only the bytes it uses.
+ * Parameters: reader (holds the projection and the cell offsets of the
+ *                     record, updated to the new layout)
+ *             line (tokenized record)
+ *             num_cols (number of cells from tokenize_fields)
+ * Returns: number of bytes to copy, every cell terminator included
+ * Side effects: rewrites line in place; cells that are not kept all point
+ * at the last terminator, so they stay empty.
+ */
+static size_t pack_cells(CsvReader *reader, char *line, int num_cols) {
+    size_t out = 0;
+    for (int col = 0; col < num_cols; col++) {
+        if (!reader->keep[col]) continue;
+
+        // a kept cell never starts before the cells packed ahead of it
+        size_t cell_len = strlen(line + reader->cells[col]);
+        memmove(line + out, line + reader->cells[col], cell_len + 1);
+        reader->cells[col] = (uint32_t)out;
+        out += cell_len + 1;
+    }
+
+    // a record too short to reach any kept column
+    if (out == 0) line[out++] = '\0';
+
+    for (int col = 0; col < num_cols; col++) {
+        if (!reader->keep[col]) reader->cells[col] = (uint32_t)(out - 1);
+    }
+    return out;
+}
+
+/* Helper: splits one record into a Row (see tokenize_fields).
+ * Parameters: reader (holds the record's comma offsets and quote flag)
+ *             line (record bytes, line[len] must be writable)
+ *             len (number of bytes in the record, newline excluded)
+ *             borrow (1 to build a view row pointing into line, 0 to copy
+ *                     the tokenized line (only its kept cells with a
+ *                     projection) into a single-allocation row)
+ * Returns: pointer to Row on success
+ *          NULL on allocation failure or a record longer than ROW_MAX_BYTES
+ */
+static Row *parse_fields(CsvReader *reader, char *line, size_t len, int borrow) {
+    int num_cols = tokenize_fields(reader, line, len);
+    if (num_cols < 0) return NULL;
+    if (borrow) return row_new_view(line, reader->cells, num_cols);
+
+    size_t size = reader->keep != NULL ? pack_cells(reader, line, num_cols) : len + 1;
+    return row_new_packed(line, size, reader->cells, num_cols);
+}
+
+/* Helper: appends the offsets of the set bits of a comma mask.
+ * Parameters: reader (reader collecting the current record's commas)
+ *             bits (comma mask of one block)
+ *             base (offset of the block from the record start)
+ * Returns: 0 on success, -1 on allocation failure
+ */
+static int push_commas(CsvReader *reader, uint64_t bits, size_t base) {
+    while (bits != 0) {
+        if (reader->num_commas == reader->commas_cap) {
+            size_t new_cap = reader->commas_cap ? reader->commas_cap * 2 : 64;
+            size_t *grown = realloc(reader->commas, new_cap * sizeof(size_t));
+            if (grown == NULL) return -1;
+            reader->commas = grown;
+            reader->commas_cap = new_cap;
+        }
+        reader->commas[reader->num_commas++] = base + (size_t)__builtin_ctzll(bits);
+        bits &= bits - 1; // clear lowest set bit
+    }
+    return 0;
+}
+
+/* Helper: finds the end of the record at line, one 64-byte block at a time,
+ * collecting the offsets of its commas on the way. Commas and newlines inside
+ * quoted fields are masked out with the in-quote mask, so a quoted field may
+ * contain both.
+ * Parameters: reader (collects comma offsets and quote state, reset by the
+ *                     caller per record)
+ *             line (record start)
+ *             avail (readable bytes from line)
+ *             scanned (in/out: bytes from line already scanned without
+ *                      finding a newline, always a whole number of blocks)
+ *             final (1 if no more bytes will follow avail)
+ *             out_len (set to the record length when a newline is found)
+ * Returns: 1 if the newline ending the record was found
+ *          0 if avail ran out first (all of avail is scanned when final)
+ *          -1 on allocation failure
+ */
+static int scan_record(CsvReader *reader, const char *line, size_t avail,
+                       size_t *scanned, int final, size_t *out_len) {
+    while (*scanned < avail) {
+        size_t off = *scanned;
+        size_t n = avail - off;
+        size_t before = reader->num_commas;
+
+        ScanMasks masks;
+        scan_partial(line + off, n, &masks);
+
+        // the quote state runs over every block, so a quote in a later
+        // block knows whether it starts a field
+        QuoteState quote_state = reader->quote_state;
+        if (masks.quote != 0 || quote_state.inside) reader->quoted = 1;
+        uint64_t quoted = scan_quote_mask(&masks, &quote_state);
+        masks.comma &= ~quoted;
+        masks.newline &= ~quoted;
+
+        if (masks.newline != 0) {
+            int nl = __builtin_ctzll(masks.newline);
+            uint64_t before_nl = (nl == 0) ? 0 : (~0ULL >> (SCAN_BLOCK_SIZE - nl));
+            if (push_commas(reader, masks.comma & before_nl, off) != 0) return -1;
+            *out_len = off + (size_t)nl;
+            return 1;
+        }
+
+        if (push_commas(reader, masks.comma, off) != 0) return -1;
+
+        if (n < SCAN_BLOCK_SIZE) {
+            // partial block: rescan it once more bytes arrive
+            if (!final) reader->num_commas = before;
+            else *scanned = avail;
+            return 0;
+        }
+        reader->quote_state = quote_state;
+        *scanned = off + SCAN_BLOCK_SIZE;
+    }
+    return 0;
+}
+
+/* Helper: clears the per-record scan state before scanning a new record.
+ * Parameters: reader (reader about to scan a record)
+ * Returns: void
+ */
+static void reset_record(CsvReader *reader) {
+    reader->num_commas = 0;
+    reader->quote_state = (QuoteState)QUOTE_STATE_INIT;
+    reader->quoted = 0;
+}
+
+/* Helper: refills a stream reader's block buffer.
+ * Moves the unconsumed carry-over to the front of the buffer, doubles the
+ * buffer when the carry-over alone fills it (a line longer than a block),
+ * then reads up to READER_BLOCK_SIZE more bytes.
+ * Parameters: reader (stream reader to refill)
+ * Returns: number of bytes added (0 at end of input)
+ *          -1 on allocation or read failure
+ * Side effects: invalidates pointers into the previous buffer contents.
+ */
+static long refill_stream(CsvReader *reader) {
+    size_t carry = reader->buf_end - reader->buf_start;
+    if (carry > 0 && reader->buf_start > 0) {
+        memmove(reader->buf, reader->buf + reader->buf_start, carry);
+    }
+    reader->buf_start = 0;
+    reader->buf_end = carry;
+
+    // keep one spare byte so the last line can always be NUL-terminated
+    if (reader->buf_cap - carry < READER_BLOCK_SIZE + 1) {
+        size_t new_cap = reader->buf_cap ? reader->buf_cap : READER_BLOCK_SIZE + 1;
+        while (new_cap - carry < READER_BLOCK_SIZE + 1) new_cap *= 2;
+
+        char *new_buf = realloc(reader->buf, new_cap);
+        if (new_buf == NULL) return -1;
+        reader->buf = new_buf;
+        reader->buf_cap = new_cap;
+    }
+
+    size_t n = fread(reader->buf + carry, 1, READER_BLOCK_SIZE, reader->input);
+    if (n == 0 && ferror(reader->input)) return -1;
+    if (n == 0) reader->eof = 1;
+    reader->buf_end += n;
+    return (long)n;
+}
+
+/* Helper: reads the next non-empty line from a stream reader.
+ * Parameters: reader (stream reader to advance)
+ *             out_line (set to the line bytes, line[len] is writable)
+ *             out_len (set to the line length without newline)
+ * Returns: 1 if a line was read (its commas are in reader->commas)
+ *          0 at end of input
+ *          -1 on allocation or read failure
+ * Side effects: may refill (and move) the block buffer.
+ */
+static int next_stream_line(CsvReader *reader, char **out_line, size_t *out_len) {
+    size_t scanned = 0;
+    reset_record(reader);
+
+    for (;;) {
+        size_t avail = reader->buf_end - reader->buf_start;
+        size_t len = 0;
+        int found = 0;
+
+        if (avail > 0) {
+            found = scan_record(reader, reader->buf + reader->buf_start, avail,
+                                &scanned, reader->eof, &len);
+            if (found < 0) return -1;
+        }
+
+        if (!found && !reader->eof) {
+            if (refill_stream(reader) < 0) return -1;
+            continue;
+        }
+        if (!found && avail == 0) return 0;
+
+        char *start = reader->buf + reader->buf_start;
+        if (found) {
+            reader->buf_start += len + 1;
+        } else {
+            // last line without a newline, the spare byte terminates it
+            len = avail;
+            reader->buf_start = reader->buf_end;
+        }
+        len = strip_cr(start, len);
+
+        //skip empty lines
+        if (len == 0) {
+            scanned = 0;
+            reset_record(reader);
+            continue;
+        }
+
+        *out_line = start;
+        *out_len = len;
+        return 1;
+    }
+}
+
+/* Helper: reads the next non-empty line from the reader's source.
+ * Parameters: reader (reader to advance)
+ *             out_line (set to the line bytes, line[len] is writable)
+ *             out_len (set to the line length without newline)
+ * Returns: 1 if a line was read
+ *          0 at end of input
+ *          -1 on allocation or read failure
+ * Side effects: overwrites the previous line buffer (stream sources) or
+ * advances through the mapping (mapped sources).
+ */
+static int next_line(CsvReader *reader, char **out_line, size_t *out_len) {
+    if (reader->map == NULL) {
+        return next_stream_line(reader, out_line, out_len);
+    }
+
+    CsvMap *map = reader->map;
+    char *end = reader->end;
+
+    while (reader->pos < end) {
+        char *line = reader->pos;
+        size_t offset = (size_t)(line - map->data);
+        size_t avail = (size_t)(end - line);
+        size_t scanned = 0;
+        size_t len = 0;
+        reset_record(reader);
+
+        int found = scan_record(reader, line, avail, &scanned, 1, &len);
+        if (found < 0) return -1;
+
+        if (found) {
+            reader->pos = line + len + 1;
+        } else {
+            // last line has no newline to overwrite, so parse a copy of it
+            len = avail;
+            free(map->tail);
+            map->tail = malloc(len + 1);
+            if (map->tail == NULL) return -1;
+            memcpy(map->tail, line, len);
+            map->tail[len] = '\0';
+            line = map->tail;
+            reader->pos = end;
+        }
+        len = strip_cr(line, len);
+
+        //skip empty lines
+        if (len == 0) continue;
+
+        *out_line = line;
+        *out_len = len;
+        reader->record_offset = offset;
+        return 1;
+    }
+    return 0;
+}
+
+/* Helper: checks the reader's filter against one record, before it is
+ * tokenized. The target field is found from the record's comma offsets,
+ * then trimmed and unquoted in a copy, so the record itself is unchanged.
+ * Parameters: reader (holds the filter and the record's comma offsets)
+ *             line (record bytes)
+ *             len (number of bytes in the record, newline excluded)
+ * Returns: 1 if the record passes, 0 if it does not
+ *          -1 on allocation failure
+ */
+static int filter_record(CsvReader *reader, const char *line, size_t len) {
+    size_t col = (size_t)where_column(reader->filter);
+    if (col > reader->num_commas) {
+        return where_match_cell(reader->filter, NULL); // missing cell
+    }
+
+    size_t start = col == 0 ? 0 : reader->commas[col - 1] + 1;
+    size_t stop = col < reader->num_commas ? reader->commas[col] : len;
+    size_t field_len = stop - start;
+
+    if (field_len + 1 > reader->field_cap) {
+        size_t new_cap = reader->field_cap ? reader->field_cap : 64;
+        while (new_cap < field_len + 1) new_cap *= 2;
+        char *grown = realloc(reader->field, new_cap);
+        if (grown == NULL) return -1;
+        reader->field = grown;
+        reader->field_cap = new_cap;
+    }
+    memcpy(reader->field, line + start, field_len);
+
+    char *tok = trim_span(reader->field, &field_len);
+    if (reader->quoted && tok[0] == '"') unquote_field(tok, field_len);
+    return where_match_cell(reader->filter, tok);
+}
+
+/* Helper: reads and tokenizes the next row from the reader that passes its
+ * filter (if any).
+ * Parameters: reader (reader to advance)
+ *             borrow (1 for a view row into the line buffer, 0 to copy)
+ * Returns: pointer to Row on success
+ *          NULL at end of input or on failure (reader->failed is set)
+ * Side effects: see next_line() and parse_fields().
+ */
+static Row *read_row(CsvReader *reader, int borrow) {
+    char *line = NULL;
+    size_t len = 0;
+
+    // records the filter rules out are never tokenized
+    int rc;
+    do {
+        rc = next_line(reader, &line, &len);
+    } while (rc > 0 && reader->filter != NULL && (rc = filter_record(reader, line, len)) == 0);
+    if (rc <= 0) {
+        reader->failed = (rc < 0);
+        return NULL;
+    }
+
+    Row *row = parse_fields(reader, line, len, borrow);
+    reader->failed = (row == NULL);
+    return row;
+}
+
+/* Helper: allocates a reader with all fields cleared.
+ * Returns: pointer to CsvReader on success, NULL on allocation failure
+ */
+static CsvReader *reader_new(void) {
+    CsvReader *reader = calloc(1, sizeof(CsvReader));
+    if (reader == NULL) return NULL;
+
+    reader->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    reader->record_offset = SIZE_MAX;
+    return reader;
+}
+
+/* Opens a pull-based reader over a FILE*.
+ * Parameters: input (stream to read, not closed by the reader)
+ * Returns: pointer to CsvReader on success
+ *          NULL on invalid input or allocation failure
+ */
+CsvReader *csv_reader_open(FILE *input) {
+    if (input == NULL) return NULL;
+
+    CsvReader *reader = reader_new();
+    if (reader == NULL) return NULL;
+
+    reader->input = input;
+    return reader;
+}
+
+/* Opens a pull-based reader over a mapped file.
+ * Parameters: map (mapping from csv_map_open, must outlive the reader)
+ * Returns: pointer to CsvReader on success
+ *          NULL on invalid input or allocation failure
+ */
+CsvReader *csv_reader_open_mapped(CsvMap *map) {
+    if (map == NULL) return NULL;
+
+    CsvReader *reader = reader_new();
+    if (reader == NULL) return NULL;
+
+    reader->map = map;
+    reader->pos = map->data;
+    reader->end = map->data + map->size;
+    reader->released = map->data;
+    return reader;
+}
+
+/* Helper: hands pages of a mapped source that lie entirely before the
+ * current record back to the kernel, every READER_RELEASE_BYTES.
+ * Parameters: reader (reader whose earlier records are no longer used)
+ * Returns: void
+ */
+static void release_consumed(CsvReader *reader) {
+    if (reader->map != NULL && (size_t)(reader->pos - reader->released) >= READER_RELEASE_BYTES) {
+        // rows handed out so far are dead, drop our private copies of their pages
+        size_t done = (size_t)(reader->pos - reader->released);
+        done -= done % reader->page_size;
+        madvise(reader->released, done, MADV_DONTNEED);
+        reader->released += done;
+    }
+}
+
+/* Returns the next row of the input.
+ * Parameters: reader (reader to advance)
+ * Returns: pointer to a view Row that the caller frees with row_free()
+ *          NULL at end of input or on failure (see csv_reader_failed)
+ * Side effects: the returned row's cells are only valid until the next call
+ * or csv_reader_close(). For mapped sources, pages of the mapping that lie
+ * entirely before the current row are handed back to the kernel every
+ * READER_RELEASE_BYTES, so a full scan keeps a bounded resident set.
+ */
+Row *csv_reader_next(CsvReader *reader) {
+    if (reader == NULL) return NULL;
+
+    release_consumed(reader);
+    return read_row(reader, 1);
+}
+
+/* Reports whether the last NULL from csv_reader_next was an error.
+ * Parameters: reader (reader to query)
+ * Returns: 1 on failure (or NULL reader), 0 on plain end of input
+ */
+int csv_reader_failed(const CsvReader *reader) {
+    return reader == NULL ? 1 : reader->failed;
+}
+
+/* Returns the byte offset in the file of the last row returned.
+ * Parameters: reader (mapped reader to query)
+ * Returns: offset of the row's first byte, SIZE_MAX for stream readers or
+ *          before the first row
+ */
+size_t csv_reader_offset(const CsvReader *reader) {
+    return reader == NULL ? SIZE_MAX : reader->record_offset;
+}
+
+/* Moves a mapped reader to the record starting at a byte offset.
+ * Parameters: reader (mapped reader), offset (from csv_reader_offset)
+ * Returns: 0 on success, -1 for stream readers or offsets past the end
+ * Behavior: records are tokenized in place, so each one must still be
+ * read at most once (e.g. seek to increasing offsets).
+ */
+int csv_reader_seek(CsvReader *reader, size_t offset) {
+    if (reader == NULL || reader->map == NULL) return -1;
+    if (offset > (size_t)(reader->end - reader->map->data)) return -1;
+
+    reader->pos = reader->map->data + offset;
+    if (reader->pos < reader->released) {
+        reader->released = reader->pos - offset % reader->page_size;
+    }
+    reader->failed = 0;
+    return 0;
+}
+
+/* Limits the records read from now on to some of their columns.
+ * Parameters: reader (reader to limit, usually right after the header)
+ *             keep (keep[i] != 0 to parse column i, NULL to parse all)
+ *             num_cols (number of entries in keep)
+ * Returns: 0 on success, -1 on invalid input or allocation failure
+ * Behavior: columns that are not kept read as empty cells, and records end
+ * after the last kept column (later cells are missing, see row_get_cell).
+ * Keeping every column (or none) parses whole records again.
+ */
+int csv_reader_project(CsvReader *reader, const unsigned char *keep, int num_cols) {
+    if (reader == NULL || num_cols < 0) return -1;
+
+    int keep_cols = 0;
+    int all = 1;
+    for (int col = 0; keep != NULL && col < num_cols; col++) {
+        if (keep[col]) keep_cols = col + 1;
+        else all = 0;
+    }
+
+    free(reader->keep);
+    reader->keep = NULL;
+    reader->keep_cols = 0;
+    if (all || keep_cols == 0) return 0;
+
+    reader->keep = malloc((size_t)keep_cols);
+    if (reader->keep == NULL) return -1;
+    memcpy(reader->keep, keep, (size_t)keep_cols);
+    reader->keep_cols = keep_cols;
+    return 0;
+}
+
+/* Makes the reader skip the records that do not satisfy a condition.
+ * Parameters: reader (reader to filter, usually right after the header)
+ *             cond (condition bound to the input's header, must outlive
+ *                   the reader; NULL returns every record again)
+ * Returns: 0 on success, -1 on invalid input
+ * Behavior: records are checked on their raw target field before they are
+ * tokenized, with the same result as where_match on the parsed row.
+ */
+int csv_reader_filter(CsvReader *reader, const WhereCond *cond) {
+    if (reader == NULL) return -1;
+    reader->filter = cond;
+    return 0;
+}
+
+/* Closes a reader (does not close its FILE* or mapping).
+ * Parameters: reader (safe to pass NULL)
+ * Returns: void
+ */
+void csv_reader_close(CsvReader *reader) {
+    if (reader == NULL) return;
+    free(reader->keep);
+    free(reader->field);
+    free(reader->buf);
+    free(reader->commas);
+    free(reader->cells);
+    free(reader);
+}
+
+/* Helper: appends every remaining row of a reader to a Vec.
+ * Parameters: reader (reader to drain)
+ *             rows (Vec receiving the rows)
+ *             borrow (1 for view rows, 0 for copies, see read_row)
+ * Returns: void (reader->failed is set on failure)
+ */
+static void read_rows(CsvReader *reader, Vec *rows, int borrow) {
+    Row *row;
+    while ((row = read_row(reader, borrow)) != NULL) {
+        if (vec_push(rows, row) != 0) {
+            row_free(row);
+            reader->failed = 1;
+            break;
+        }
+    }
+}
+
+/* Helper: reads the header row into an empty Vec and lets on_header limit
+ * the reader from it.
+ * Parameters: reader (reader at the start of the input)
+ *             rows (empty Vec receiving the header)
+ *             borrow (1 for a view row, 0 for a copy, see read_row)
+ *             on_header (projects/filters the reader, NULL reads all)
+ *             arg (passed to on_header)
+ * Returns: void (reader->failed is set on failure)
+ * Behavior: the header itself is always parsed whole.
+ */
+static void read_header(CsvReader *reader, Vec *rows, int borrow, CsvHeaderFn on_header, void *arg) {
+    Row *header = read_row(reader, borrow);
+    if (header == NULL) return;
+    if (vec_push(rows, header) != 0) {
+        row_free(header);
+        reader->failed = 1;
+        return;
+    }
+    if (on_header != NULL && on_header(header, reader, arg) != 0) {
+        reader->failed = 1;
+    }
+}
+
+/* Reads CSV data from a FILE* into a Vec of Row pointers, with the
+ * projection and filter that on_header sets from the header.
+ * Parameters: input (to read from)
+ *             on_header (projects/filters the reader, NULL reads all)
+ *             arg (passed to on_header)
+ * Returns: pointer to Vec on success
+ *          NULL on allocation or parse failure
+ * Side effects: Allocates rows/strings, caller owns the returned Vec and rows.
+ * Behavior: same as csv_read(), except that data rows only hold the kept
+ * columns of the records that pass the filter (see csv_reader_project and
+ * csv_reader_filter).
+ */
+Vec *csv_read_pushdown(FILE *input, CsvHeaderFn on_header, void *arg) {
+    CsvReader *reader = csv_reader_open(input);
+    if (reader == NULL) return NULL;
+
+    Vec* rows = vec_new(16);
+    if (rows == NULL) {
+        csv_reader_close(reader);
+        return NULL;
+    }
+
+    read_header(reader, rows, 0, on_header, arg);
+    if (!reader->failed) read_rows(reader, rows, 0);
+
+    if (reader->failed) {
+        // cleanup on failure
+        free_rows(rows);
+        rows = NULL;
+    }
+    csv_reader_close(reader);
+    return rows;
+}
+
 /* Reads CSV data from a FILE* into a Vec of Row pointers.
  * Parameters: input (to read from)
  * Returns: pointer to Vec on success
@@ -49,85 +827,439 @@ static void trim_inplace(char *s) {
  * columns with empty strings, and aborts (NULL) if any allocation fails.
  */
 Vec* csv_read(FILE *input) {
-    if (input == NULL) return NULL;
+    return csv_read_pushdown(input, NULL, NULL);
+}
 
-    Vec* rows = vec_new(16);
-    if (rows == NULL) return NULL;
+/* Maps a regular file into memory for parsing in place.
+ * Parameters: path (file to map)
+ * Returns: pointer to CsvMap on success
+ *          NULL if the file cannot be opened, is not a regular file,
+ *          or cannot be mapped
+ * Side effects: the mapping is private and writable, so parsing can
+ * terminate cells in place without touching the file on disk; each page
+ * written to is copied on write, so a fully parsed mapping holds about
+ * the file's size in anonymous memory (streamed readers hand parsed pages
+ * back as they go).
+ */
+CsvMap *csv_map_open(const char *path) {
+    if (path == NULL) return NULL;
 
-    char line[MAX_LINE_LENGTH];
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
 
-    while (fgets(line, sizeof(line), input)) {
-        size_t len = strlen(line);
-        //remove newline
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-            len--;
-        }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return NULL;
+    }
 
-        //skip empty lines
-        if (len == 0) continue;
+    CsvMap *map = calloc(1, sizeof(CsvMap));
+    if (map == NULL) {
+        close(fd);
+        return NULL;
+    }
 
-        // count commas to determine number of columns
-        int num_cols = 1;
-        for (size_t i = 0; i < len; i++) {
-            if (line[i] == ',') num_cols++;
+    // mmap rejects zero-length mappings, an empty file simply has no data
+    if (st.st_size > 0) {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            free(map);
+            close(fd);
+            return NULL;
         }
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        map->data = data;
+        map->size = (size_t)st.st_size;
+    }
 
-        Row *row = row_new(num_cols);
-        if (row == NULL) {
-            //cleanup
-            vec_free(rows);
-            return NULL;
+    close(fd); // the mapping keeps its own reference to the file
+    return map;
+}
+
+/* Helper: reads a mapped file into a Vec of view rows on the calling thread.
+ * Parameters: map (mapping from csv_map_open, parsed at most once)
+ *             on_header (projects/filters the reader, NULL reads all)
+ *             arg (passed to on_header)
+ * Returns: pointer to Vec on success
+ *          NULL on allocation or parse failure
+ */
+static Vec *read_mapped(CsvMap *map, CsvHeaderFn on_header, void *arg) {
+    CsvReader *reader = csv_reader_open_mapped(map);
+    if (reader == NULL) return NULL;
+
+    Vec *rows = vec_new(16);
+    if (rows == NULL) {
+        csv_reader_close(reader);
+        return NULL;
+    }
+
+    // read_row() directly: rows must stay valid, so no pages are released
+    read_header(reader, rows, 1, on_header, arg);
+    if (!reader->failed) read_rows(reader, rows, 1);
+
+    if (reader->failed) {
+        free_rows(rows);
+        rows = NULL;
+    }
+    csv_reader_close(reader);
+    return rows;
+}
+
+/* Reads CSV data from a mapped file into a Vec of view rows.
+ * Parameters: map (mapping from csv_map_open, parsed at most once)
+ * Returns: pointer to Vec on success
+ *          NULL on allocation or parse failure
+ * Side effects: tokenizes the mapping in place; the returned rows point into
+ * the mapping, so they must be freed before csv_map_close().
+ * Behavior: same as csv_read(), without a line length limit.
+ */
+Vec *csv_read_mapped(CsvMap *map) {
+    return read_mapped(map, NULL, NULL);
+}
+
+/* Helper: reads every record of the reader into a column-oriented table.
+ * Parameters: reader (reader to drain)
+ * Returns: pointer to Table on success (without rows for empty input)
+ *          NULL on allocation or parse failure
+ * Side effects: cells are copied into the table's columns, so pages of a
+ * mapped source are released as the scan moves on.
+ * Behavior: the header fixes the number of columns; longer records are
+ * cut and shorter ones get missing cells (as row_get_cell past the end).
+ * Column types are inferred once every record is loaded.
+ */
+static Table *read_table(CsvReader *reader) {
+    Table *table = NULL;
+    char *line = NULL;
+    size_t len = 0;
+    int rc;
+
+    for (;;) {
+        release_consumed(reader);  // earlier records are already copied
+        rc = next_line(reader, &line, &len);
+        if (rc <= 0) break;
+
+        int num_cells = tokenize_fields(reader, line, len);
+        if (num_cells < 0) {
+            rc = -1;
+            break;
         }
-        // length plus null terminator
-        char *tmp = malloc(len + 1);
-        if (!tmp) {
-            row_free(row);
-            vec_free(rows);
-            return NULL;
+        if (table == NULL && (table = table_new(num_cells)) == NULL) {
+            rc = -1;
+            break;
         }
-        strcpy(tmp, line);
-
-        // Process the columns by tokenizing
-        char *tok = NULL;
-        int col = 0;
-        tok = strtok(tmp, ",");
-        while (tok != NULL && col < num_cols) {
-            trim_inplace(tok);
-            if (row_set_cell(row, col, tok) != 0) {
-                //CLEANUP IF row_set_cell FAILS
-                free(tmp);
-                row_free(row);
-
-                for (size_t i = 0; i < vec_length(rows); i++)
-                    row_free(vec_get(rows, i));
-                vec_free(rows);
-                return NULL;
-            }
-            col++;
-            tok = strtok(NULL, ",");
+        if (table_append_row(table, line, reader->cells, num_cells) != 0) {
+            rc = -1;
+            break;
+        }
+    }
+
+    if (rc < 0) {
+        table_free(table);
+        return NULL;
+    }
+    if (table == NULL) return table_new(0);
+
+    // without native arrays every column is still answered from its text
+    table_infer_types(table);
+    return table;
+}
+
+/* Reads CSV data from a FILE* into a column-oriented table.
+ * Parameters: input (to read from)
+ * Returns: pointer to Table on success (caller frees with table_free)
+ *          NULL on allocation or parse failure
+ * Behavior: same tokenizing as csv_read().
+ */
+Table *csv_read_table(FILE *input) {
+    CsvReader *reader = csv_reader_open(input);
+    if (reader == NULL) return NULL;
+
+    Table *table = read_table(reader);
+    csv_reader_close(reader);
+    return table;
+}
+
+/* Reads CSV data from a mapped file into a column-oriented table.
+ * Parameters: map (mapping from csv_map_open, parsed at most once)
+ * Returns: pointer to Table on success (independent of the mapping)
+ *          NULL on allocation or parse failure
+ * Behavior: same tokenizing as csv_read_mapped().
+ */
+Table *csv_read_mapped_table(CsvMap *map) {
+    CsvReader *reader = csv_reader_open_mapped(map);
+    if (reader == NULL) return NULL;
+
+    Table *table = read_table(reader);
+    csv_reader_close(reader);
+    return table;
+}
+
+// One thread's share of a parallel load
+typedef struct {
+    CsvMap *map;  // mapping being parsed
+    char *start;  // first byte of the chunk
+    char *end;  // one past the last byte of the chunk
+    int ends_inside[2];  // 1 if the chunk ends inside quotes, when it starts
+                         // outside [0] or inside [1] quotes (counting pass)
+    Vec *rows;  // rows parsed from the chunk (parsing pass)
+    const CsvReader *header;  // reader of the header, holding projection and filter
+    Arena *arena;  // arena the chunk's rows are allocated from (or NULL)
+    int failed;  // 1 if parsing the chunk failed
+} ParseChunk;
+
+/* Helper: runs the quote state over a chunk that starts at a line start,
+ * once for each possible state there, with the block scanner.
+ * Parameters: arg (ParseChunk*, its ends_inside field is set)
+ * Returns: NULL (pthread start routine)
+ */
+static void *scan_chunk_quotes(void *arg) {
+    ParseChunk *chunk = arg;
+    const char *p = chunk->start;
+    QuoteState outside = QUOTE_STATE_INIT;
+    QuoteState inside = { 1, 0, 0 };
+    ScanMasks masks;
+
+    while (p < chunk->end) {
+        size_t n = (size_t)(chunk->end - p);
+        scan_partial(p, n, &masks);
+        scan_quote_mask(&masks, &outside);
+        scan_quote_mask(&masks, &inside);
+        p += (n < SCAN_BLOCK_SIZE) ? n : SCAN_BLOCK_SIZE;
+    }
+
+    chunk->ends_inside[0] = outside.inside;
+    chunk->ends_inside[1] = inside.inside;
+    return NULL;
+}
+
+/* Helper: parses every record of a chunk into view rows.
+ * Parameters: arg (ParseChunk* starting on a record boundary, its rows and
+ *                  failed fields are set)
+ * Returns: NULL (pthread start routine)
+ */
+static void *parse_chunk(void *arg) {
+    ParseChunk *chunk = arg;
+    chunk->failed = 1;
+
+    chunk->rows = vec_new(16);
+    CsvReader *reader = reader_new();
+    if (chunk->rows == NULL || reader == NULL) {
+        free(reader);
+        return NULL;
+    }
+
+    // rows go to the chunk's own arena, adopted by the caller afterwards
+    Arena *saved = arena_current();
+    if (chunk->arena != NULL) arena_set_current(chunk->arena);
+
+    reader->map = chunk->map;
+    reader->pos = chunk->start;
+    reader->end = chunk->end;
+
+    if (csv_reader_project(reader, chunk->header->keep, chunk->header->keep_cols) != 0) {
+        reader->failed = 1;
+    } else {
+        reader->filter = chunk->header->filter;
+        read_rows(reader, chunk->rows, 1);
+    }
+
+    chunk->failed = reader->failed;
+    csv_reader_close(reader);
+    arena_set_current(saved);
+    return NULL;
+}
+
+/* Helper: runs fn on every chunk, one thread per chunk.
+ * The calling thread takes chunk 0, and a chunk whose thread cannot be
+ * created is run inline after the others have been started.
+ * Parameters: fn (pthread start routine taking a ParseChunk*)
+ *             chunks (chunks to process)
+ *             count (number of chunks)
+ * Returns: void
+ */
+static void run_chunks(void *(*fn)(void *), ParseChunk *chunks, int count) {
+    pthread_t *threads = calloc((size_t)count, sizeof(pthread_t));
+    char *started = calloc((size_t)count, 1);
+
+    for (int i = 1; i < count; i++) {
+        if (threads != NULL && started != NULL &&
+            pthread_create(&threads[i], NULL, fn, &chunks[i]) == 0) {
+            started[i] = 1;
         }
-        // if fewer tokens than num_cols, set remaining to empty string
-        while (col < num_cols) {
-            row_set_cell(row, col, "");
-            col++;
+    }
+
+    fn(&chunks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started != NULL && started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            fn(&chunks[i]);
         }
+    }
 
-        free(tmp);
+    free(started);
+    free(threads);
+}
 
-        if (vec_push(rows, row) != 0) {
-            // cleanup on failure
-            row_free(row);
-            // free previously pushed rows
-            for (size_t i = 0; i < vec_length(rows); ++i) row_free(vec_get(rows, i));
-            vec_free(rows);
-            return NULL;
+/* Helper: finds the start of the first line at or after p.
+ * Parameters: p (any byte of the mapping)
+ *             end (one past the last mapped byte)
+ * Returns: pointer just past the first newline at or after p, or end if
+ *          there is none
+ */
+static char *next_line_start(char *p, char *end) {
+    char *newline = memchr(p, '\n', (size_t)(end - p));
+    return newline ? newline + 1 : end;
+}
+
+/* Helper: finds the start of the first record beginning at or after p,
+ * with the same quote rules as scan_record.
+ * Parameters: p (start of a line)
+ *             end (one past the last mapped byte)
+ *             in_quotes (1 if p lies inside a quoted field)
+ * Returns: p if it is outside quotes, else pointer just past the first
+ *          newline after p that is not inside quotes, or end if there is none
+ */
+static char *next_record_start(char *p, char *end, int in_quotes) {
+    QuoteState state = { in_quotes, !in_quotes, 0 };
+    ScanMasks masks;
+
+    while (state.inside && p < end) {
+        size_t n = (size_t)(end - p);
+        scan_partial(p, n, &masks);
+        uint64_t newline = masks.newline & ~scan_quote_mask(&masks, &state);
+        if (newline != 0) return p + __builtin_ctzll(newline) + 1;
+        p += (n < SCAN_BLOCK_SIZE) ? n : SCAN_BLOCK_SIZE;
+    }
+    return p;
+}
+
+/* Reads CSV data from a mapped file into a Vec of view rows using several
+ * threads, with the projection and filter that on_header sets from the
+ * header.
+ * The header is read first; the rest of the mapping is cut into equal byte
+ * ranges, each cut moved to the next line start. A first parallel pass runs
+ * the quote state over each range from both possible states at its start,
+ * so chaining the ranges in order gives the state at every cut; each cut
+ * inside quotes is then moved forward to the next record start and every
+ * range is parsed on its own thread. The per-range rows are concatenated in
+ * order.
+ * When the calling thread has a current arena, every thread fills its own
+ * arena, which is merged into the caller's once parsing is done.
+ * Parameters: map (mapping from csv_map_open, parsed at most once)
+ *             num_threads (number of parse threads, fewer are used for
+ *                          small files)
+ *             on_header (projects/filters the reader, NULL reads all)
+ *             arg (passed to on_header)
+ * Returns: pointer to Vec on success (same rows as csv_read_mapped, data
+ *          rows limited as in csv_read_pushdown)
+ *          NULL on allocation or parse failure
+ * Side effects: same as csv_read_mapped().
+ */
+Vec *csv_read_mapped_pushdown(CsvMap *map, int num_threads, CsvHeaderFn on_header, void *arg) {
+    if (map == NULL) return NULL;
+
+    size_t max_chunks = map->size / PARALLEL_MIN_CHUNK;
+    int count = num_threads;
+    if ((size_t)count > max_chunks) count = (int)max_chunks;
+    if (count <= 1) return read_mapped(map, on_header, arg);
+
+    CsvReader *header = csv_reader_open_mapped(map);
+    Vec *header_rows = vec_new(1);
+    ParseChunk *chunks = calloc((size_t)count, sizeof(ParseChunk));
+    if (header != NULL && header_rows != NULL) read_header(header, header_rows, 1, on_header, arg);
+    if (header == NULL || header_rows == NULL || chunks == NULL || header->failed) {
+        free_rows(header_rows);
+        free(chunks);
+        csv_reader_close(header);
+        return NULL;
+    }
+
+    // the records after the header are shared out
+    char *begin = header->pos;
+    char *end = map->data + map->size;
+    size_t size = (size_t)(end - begin);
+    Arena *arena = arena_current();
+    for (int i = 0; i < count; i++) {
+        chunks[i].map = map;
+        chunks[i].header = header;
+        chunks[i].arena = arena ? arena_new(0) : NULL;
+        chunks[i].start = (i == 0) ? begin : next_line_start(begin + size / (size_t)count * (size_t)i, end);
+    }
+    for (int i = 0; i < count; i++) {
+        chunks[i].end = (i == count - 1) ? end : chunks[i + 1].start;
+    }
+
+    // the state at the end of each range is the state at the next cut
+    run_chunks(scan_chunk_quotes, chunks, count);
+
+    int in_quotes = 0;
+    for (int i = 1; i < count; i++) {
+        in_quotes = chunks[i - 1].ends_inside[in_quotes];
+        chunks[i].start = next_record_start(chunks[i].start, end, in_quotes);
+        chunks[i - 1].end = chunks[i].start;
+    }
+
+    run_chunks(parse_chunk, chunks, count);
+
+    size_t total = 0;
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].failed) failed = 1;
+        else total += vec_length(chunks[i].rows);
+    }
+
+    // header_rows holds the header, or nothing for an empty file
+    Vec *rows = failed ? NULL : vec_new(total + 1);
+    if (rows != NULL && vec_length(header_rows) > 0 && vec_push(rows, vec_get(header_rows, 0)) != 0) {
+        vec_free(rows);
+        rows = NULL;
+    }
+    if (rows == NULL) free_rows(header_rows);
+    else vec_free(header_rows);
+    for (int i = 0; i < count; i++) {
+        for (size_t r = 0; chunks[i].rows != NULL && r < vec_length(chunks[i].rows); r++) {
+            Row *row = vec_get(chunks[i].rows, r);
+            if (rows != NULL && vec_push(rows, row) != 0) {
+                free_rows(rows);
+                rows = NULL;
+            }
+            if (rows == NULL) row_free(row);
         }
+        vec_free(chunks[i].rows);
+        arena_adopt(arena, chunks[i].arena);
     }
 
+    free(chunks);
+    csv_reader_close(header);
     return rows;
 }
 
+/* Reads CSV data from a mapped file into a Vec of view rows using several
+ * threads (see csv_read_mapped_pushdown).
+ * Parameters: map (mapping from csv_map_open, parsed at most once)
+ *             num_threads (number of parse threads, fewer are used for
+ *                          small files)
+ * Returns: pointer to Vec on success (same rows as csv_read_mapped)
+ *          NULL on allocation or parse failure
+ * Side effects: same as csv_read_mapped().
+ */
+Vec *csv_read_mapped_parallel(CsvMap *map, int num_threads) {
+    return csv_read_mapped_pushdown(map, num_threads, NULL, NULL);
+}
+
+/* Unmaps a file mapped with csv_map_open.
+ * Parameters: map (safe to pass NULL)
+ * Returns: void
+ * Side effects: invalidates every view row built from the mapping.
+ */
+void csv_map_close(CsvMap *map) {
+    if (map == NULL) return;
+    if (map->data != NULL) munmap(map->data, map->size);
+    free(map->tail);
+    free(map);
+}
+
 /* Determine if a token is a non empty numeric string.
  * Parameters: tok (token to examine)
  * Returns: 1 if token is numeric
@@ -238,59 +1370,233 @@ static int parse_selected_indices(Row* header, const char* selected_cols, int **
     return count;
 }
 
-/* Writes CSV rows to the provided FILE*, optionally selecting specific columns.
+/* Scans a cell once for characters that force quoting.
+ * Parameters: val (cell value, not NULL)
+ *             len (set to strlen(val) when the cell is plain)
+ * Returns: 1 if val must be quoted (see csv_needs_quotes)
+ *          0 otherwise
+ */
+static int scan_cell(const char *val, size_t *len) {
+    size_t n = strcspn(val, ",\r\n");
+    if (val[n] != '\0') return 1;
+
+    *len = n;
+    if (n == 0) return 0;
+    // a quote later in the cell is read back as it is
+    return val[0] == '"' || val[0] == ' ' || val[0] == '\t' || val[n - 1] == ' ' || val[n - 1] == '\t';
+}
+
+/* Determines whether a cell must be quoted to be read back unchanged.
+ * Parameters: val (cell value)
+ * Returns: 1 if val contains a comma, CR or LF, starts with a quote, or has
+ *          leading or trailing blanks that csv_read would trim
+ *          0 otherwise
+ */
+int csv_needs_quotes(const char *val) {
+    size_t len;
+    return val != NULL && scan_cell(val, &len);
+}
+
+/* Helper: writes one cell, quoted if needed (see csv_needs_quotes).
+ * Parameters: writer (destination)
+ *             val (cell value, NULL is written empty)
+ * Returns: void (errors stick to the writer)
+ */
+static void write_cell(Writer* writer, const char* val) {
+    if (val == NULL) return;
+
+    size_t len;
+    if (!scan_cell(val, &len)) {
+        writer_write(writer, val, len);
+        return;
+    }
+
+    /* quote the cell and double embedded quotes (RFC 4180) */
+    writer_write(writer, "\"", 1);
+    const char *p = val;
+    const char *quote;
+    while ((quote = strchr(p, '"')) != NULL) {
+        writer_write(writer, p, (size_t)(quote - p) + 1);
+        writer_write(writer, "\"", 1);
+        p = quote + 1;
+    }
+    writer_write(writer, p, strlen(p));
+    writer_write(writer, "\"", 1);
+}
+
+/* Helper: writes one cell to a stream, quoted if needed (see
+ * csv_needs_quotes).
  * Parameters: output (destination FILE*)
+ *             val (cell value, NULL is written empty)
+ * Returns: void (errors stick to the stream)
+ */
+static void write_cell_file(FILE* output, const char* val) {
+    if (val == NULL) return;
+
+    size_t len;
+    if (!scan_cell(val, &len)) {
+        fwrite(val, 1, len, output);
+        return;
+    }
+
+    /* quote the cell and double embedded quotes (RFC 4180) */
+    fputc('"', output);
+    for (const char *p = val; *p; p++) {
+        if (*p == '"') fputc('"', output);
+        fputc(*p, output);
+    }
+    fputc('"', output);
+}
+
+/* Helper: resolves the columns to write from the header.
+ * Parameters: header (header row)
+ *             selected_cols (comma list or NULL for all columns)
+ *             out_indices (set to the selected indices, NULL for all)
+ * Returns: number of columns to write
+ *          -1 on empty header or invalid selection
+ */
+static int output_columns(Row* header, const char* selected_cols, int** out_indices) {
+    *out_indices = NULL;
+    int num_cols = row_num_cells(header);
+    if (num_cols <= 0) return -1;
+    if (selected_cols == NULL) return num_cols;
+
+    /* parse selection into indices */
+    int count = parse_selected_indices(header, selected_cols, out_indices);
+    if (count <= 0) {
+        free(*out_indices);  // free if allocated but no valid indices found
+        *out_indices = NULL;
+        return -1;
+    }
+    return count;
+}
+
+/* Writes a single CSV row to a Writer.
+ * Parameters: writer (destination)
+ *             row (row to write)
+ *             indices (columns to write in order, or NULL for 0..count-1)
+ *             count (number of cells to write)
+ * Returns: 0 on success
+ *          -1 on error (including an earlier failed write)
+ * Side effects: appends to the writer's buffer; missing cells are written
+ * empty, cells that need it are quoted (see csv_needs_quotes).
+ */
+int csv_write_row_to(Writer* writer, const Row* row, const int* indices, int count) {
+    if (writer == NULL || row == NULL || count <= 0) return -1;
+
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) writer_write(writer, ",", 1);
+        write_cell(writer, row_get_cell(row, indices ? indices[i] : i));
+    }
+    return writer_write(writer, "\n", 1);
+}
+
+/* Writes CSV rows to a Writer, optionally selecting specific columns.
+ * Parameters: writer (destination)
  *             rows (Vec of Row pointers)
  *             selected_cols (comma list or NULL for all columns)
  * Returns: 0 on success
  *          -1 on error
- * Side effects: writes to the output stream and allocates temporary index array.
+ * Side effects: appends to the writer and allocates temporary index array.
  * Selection syntax: accepts column names or numeric indices (comma-separated)
  * validates against the header and returns -1 on invalid selection.
  */
-int csv_write(FILE* output, Vec* rows, const char* selected_cols) {
-    if (output == NULL || rows == NULL) return -1;
+int csv_write_to(Writer* writer, Vec* rows, const char* selected_cols) {
+    if (writer == NULL || rows == NULL) return -1;
     if (vec_length(rows) == 0) return -1;
 
     Row* header = vec_get(rows, 0);
     if (!header) return -1;
 
-    int num_cols = row_num_cells(header);
-    if (num_cols <= 0) return -1;
+    int *indices = NULL;
+    int count = output_columns(header, selected_cols, &indices);
+    if (count <= 0) return -1;
 
-    if (selected_cols == NULL) {
-        /* print all columns */
-        for (size_t r = 0; r < vec_length(rows); ++r) {
-            Row *row = vec_get(rows, r);
-            for (int c = 0; c < num_cols; ++c) {
-                if (c > 0) fputc(',', output);
-                const char *val = row_get_cell(row, c);
-                fputs(val ? val : "", output);
-            }
-            fputc('\n', output);
+    for (size_t r = 0; r < vec_length(rows); ++r) {
+        csv_write_row_to(writer, vec_get(rows, r), indices, count);
+    }
+
+    free(indices);
+    return writer_failed(writer) ? -1 : 0;
+}
+
+/* Writes the visible rows and columns of a table to a Writer.
+ * Parameters: writer (destination)
+ *             table (table to write, header first)
+ * Returns: 0 on success
+ *          -1 on error
+ * Side effects: appends to the writer, one column scan per cell position.
+ */
+int csv_write_table(Writer* writer, const Table* table) {
+    if (writer == NULL || table == NULL) return -1;
+
+    int num_cols = table_num_cols(table);
+    size_t num_rows = table_num_rows(table);
+    if (num_cols <= 0 || num_rows == 0) return -1;
+
+    const TableColumn **columns = malloc((size_t)num_cols * sizeof(TableColumn *));
+    if (columns == NULL) return -1;
+    for (int c = 0; c < num_cols; ++c) columns[c] = table_column(table, c);
+
+    const size_t *records = table_rows(table);
+    for (size_t r = 0; r < num_rows; ++r) {
+        for (int c = 0; c < num_cols; ++c) {
+            if (c > 0) writer_write(writer, ",", 1);
+            write_cell(writer, table_column_cell(columns[c], records[r]));
         }
-        return 0;
+        writer_write(writer, "\n", 1);
     }
 
-    /* parse selection into indices */
-    int *indices = NULL;
-    int nsel = parse_selected_indices(header, selected_cols, &indices);
-    if (nsel <= 0) {
-        free(indices);  // free if allocated but no valid indices found
-        return -1;
+    free(columns);
+    return writer_failed(writer) ? -1 : 0;
+}
+
+/* Writes a single CSV row to the provided FILE*.
+ * Parameters: output (destination FILE*)
+ *             row (row to write)
+ *             indices (columns to write in order, or NULL for 0..count-1)
+ *             count (number of cells to write)
+ * Returns: 0 on success
+ *          -1 on error
+ * Side effects: writes through the stream's own buffering, so it works on
+ * any FILE* (memory streams included) and keeps the order of other writes
+ * to it. Use csv_write_row_to with a Writer for bulk output.
+ */
+int csv_write_row(FILE* output, const Row* row, const int* indices, int count) {
+    if (output == NULL || row == NULL || count <= 0) return -1;
+
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) fputc(',', output);
+        write_cell_file(output, row_get_cell(row, indices ? indices[i] : i));
     }
+    return (fputc('\n', output) == EOF || ferror(output)) ? -1 : 0;
+}
 
-    for (size_t r = 0; r < vec_length(rows); ++r) {
-        Row *row = vec_get(rows, r);
-        for (int i = 0; i < nsel; ++i) {
-            if (i > 0) fputc(',', output);
-            int col = indices[i];
-            const char *val = row_get_cell(row, col);
-            fputs(val ? val : "", output);
-        }
-        fputc('\n', output);
+/* Writes CSV rows to the provided FILE*, optionally selecting specific columns.
+ * Parameters: output (destination FILE*)
+ *             rows (Vec of Row pointers)
+ *             selected_cols (comma list or NULL for all columns)
+ * Returns: 0 on success
+ *          -1 on error
+ * Side effects: writes through the stream's own buffering (see
+ * csv_write_row); csv_write_to is the buffered Writer equivalent.
+ */
+int csv_write(FILE* output, Vec* rows, const char* selected_cols) {
+    if (output == NULL || rows == NULL) return -1;
+    if (vec_length(rows) == 0) return -1;
+
+    Row* header = vec_get(rows, 0);
+    if (!header) return -1;
+
+    int *indices = NULL;
+    int count = output_columns(header, selected_cols, &indices);
+    if (count <= 0) return -1;
+
+    int rc = 0;
+    for (size_t r = 0; r < vec_length(rows) && rc == 0; ++r) {
+        rc = csv_write_row(output, vec_get(rows, r), indices, count);
     }
 
     free(indices);
-    return 0;
+    return rc;
 }
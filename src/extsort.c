@@ -0,0 +1,492 @@
+/*
+ * Implements external sorting of rows by one or more columns.
+ * Rows are copied into an arena until they (plus the scratch the sort
+ * needs for them) fill the memory budget; the buffer is then sorted and
+ * written to an unlinked temporary file as a run, and the arena reset.
+ * Whenever EXTSORT_MERGE_WIDTH runs of the same size have piled up they
+ * are merged into one larger run, so few files are open at once and every
+ * row is rewritten only a few times. Finishing merges the remaining runs
+ * (and the last buffer) with a heap and hands the rows out one at a time,
+ * so the sorted result never has to fit in memory.
+ *
+ * Run files hold one record per row: the number of cells and the number
+ * of bytes (two uint32_t), then the cells, each NUL-terminated.
+ * Rows are ordered like sort_by_columns, and equal keys come out in the
+ * order they were added: runs are sorted stably and the merge prefers the
+ * earlier run.
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _DEFAULT_SOURCE  // mkstemp, fdopen
+
+#include "../include/extsort.h"
+#include "../include/arena.h"
+#include "../include/sort.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Arena block size for buffered rows (small, so the budget is kept closely)
+#define EXTSORT_ARENA_BLOCK (64u << 10)
+
+// Bytes counted per buffered row besides its copy: the row pointer and the
+// keys, positions and merge buffers sort_rows uses
+#define EXTSORT_ROW_OVERHEAD 128u
+
+// stdio buffer of a run file
+#define EXTSORT_IO_BUFFER (256u << 10)
+
+// One sorted run in a temporary file
+typedef struct Run {
+    FILE *file;
+    int level;  // 0 for a spilled buffer, one more per merge
+} Run;
+
+struct ExtSort {
+    SortColumn *cols;  // ORDER BY columns
+    int num_cols;
+    int num_threads;
+    size_t memory_limit;
+    Arena *arena;  // copies of the buffered rows
+    Row **rows;  // buffered rows, in the order they were added
+    size_t num_rows;
+    size_t rows_cap;
+    size_t key_bytes;  // bound on the encoded keys of the buffered rows (several columns)
+    const char **cells;  // scratch for copying a row
+    int cells_cap;
+    Run *runs;  // runs, in the order their rows were added
+    size_t num_runs;
+    size_t runs_cap;
+    int failed;
+};
+
+// Read side of one run during a merge
+typedef struct MergeInput {
+    FILE *file;
+    char *data;  // bytes of the current record
+    size_t data_cap;
+    uint32_t *offsets;  // cell offsets of the current record
+    int offsets_cap;
+    Row *row;  // current row (a view of data), NULL once the run is done
+    SortKey key;  // key of row; pos is the run's index, preferring earlier runs
+    unsigned char *key_data;  // encoded key of row when sorting by several columns
+    size_t key_cap;
+} MergeInput;
+
+/*
+ * Internal helper: creates an unlinked temporary file for a run.
+ *
+ * RETURN: FILE* open for writing and reading, NULL on failure
+ */
+static FILE *open_run_file(void) {
+    const char *dir = getenv("TMPDIR");
+    if (dir == NULL || *dir == '\0') dir = "/tmp";
+
+    char path[4096];
+    if (snprintf(path, sizeof(path), "%s/csvlite_sort_XXXXXX", dir) >= (int)sizeof(path)) return NULL;
+
+    int fd = mkstemp(path);
+    if (fd < 0) return NULL;
+    unlink(path);
+
+    FILE *file = fdopen(fd, "w+b");
+    if (file == NULL) {
+        close(fd);
+        return NULL;
+    }
+    setvbuf(file, NULL, _IOFBF, EXTSORT_IO_BUFFER);
+    return file;
+}
+
+/*
+ * Internal helper: appends one row to a run file.
+ *
+ * RETURN: 0 on success, -1 on write error
+ */
+static int write_record(FILE *file, const Row *row) {
+    uint32_t head[2] = { (uint32_t)row_num_cells(row), 0 };
+    for (int i = 0; i < row_num_cells(row); i++) {
+        const char *cell = row_get_cell(row, i);
+        head[1] += (uint32_t)(cell != NULL ? strlen(cell) : 0) + 1;
+    }
+
+    if (fwrite(head, sizeof(uint32_t), 2, file) != 2) return -1;
+    for (int i = 0; i < row_num_cells(row); i++) {
+        const char *cell = row_get_cell(row, i);
+        if (cell == NULL) cell = "";
+        if (fwrite(cell, 1, strlen(cell) + 1, file) != strlen(cell) + 1) return -1;
+    }
+    return 0;
+}
+
+/*
+ * Internal helper: ExtSortFn writing each merged row to a run file.
+ *
+ * RETURN: 0 to continue, 1 to stop after a write error
+ */
+static int write_merged(const Row *row, void *arg) {
+    return write_record(arg, row) != 0;
+}
+
+/*
+ * Internal helper: reads the next record of a run into in->row (NULL at
+ * the end of the run) and sets its key: the cell itself for one column,
+ * otherwise the cells encoded into in->key_data.
+ * Rows are views of in->data, so the arena must not be current.
+ *
+ * RETURN: 0 on success, -1 on read error, a malformed record or allocation failure
+ */
+static int read_record(MergeInput *in, const ExtSort *sorter, size_t pos) {
+    row_free(in->row);
+    in->row = NULL;
+
+    uint32_t head[2];
+    size_t n = fread(head, sizeof(uint32_t), 2, in->file);
+    if (n == 0 && feof(in->file)) return 0;
+    if (n != 2 || head[0] == 0 || head[0] > INT32_MAX || head[1] > ROW_MAX_BYTES) return -1;
+
+    if (head[1] > in->data_cap) {
+        char *data = realloc(in->data, head[1]);
+        if (data == NULL) return -1;
+        in->data = data;
+        in->data_cap = head[1];
+    }
+    if ((int)head[0] > in->offsets_cap) {
+        uint32_t *offsets = realloc(in->offsets, head[0] * sizeof(uint32_t));
+        if (offsets == NULL) return -1;
+        in->offsets = offsets;
+        in->offsets_cap = (int)head[0];
+    }
+    if (fread(in->data, 1, head[1], in->file) != head[1]) return -1;
+
+    // cells are back to back, each NUL-terminated
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < head[0]; i++) {
+        const char *end = offset < head[1] ? memchr(in->data + offset, '\0', head[1] - offset) : NULL;
+        if (end == NULL) return -1;
+        in->offsets[i] = offset;
+        offset = (uint32_t)(end - in->data) + 1;
+    }
+
+    in->row = row_new_view(in->data, in->offsets, (int)head[0]);
+    if (in->row == NULL) return -1;
+    if (sorter->num_cols == 1) {
+        sort_key_init(&in->key, row_get_cell(in->row, sorter->cols[0].col_index), pos);
+        return 0;
+    }
+
+    size_t len = sort_key_encode_row(in->row, sorter->cols, sorter->num_cols, &in->key_data, &in->key_cap);
+    if (len == 0) return -1;
+    in->key = (SortKey){ (int64_t)len, (const char *)in->key_data, pos, SORT_KEY_ENCODED };
+    return 0;
+}
+
+/*
+ * Internal helper: moves heap[i] down until neither child sorts before it.
+ */
+static void sift_down(MergeInput **heap, size_t count, size_t i, int ascending) {
+    for (;;) {
+        size_t first = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < count && sort_key_compare(&heap[left]->key, &heap[first]->key, ascending) < 0) first = left;
+        if (right < count && sort_key_compare(&heap[right]->key, &heap[first]->key, ascending) < 0) first = right;
+        if (first == i) return;
+
+        MergeInput *swap = heap[i];
+        heap[i] = heap[first];
+        heap[first] = swap;
+        i = first;
+    }
+}
+
+/*
+ * Internal helper: merges runs[first, first + count) and passes the rows
+ * to fn in sorted order, until fn returns nonzero.
+ *
+ * RETURN: 0 on success, -1 on read or allocation failure
+ */
+static int merge_runs(ExtSort *sorter, size_t first, size_t count, ExtSortFn fn, void *arg) {
+    MergeInput *inputs = calloc(count, sizeof(MergeInput));
+    MergeInput **heap = calloc(count, sizeof(MergeInput *));
+    int failed = inputs == NULL || heap == NULL;
+
+    // merged rows are views freed one by one, not arena rows
+    Arena *saved = arena_current();
+    arena_set_current(NULL);
+
+    size_t heap_len = 0;
+    for (size_t i = 0; i < count && !failed; i++) {
+        inputs[i].file = sorter->runs[first + i].file;
+        if (fflush(inputs[i].file) != 0 || fseek(inputs[i].file, 0, SEEK_SET) != 0 ||
+            read_record(&inputs[i], sorter, i) != 0) {
+            failed = 1;
+        } else if (inputs[i].row != NULL) {
+            heap[heap_len++] = &inputs[i];
+        }
+    }
+    int ascending = sorter->cols[0].ascending;  // encoded keys hold their own
+    for (size_t i = heap_len / 2; i-- > 0 && !failed;) sift_down(heap, heap_len, i, ascending);
+
+    while (heap_len > 0 && !failed) {
+        MergeInput *top = heap[0];
+        if (fn(top->row, arg) != 0) break;
+
+        if (read_record(top, sorter, (size_t)(top - inputs)) != 0) {
+            failed = 1;
+        } else {
+            if (top->row == NULL) heap[0] = heap[--heap_len];
+            sift_down(heap, heap_len, 0, ascending);
+        }
+    }
+
+    for (size_t i = 0; inputs != NULL && i < count; i++) {
+        row_free(inputs[i].row);
+        free(inputs[i].data);
+        free(inputs[i].offsets);
+        free(inputs[i].key_data);
+    }
+    arena_set_current(saved);
+    free(inputs);
+    free(heap);
+    return failed ? -1 : 0;
+}
+
+/*
+ * Internal helper: appends a run to the list.
+ *
+ * RETURN: 0 on success, -1 on allocation failure
+ */
+static int push_run(ExtSort *sorter, FILE *file, int level) {
+    if (sorter->num_runs == sorter->runs_cap) {
+        size_t cap = sorter->runs_cap ? sorter->runs_cap * 2 : 16;
+        Run *runs = realloc(sorter->runs, cap * sizeof(Run));
+        if (runs == NULL) return -1;
+        sorter->runs = runs;
+        sorter->runs_cap = cap;
+    }
+    sorter->runs[sorter->num_runs++] = (Run){ file, level };
+    return 0;
+}
+
+/*
+ * Internal helper: merges the last EXTSORT_MERGE_WIDTH runs into one while
+ * they all have the same level.
+ *
+ * RETURN: 0 on success, -1 on failure
+ */
+static int merge_full_levels(ExtSort *sorter) {
+    while (sorter->num_runs >= EXTSORT_MERGE_WIDTH) {
+        size_t first = sorter->num_runs - EXTSORT_MERGE_WIDTH;
+        int level = sorter->runs[first].level;
+        for (size_t i = first + 1; i < sorter->num_runs; i++) {
+            if (sorter->runs[i].level != level) return 0;
+        }
+
+        FILE *file = open_run_file();
+        if (file == NULL) return -1;
+        if (merge_runs(sorter, first, EXTSORT_MERGE_WIDTH, write_merged, file) != 0 ||
+            fflush(file) != 0 || ferror(file)) {
+            fclose(file);
+            return -1;
+        }
+
+        for (size_t i = first; i < sorter->num_runs; i++) fclose(sorter->runs[i].file);
+        sorter->runs[first] = (Run){ file, level + 1 };
+        sorter->num_runs = first + 1;
+    }
+    return 0;
+}
+
+/*
+ * Internal helper: sorts the buffered rows and writes them out as a run,
+ * then releases them.
+ *
+ * RETURN: 0 on success, -1 on failure
+ */
+static int spill(ExtSort *sorter) {
+    if (sort_rows_by_columns(sorter->rows, sorter->num_rows, sorter->cols, sorter->num_cols,
+                             sorter->num_threads) != 0) {
+        return -1;
+    }
+
+    FILE *file = open_run_file();
+    if (file == NULL) return -1;
+
+    int failed = 0;
+    for (size_t i = 0; i < sorter->num_rows && !failed; i++) {
+        failed = write_record(file, sorter->rows[i]) != 0;
+    }
+    if (failed || fflush(file) != 0 || push_run(sorter, file, 0) != 0) {
+        fclose(file);
+        return -1;
+    }
+
+    sorter->num_rows = 0;
+    sorter->key_bytes = 0;
+    arena_reset(sorter->arena);
+    return merge_full_levels(sorter);
+}
+
+/*
+ * Creates an external sorter.
+ *
+ * parameters:
+ * - cols: columns to sort by, in order, each with its direction (copied)
+ * - num_cols: number of columns
+ * - memory_limit: bytes of buffered rows and sort scratch before a run is
+ *   written (at least EXTSORT_MIN_MEMORY)
+ * - num_threads: threads used to sort each run
+ *
+ * RETURN: new sorter, NULL on bad input, allocation failure or when no
+ *         temporary file can be created
+ */
+ExtSort *extsort_new(const SortColumn *cols, int num_cols, size_t memory_limit, int num_threads) {
+    if (cols == NULL || num_cols < 1) return NULL;
+    for (int i = 0; i < num_cols; i++) {
+        if (cols[i].col_index < 0) return NULL;
+    }
+
+    // a sorter that cannot spill would only fail once rows have gone out
+    FILE *probe = open_run_file();
+    if (probe == NULL) return NULL;
+    fclose(probe);
+
+    ExtSort *sorter = calloc(1, sizeof(ExtSort));
+    if (sorter == NULL) return NULL;
+
+    sorter->arena = arena_new(EXTSORT_ARENA_BLOCK);
+    sorter->cols = malloc((size_t)num_cols * sizeof(SortColumn));
+    if (sorter->arena == NULL || sorter->cols == NULL) {
+        arena_free(sorter->arena);
+        free(sorter->cols);
+        free(sorter);
+        return NULL;
+    }
+    memcpy(sorter->cols, cols, (size_t)num_cols * sizeof(SortColumn));
+    sorter->num_cols = num_cols;
+    sorter->num_threads = num_threads;
+    sorter->memory_limit = memory_limit < EXTSORT_MIN_MEMORY ? EXTSORT_MIN_MEMORY : memory_limit;
+    return sorter;
+}
+
+/*
+ * Adds a copy of a row, spilling the buffer as a run once it is full.
+ *
+ * parameters:
+ * - sorter: sorter to add to
+ * - row: row to copy (only read during the call)
+ *
+ * RETURN: 0 on success, -1 on bad input or failure
+ */
+int extsort_add(ExtSort *sorter, const Row *row) {
+    if (sorter == NULL || row == NULL || sorter->failed) return -1;
+
+    int num_cells = row_num_cells(row);
+    if (num_cells > sorter->cells_cap) {
+        const char **cells = realloc(sorter->cells, (size_t)num_cells * sizeof(char *));
+        if (cells == NULL) return -1;
+        sorter->cells = cells;
+        sorter->cells_cap = num_cells;
+    }
+    if (sorter->num_rows == sorter->rows_cap) {
+        size_t cap = sorter->rows_cap ? sorter->rows_cap * 2 : 1024;
+        Row **rows = realloc(sorter->rows, cap * sizeof(Row *));
+        if (rows == NULL) return -1;
+        sorter->rows = rows;
+        sorter->rows_cap = cap;
+    }
+
+    for (int i = 0; i < num_cells; i++) {
+        const char *cell = row_get_cell(row, i);
+        sorter->cells[i] = cell != NULL ? cell : "";
+    }
+
+    // sorting by several columns encodes the sort cells once more
+    for (int i = 0; sorter->num_cols > 1 && i < sorter->num_cols; i++) {
+        const char *cell = row_get_cell(row, sorter->cols[i].col_index);
+        sorter->key_bytes += (cell != NULL ? strlen(cell) : 0) + SORT_KEY_ENCODE_EXTRA;
+    }
+
+    // the copy lives in the sorter's arena until the buffer is spilled
+    Arena *saved = arena_current();
+    arena_set_current(sorter->arena);
+    Row *copy = row_new_from_cells(sorter->cells, num_cells);
+    arena_set_current(saved);
+    if (copy == NULL) return -1;
+    sorter->rows[sorter->num_rows++] = copy;
+
+    ArenaStats stats;
+    arena_stats(sorter->arena, &stats);
+    size_t used = stats.bytes_reserved + sorter->num_rows * EXTSORT_ROW_OVERHEAD + sorter->key_bytes;
+    if (used >= sorter->memory_limit && spill(sorter) != 0) {
+        sorter->failed = 1;
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Gets the number of runs written so far (after merges).
+ *
+ * RETURN: number of runs, 0 for NULL
+ */
+size_t extsort_num_runs(const ExtSort *sorter) {
+    return sorter != NULL ? sorter->num_runs : 0;
+}
+
+/*
+ * Passes every added row to fn in sorted order. Without runs the buffer is
+ * sorted and handed out directly; otherwise it becomes the last run and
+ * all runs are merged.
+ *
+ * parameters:
+ * - sorter: sorter to finish
+ * - fn: receives each row until it returns nonzero
+ * - arg: passed to fn
+ *
+ * RETURN: 0 on success, -1 on bad input or failure
+ */
+int extsort_finish(ExtSort *sorter, ExtSortFn fn, void *arg) {
+    if (sorter == NULL || fn == NULL || sorter->failed) return -1;
+
+    if (sorter->num_runs == 0) {
+        if (sort_rows_by_columns(sorter->rows, sorter->num_rows, sorter->cols, sorter->num_cols,
+                                 sorter->num_threads) != 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < sorter->num_rows; i++) {
+            if (fn(sorter->rows[i], arg) != 0) break;
+        }
+        return 0;
+    }
+
+    if (sorter->num_rows > 0 && spill(sorter) != 0) {
+        sorter->failed = 1;
+        return -1;
+    }
+    return merge_runs(sorter, 0, sorter->num_runs, fn, arg);
+}
+
+/*
+ * Frees a sorter, closing (and so deleting) its run files.
+ *
+ * parameters:
+ * - sorter: sorter to free (NULL is ignored)
+ */
+void extsort_free(ExtSort *sorter) {
+    if (sorter == NULL) return;
+
+    for (size_t i = 0; i < sorter->num_runs; i++) fclose(sorter->runs[i].file);
+    arena_free(sorter->arena);
+    free(sorter->cols);
+    free(sorter->runs);
+    free(sorter->rows);
+    free(sorter->cells);
+    free(sorter);
+}
@@ -13,6 +13,7 @@
 #include "vec.h"
 #include "row.h"
 #include "hmap.h"
+#include "table.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -121,3 +122,51 @@ Vec* group_by_column(Vec* rows, int col_index)
     hmap_free(seen);
     return grouped;
 }
+
+/* Groups the visible rows of a column-oriented table by a column, in place.
+ * Scans the group column directly and keeps the FIRST row of each key,
+ * in input order; like group_by_column, the header takes part as row 0.
+ *
+ * PARAMETERS:
+ *  table, the table to group (record ids are reused, no cells are copied)
+ *  col_index, the visible column index to group by
+ *
+ * RETURNS:
+ *  0 on success, -1 on invalid arguments or allocation failure
+ */
+int group_table_by_column(Table *table, int col_index)
+{
+    const TableColumn *column = table_column(table, col_index);
+    if (!column) {
+        return -1;
+    }
+
+    size_t n = table_num_rows(table);
+    if (n == 0) {
+        return -1;
+    }
+
+    // One bucket per row keeps chains short when most keys are distinct
+    HMap *seen = hmap_new(n);
+    if (!seen) return -1;
+
+    size_t *rows = table_rows(table);
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char *key = table_column_cell(column, rows[i]);
+        if (!key) key = "";
+
+        if (hmap_get(seen, key) == NULL) {
+            // value is only a marker, so store the (non-NULL) record id + 1
+            hmap_put(seen, key, (void *)(rows[i] + 1));
+            if (hmap_size(seen) != kept + 1) { // allocation failed
+                hmap_free(seen);
+                return -1;
+            }
+            rows[kept++] = rows[i];
+        }
+    }
+
+    hmap_free(seen);
+    return table_set_num_rows(table, kept);
+}
@@ -2,6 +2,9 @@
  * Provides a hash table with collision handling for string key -> void* value pairs.
  * The capacity is fixed and does not change after initialization.
  * The resize feature is not implemented (given the scope of the project).
+ * Each entry is one allocation holding its key. Maps created while the
+ * thread has a current arena (see arena.h) allocate everything from it, and
+ * freeing such a map leaves the memory to be released with the arena.
  *
  * AUTHOR: Billy
  * DATE: November 11, 2025
@@ -9,12 +12,13 @@
  */
 
 #include "../include/hmap.h"
+#include "../include/arena.h"
 #include <stdlib.h>
 #include <string.h>
 
 // Stores key-value pair (implemented using hashtable)
 typedef struct HMapEntry {
-    char *key;  // string key
+    char *key;  // string key (stored right after the entry)
     void *value;  // value pointer
     struct HMapEntry *next;  // next entry in LinkedList (for collision handling)
 } HMapEntry;
@@ -23,13 +27,14 @@ struct HMap {
     HMapEntry **buckets;  // array of pointer to HMapEntry
     size_t capacity;  // number of buckets
     size_t size;
+    Arena *arena;  // arena owning the map and its entries (NULL for malloc)
 };
 
 // Simple hash function using djb2 algorithm
-// Returns hash value in range [0, capacity)
+// Returns the full hash value (also used by on-disk indexes)
 // Note: not a good hash function, but it's simple and works for our use case
-static size_t hash_code(const char *key, size_t capacity) {
-    if (key == NULL || capacity == 0) return 0;
+size_t hmap_hash(const char *key) {
+    if (key == NULL) return 0;
     
     unsigned long hash = 5381;  // prime
     int c;
@@ -37,7 +42,13 @@ static size_t hash_code(const char *key, size_t capacity) {
     while ((c = *key++)) {
         hash = ((hash << 5) + hash) + c;  // hash * 33 + c
     }
-    return hash % capacity;
+    return hash;
+}
+
+// Returns hash value in range [0, capacity)
+static size_t hash_code(const char *key, size_t capacity) {
+    if (key == NULL || capacity == 0) return 0;
+    return hmap_hash(key) % capacity;
 }
 
 /* 
@@ -55,21 +66,28 @@ HMap *hmap_new(size_t capacity) {
         capacity = 16;  // default minimum capacity
     }
     
-    HMap *map = malloc(sizeof(HMap));
+    Arena *arena = arena_current();
+    HMap *map = arena ? arena_alloc(arena, sizeof(HMap)) : malloc(sizeof(HMap));
     if (map == NULL) { // allocation faileds
         return NULL;
     }
-    
+
     // initialize buckets to NULL
-    map->buckets = calloc(capacity, sizeof(HMapEntry *));
+    if (arena != NULL) {
+        map->buckets = arena_alloc(arena, capacity * sizeof(HMapEntry *));
+        if (map->buckets != NULL) memset(map->buckets, 0, capacity * sizeof(HMapEntry *));
+    } else {
+        map->buckets = calloc(capacity, sizeof(HMapEntry *));
+    }
     if (map->buckets == NULL) { // allocation failed
-        free(map);
+        if (arena == NULL) free(map);
         return NULL;
     }
     
     // initialize fields
     map->capacity = capacity;
     map->size = 0;
+    map->arena = arena;
     
     return map;
 }
@@ -105,19 +123,17 @@ void *hmap_put(HMap *map, const char *key, void *value) {
         entry = entry->next;
     }
     
-    // not in the linked list: create new entry
-    entry = malloc(sizeof(HMapEntry));
+    // not in the linked list: create new entry with the key copied behind it
+    size_t key_size = strlen(key) + 1; // allow '\0' terminator
+    size_t size = sizeof(HMapEntry) + key_size;
+    entry = map->arena ? arena_alloc(map->arena, size) : malloc(size);
     if (entry == NULL) { // allocation failed
         return NULL;
     }
-    
-    entry->key = malloc(strlen(key) + 1); // allow '\0' terminator
-    if (entry->key == NULL) { // allocation failed
-        free(entry);
-        return NULL;
-    }
-    strcpy(entry->key, key);
-    
+
+    entry->key = (char *)(entry + 1);
+    memcpy(entry->key, key, key_size);
+
     entry->value = value;
     entry->next = map->buckets[index];  // insert at head of linked list
     map->buckets[index] = entry;
@@ -208,8 +224,7 @@ void *hmap_remove(HMap *map, const char *key) {
             }
             
             // caller is responsible for freeing the value
-            free(entry->key); 
-            free(entry);
+            if (map->arena == NULL) free(entry);
             map->size--;
             return pre_value;
         }
@@ -244,15 +259,17 @@ size_t hmap_size(const HMap *map) {
 void hmap_free(HMap *map) {
 
     if (map == NULL) return;
+
+    // arena maps are released with their arena
+    if (map->arena != NULL) return;
     
-    // free all entries in all buckets
+    // free all entries in all buckets (keys live inside their entries)
     for (size_t i = 0; i < map->capacity; i++) {
         HMapEntry *entry = map->buckets[i];
 
         // free each entry in the linked list
         while (entry != NULL) {
             HMapEntry *next = entry->next;
-            free(entry->key);
             free(entry);
             entry = next;
         }
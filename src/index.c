@@ -0,0 +1,293 @@
+/*
+ * Provides on-disk hash indexes for equality WHERE lookups (--build-index).
+ * An index maps the hash of every cell of one column (the HMap's djb2
+ * hash) to the byte offsets of the records holding it. Entries are
+ * grouped by bucket and kept in file order, so a lookup reads one bucket
+ * and hands back increasing offsets for the reader to seek to; only those
+ * records are parsed. Hashes can collide, so callers recheck every record.
+ * Like cache images, an index records the source's identity and is
+ * ignored once the source changes.
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "../include/index.h"
+#include "../include/hmap.h"
+#include "../include/row.h"
+#include "../include/writer.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INDEX_MAGIC "CSVLIDX1"
+#define INDEX_VERSION 1
+#define INDEX_BYTE_ORDER 0x01020304u
+
+// Initial number of entries collected while building
+#define INDEX_INITIAL_ENTRIES 1024
+
+// File header, followed by num_buckets + 1 bucket starts and the entries
+typedef struct IndexHeader {
+    char magic[8];  // INDEX_MAGIC
+    uint32_t version;  // INDEX_VERSION
+    uint32_t byte_order;  // INDEX_BYTE_ORDER as stored by the writer
+    uint32_t column;  // indexed column
+    uint32_t reserved;  // 0
+    uint64_t num_buckets;  // number of hash buckets (at least 1)
+    uint64_t num_entries;  // number of indexed records
+    CacheKey key;  // identity of the source file
+} IndexHeader;
+
+// One indexed record
+typedef struct IndexEntry {
+    uint64_t hash;  // hmap_hash of the record's cell
+    uint64_t offset;  // byte offset of the record in the source
+} IndexEntry;
+
+struct Index {
+    void *data;  // mapped index file
+    size_t size;  // size of the mapping
+    uint64_t num_buckets;  // number of hash buckets
+    uint64_t num_entries;  // number of entries
+    const uint64_t *starts;  // first entry of each bucket (num_buckets + 1)
+    const IndexEntry *entries;  // entries grouped by bucket
+};
+
+/*
+ * Internal helper: builds "<source_path>.<column>.idx", plus an optional
+ * extra suffix.
+ *
+ * RETURN: newly allocated path, NULL on allocation failure
+ */
+static char *index_path(const char *source_path, int column, const char *extra) {
+    size_t len = strlen(source_path) + strlen(extra) + 32;
+    char *path = malloc(len);
+    if (path == NULL) return NULL;
+
+    snprintf(path, len, "%s.%d%s%s", source_path, column, INDEX_SUFFIX, extra);
+    return path;
+}
+
+/*
+ * Builds the index of one column and writes it next to the source file.
+ * The file is written under a temporary name and renamed into place only
+ * if the source still has the identity it was read with.
+ *
+ * parameters:
+ * - reader: mapped reader positioned after the header
+ * - column: column to index (missing cells are indexed as "")
+ * - source_path: path of the CSV file the reader maps
+ * - key: identity of the source taken before it was mapped
+ *
+ * RETURN: 0 on success, -1 on bad input, read or write failure, or if the
+ *         source changed while it was being read
+ */
+int index_build(CsvReader *reader, int column, const char *source_path, const CacheKey *key) {
+    if (reader == NULL || column < 0 || source_path == NULL || key == NULL) return -1;
+
+    // collect (hash, offset) of every record in file order
+    IndexEntry *found = malloc(INDEX_INITIAL_ENTRIES * sizeof(IndexEntry));
+    size_t count = 0;
+    size_t cap = INDEX_INITIAL_ENTRIES;
+    Row *row;
+    while (found != NULL && (row = csv_reader_next(reader)) != NULL) {
+        if (count == cap) {
+            IndexEntry *grown = realloc(found, cap * 2 * sizeof(IndexEntry));
+            if (grown == NULL) {
+                row_free(row);
+                free(found);
+                found = NULL;
+                break;
+            }
+            found = grown;
+            cap *= 2;
+        }
+
+        const char *cell = row_get_cell(row, column);
+        found[count].hash = hmap_hash(cell != NULL ? cell : "");
+        found[count].offset = csv_reader_offset(reader);
+        count++;
+        row_free(row);
+    }
+    if (found == NULL || csv_reader_failed(reader)) {
+        free(found);
+        return -1;
+    }
+
+    // group by bucket with a stable counting sort, keeping file order
+    uint64_t num_buckets = count > 0 ? count : 1;
+    uint64_t *starts = calloc(num_buckets + 1, sizeof(uint64_t));
+    IndexEntry *entries = malloc((count > 0 ? count : 1) * sizeof(IndexEntry));
+    if (starts == NULL || entries == NULL) {
+        free(found);
+        free(starts);
+        free(entries);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) starts[found[i].hash % num_buckets + 1]++;
+    for (uint64_t b = 0; b < num_buckets; b++) starts[b + 1] += starts[b];
+    for (size_t i = 0; i < count; i++) {
+        uint64_t b = found[i].hash % num_buckets;
+        entries[starts[b]++] = found[i];
+    }
+    // the placement loop moved each start to the next bucket's start
+    memmove(starts + 1, starts, num_buckets * sizeof(uint64_t));
+    starts[0] = 0;
+    free(found);
+
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.byte_order = INDEX_BYTE_ORDER;
+    header.column = (uint32_t)column;
+    header.num_buckets = num_buckets;
+    header.num_entries = count;
+    header.key = *key;
+
+    char *path = index_path(source_path, column, "");
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%ld", (long)getpid());
+    char *tmp_path = index_path(source_path, column, suffix);
+    Writer *out = (path != NULL && tmp_path != NULL) ? writer_open_path(tmp_path) : NULL;
+
+    int result = -1;
+    if (out != NULL) {
+        writer_write(out, (const char *)&header, sizeof(header));
+        writer_write(out, (const char *)starts, (size_t)(num_buckets + 1) * sizeof(uint64_t));
+        writer_write(out, (const char *)entries, count * sizeof(IndexEntry));
+        // a source rewritten while it was read must not be indexed under the old key
+        result = writer_close(out);
+        if (result == 0) {
+            result = cache_commit(tmp_path, path, source_path, key);
+        } else {
+            unlink(tmp_path);
+        }
+    }
+
+    free(starts);
+    free(entries);
+    free(path);
+    free(tmp_path);
+    return result;
+}
+
+/*
+ * Maps the index of a column and checks that it belongs to the given
+ * source identity and that its sections fit the file.
+ *
+ * parameters:
+ * - source_path: path of the CSV file
+ * - column: indexed column
+ * - key: current identity of the source (from cache_key)
+ *
+ * RETURN: pointer to new Index on success, NULL if the index is missing,
+ *         stale or corrupt
+ */
+Index *index_open(const char *source_path, int column, const CacheKey *key) {
+    if (source_path == NULL || column < 0 || key == NULL) return NULL;
+
+    char *path = index_path(source_path, column, "");
+    if (path == NULL) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(IndexHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (data == MAP_FAILED) return NULL;
+
+    // the sections must fill the rest of the file exactly
+    const IndexHeader *header = data;
+    size_t size = (size_t)st.st_size;
+    uint64_t words = (size - sizeof(IndexHeader)) / sizeof(uint64_t);
+    int valid = memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+                header->version == INDEX_VERSION && header->byte_order == INDEX_BYTE_ORDER &&
+                header->column == (uint32_t)column && memcmp(&header->key, key, sizeof(CacheKey)) == 0 &&
+                header->num_buckets >= 1 && header->num_buckets < words && header->num_entries <= words / 2 &&
+                sizeof(IndexHeader) + (header->num_buckets + 1) * sizeof(uint64_t) +
+                    header->num_entries * sizeof(IndexEntry) == size;
+
+    Index *index = valid ? malloc(sizeof(Index)) : NULL;
+    if (index == NULL) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    index->data = data;
+    index->size = size;
+    index->num_buckets = header->num_buckets;
+    index->num_entries = header->num_entries;
+    index->starts = (const uint64_t *)(header + 1);
+    index->entries = (const IndexEntry *)(index->starts + index->num_buckets + 1);
+    return index;
+}
+
+/*
+ * Collects the offsets of the records whose cell hashes like value.
+ *
+ * parameters:
+ * - index: index from index_open
+ * - value: cell value to look up
+ * - count: set to the number of offsets returned
+ *
+ * RETURN: newly allocated array of increasing offsets (possibly empty; free
+ *         with free), NULL on bad input, a damaged bucket or allocation failure
+ */
+size_t *index_lookup(const Index *index, const char *value, size_t *count) {
+    if (index == NULL || value == NULL || count == NULL) return NULL;
+
+    uint64_t hash = hmap_hash(value);
+    uint64_t bucket = hash % index->num_buckets;
+    uint64_t start = index->starts[bucket];
+    uint64_t end = index->starts[bucket + 1];
+    if (start > end || end > index->num_entries) return NULL;
+
+    size_t *offsets = malloc((size_t)(end - start + 1) * sizeof(size_t));
+    if (offsets == NULL) return NULL;
+
+    size_t n = 0;
+    for (uint64_t i = start; i < end; i++) {
+        const IndexEntry *entry = &index->entries[i];
+        if (entry->hash != hash) continue;
+
+        // readers can only move forward through a mapped file
+        if (n > 0 && entry->offset <= offsets[n - 1]) {
+            free(offsets);
+            return NULL;
+        }
+        offsets[n++] = (size_t)entry->offset;
+    }
+
+    *count = n;
+    return offsets;
+}
+
+/*
+ * Unmaps an index.
+ *
+ * parameters:
+ * - index: index to close (safe to pass NULL)
+ */
+void index_close(Index *index) {
+    if (index == NULL) return;
+
+    munmap(index->data, index->size);
+    free(index);
+}
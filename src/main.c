@@ -1,6 +1,29 @@
 /*
  * Main orchestration module for CSVLite.
  * Integrates all modules (csv, cli, select, where, group, sort) to process CSV files.
+ * Queries without GROUP BY/ORDER BY are streamed row by row; the others load
+ * the whole table first, as a Vec of rows or (--columnar) a column-oriented
+ * Table. With --cache, a --file input is always run on a Table, mapped from
+ * the source's cache image when it is current and saved to it otherwise.
+ * A streamed equality WHERE on a column indexed with --build-index seeks to
+ * the matching records instead of reading the whole file, and a streamed
+ * range WHERE on a column with a --build-zonemap zone map skips the blocks
+ * of records that cannot match.
+ * Streamed input (stdin, pipes, gzip-compressed files) is read ahead or
+ * inflated by a separate thread while it is parsed; with --io-uring, a
+ * regular file is streamed with several reads in flight instead of mapped.
+ * With --select, only the columns the query reads are parsed out of the
+ * data rows (projection pushdown), the others are skipped by the parser;
+ * a WHERE is checked on the raw target field of each record, so records
+ * that fail it are never turned into rows (predicate pushdown).
+ * --limit/--offset keep a window of the data rows; a streamed query stops
+ * reading as soon as its last row is written.
+ * With --memory-limit, an ORDER BY without GROUP BY is streamed too: rows
+ * are sorted in runs that fit the budget, spilled to temporary files and
+ * merged into the output (external merge sort, see extsort.c).
+ * Rows and hash maps of a query are allocated from one arena that is freed
+ * at the end in one go (reset after every row when streaming).
+ * Output goes through a buffered Writer on stdout or the --output file.
  *
  * AUTHOR: Billy Wu, Nikhil Ranjith
  * DATE: November 21, 2025
@@ -10,6 +33,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "../include/vec.h"
 #include "../include/row.h"
 #include "../include/csv.h"
@@ -19,6 +44,44 @@
 #include "../include/group.h"
 #include "../include/sort.h"
 #include "../include/hmap.h"
+#include "../include/arena.h"
+#include "../include/writer.h"
+#include "../include/table.h"
+#include "../include/cache.h"
+#include "../include/index.h"
+#include "../include/zonemap.h"
+#include "../include/gzip.h"
+#include "../include/prefetch.h"
+#include "../include/uring.h"
+#include "../include/extsort.h"
+
+/*
+ * Frees a Vec of rows and the rows in it
+ * Rows allocated from the current arena are released with the arena, so
+ * the per-row walk is skipped and only the Vec itself is freed
+ */
+static void free_rows(Vec *rows) {
+    if (rows == NULL) return;
+
+    if (arena_current() == NULL) {
+        for (size_t i = 0; i < vec_length(rows); i++) {
+            row_free(vec_get(rows, i));
+        }
+    }
+    vec_free(rows);
+}
+
+/*
+ * Prints the usage statistics of the query arena to stderr (--stats)
+ */
+static void print_arena_stats(const Arena *arena) {
+    ArenaStats stats;
+    arena_stats(arena, &stats);
+    fprintf(stderr, "Arena: %zu allocations, %zu bytes requested, %zu bytes reserved "
+            "(peak %zu) in %zu blocks, %zu resets\n",
+            stats.num_allocs, stats.bytes_requested, stats.bytes_reserved,
+            stats.peak_reserved, stats.num_blocks, stats.num_resets);
+}
 
 /*
  * Builds a hash map from column names to indices using the header row
@@ -30,7 +93,7 @@
  * RETURNS:
  *  HMap* on success, NULL on failure
  */
-static HMap *build_name_to_index_map(Row *header) {
+static HMap *build_name_to_index_map(const Row *header) {
     if (header == NULL) return NULL;
     
     int num_cols = row_num_cells(header);
@@ -61,7 +124,7 @@ static HMap *build_name_to_index_map(Row *header) {
  * RETURNS:
  *  column index on success, -1 on failure
  */
-static int get_column_index(Row *header, const char *col_name) {
+static int get_column_index(const Row *header, const char *col_name) {
     if (header == NULL || col_name == NULL) return -1;
     
     // check if it's a numeric index
@@ -148,10 +211,7 @@ static Vec* apply_select(Vec* rows, const char* select_cols) {
     }
     
     // free original rows
-    for (size_t i = 0; i < vec_length(rows); i++) {
-        row_free(vec_get(rows, i));
-    }
-    vec_free(rows);
+    free_rows(rows);
     
     return projected;
 }
@@ -161,7 +221,7 @@ static Vec* apply_select(Vec* rows, const char* select_cols) {
  *
  * MEMORY OWNERSHIP:
  * - where_filter() returns a new Vec but reuses Row* pointers from input
- * - only free the original Vec structure
+ * - rows that did not pass are freed here (arena rows go with the arena)
  * - caller must free Row objects from the returned Vec later
  */
 static Vec* apply_where(Vec* rows, const char* where_cond) {
@@ -175,11 +235,63 @@ static Vec* apply_where(Vec* rows, const char* where_cond) {
         return rows;  
     }
 
+    // kept rows appear in filtered in the same order, so one walk finds the rest
+    if (arena_current() == NULL) {
+        size_t kept = 0;
+        for (size_t i = 0; i < vec_length(rows); i++) {
+            Row *row = vec_get(rows, i);
+            if (kept < vec_length(filtered) && vec_get(filtered, kept) == row) {
+                kept++;
+            } else {
+                row_free(row);
+            }
+        }
+    }
+
     // free original Vec structure (Row objects are shared with filtered Vec)
     vec_free(rows);
     return filtered;
 }
 
+/*
+ * Keeps the data rows in the --offset/--limit window (header always kept)
+ *
+ * MEMORY OWNERSHIP:
+ * - returns a new Vec* with the kept Row* pointers (shared)
+ * - frees the input Vec and the rows outside the window (arena rows go
+ *   with the arena)
+ */
+static Vec *apply_limit(Vec *rows, size_t offset, size_t limit) {
+    if (rows == NULL || vec_length(rows) <= 1) {
+        return rows;
+    }
+
+    size_t len = vec_length(rows);
+    if (offset == 0 && limit >= len - 1) {
+        return rows;
+    }
+
+    size_t first = offset < len - 1 ? 1 + offset : len;  // first data row kept
+    size_t count = limit < len - first ? limit : len - first;
+    Vec *window = vec_new(1 + count);
+    if (window == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for --limit\n");
+        return rows;
+    }
+
+    vec_push(window, vec_get(rows, 0));
+    for (size_t i = 1; i < len; i++) {
+        Row *row = vec_get(rows, i);
+        if (i >= first && i < first + count) {
+            vec_push(window, row);
+        } else if (arena_current() == NULL) {
+            row_free(row);
+        }
+    }
+    vec_free(rows);
+    return window;
+}
+
 /*
  * Applies GROUP BY logic to group rows by a column
  *
@@ -219,24 +331,17 @@ static Vec *apply_group(Vec *rows, const char *group_col) {
 }
 
 /*
- * Applies ORDER-BY logic to sort rows by a column
- * Supports format: "col_name:asc" or "col_name:desc" (defaults to asc)
+ * Splits an ORDER BY argument of the form "col_name:asc" or "col_name:desc"
  *
- * MEMORY OWNERSHIP:
- * - returns a new Vec* but reuses Row* pointers from input (shared)
- * - does NOT free the input Vec or Row objects
+ * PARAMETERS:
+ *  order_col - argument to split
+ *  col_name - buffer receiving the column name (truncated to fit)
+ *  name_size - size of col_name
+ *
+ * RETURNS:
+ *  1 for ascending (the default), 0 for descending
  */
-static Vec *apply_sort(Vec *rows, const char *order_col) {
-    if (order_col == NULL || rows == NULL || vec_length(rows) == 0) {
-        return rows;
-    }
-    
-    Row *header = vec_get(rows, 0);
-    if (header == NULL) {
-        return rows;
-    }
-    
-    char col_name[256]; // column name buffer
+static int parse_order_by(const char *order_col, char *col_name, size_t name_size) {
     int is_ascending = 1; // defaults to ascending
     
     // find first occurrence of ':'
@@ -245,10 +350,10 @@ static Vec *apply_sort(Vec *rows, const char *order_col) {
     if (colon_pos != NULL) {
         // split at colon: extract column name (before colon)
         size_t name_len = colon_pos - order_col;
-        if (name_len >= sizeof(col_name)) { // truncate if name is too long
-            name_len = sizeof(col_name) - 1;
+        if (name_len >= name_size) { // truncate if name is too long
+            name_len = name_size - 1;
         }
-        strncpy(col_name, order_col, name_len);
+        memcpy(col_name, order_col, name_len);
         col_name[name_len] = '\0';
         
         // check content after colon
@@ -264,19 +369,102 @@ static Vec *apply_sort(Vec *rows, const char *order_col) {
         // defaults to ascending
     } else {
         // no colon found, use entire string as column name
-        strncpy(col_name, order_col, sizeof(col_name) - 1);
-        col_name[sizeof(col_name) - 1] = '\0';
+        strncpy(col_name, order_col, name_size - 1);
+        col_name[name_size - 1] = '\0';
+    }
+    return is_ascending;
+}
+
+/*
+ * Resolves an ORDER BY argument against the header: a comma-separated list
+ * of "col_name", "col_name:asc" or "col_name:desc" items (see parse_order_by),
+ * sorting by the first column, then by the next among equal rows, and so on
+ *
+ * PARAMETERS:
+ *  header - the header row
+ *  order_by - argument to resolve
+ *  cols - receives the columns (caller frees)
+ *  col_name - buffer receiving the first name not found
+ *  name_size - size of col_name
+ *
+ * RETURNS:
+ *  number of columns, 0 if a column is not found, -1 if allocation failed
+ */
+static int resolve_order_by(const Row *header, const char *order_by, SortColumn **cols,
+                            char *col_name, size_t name_size) {
+    int num_cols = 1;
+    for (const char *p = order_by; *p != '\0'; p++) {
+        if (*p == ',') num_cols++;
+    }
+
+    *cols = malloc((size_t)num_cols * sizeof(SortColumn));
+    if (*cols == NULL) return -1;
+
+    const char *start = order_by;
+    for (int i = 0; i < num_cols; i++) {
+        // copy the item without surrounding spaces/tabs (truncated to fit)
+        size_t len = strcspn(start, ",");
+        const char *next = start + len + (start[len] == ',');
+        while (len > 0 && (*start == ' ' || *start == '\t')) {
+            start++;
+            len--;
+        }
+        while (len > 0 && (start[len - 1] == ' ' || start[len - 1] == '\t')) len--;
+
+        char item[256];
+        if (len >= sizeof(item)) len = sizeof(item) - 1;
+        memcpy(item, start, len);
+        item[len] = '\0';
+
+        (*cols)[i].ascending = parse_order_by(item, col_name, name_size);
+        (*cols)[i].col_index = get_column_index(header, col_name);
+        if ((*cols)[i].col_index < 0) {
+            free(*cols);
+            *cols = NULL;
+            return 0;
+        }
+        start = next;
+    }
+    return num_cols;
+}
+
+/*
+ * Applies ORDER-BY logic to sort rows by one or more columns, with up to
+ * threads threads
+ * Supports format: "col_name:asc" or "col_name:desc" (defaults to asc),
+ * several separated by commas (e.g. "dept:asc,salary:desc,name")
+ *
+ * MEMORY OWNERSHIP:
+ * - returns a new Vec* but reuses Row* pointers from input (shared)
+ * - does NOT free the input Vec or Row objects
+ */
+static Vec *apply_sort(Vec *rows, const char *order_col, int threads) {
+    if (order_col == NULL || rows == NULL || vec_length(rows) == 0) {
+        return rows;
     }
     
-    // convert column name to index
-    int col_index = get_column_index(header, col_name);
-    if (col_index < 0) {
+    Row *header = vec_get(rows, 0);
+    if (header == NULL) {
+        return rows;
+    }
+    
+    char col_name[256]; // column name buffer
+    SortColumn *cols = NULL;
+
+    // convert column names to indices
+    int num_cols = resolve_order_by(header, order_col, &cols, col_name, sizeof(col_name));
+    if (num_cols == 0) {
         fprintf(stderr, "Error: Column '%s' not found for ORDER BY\n", col_name);
         return rows;
     }
+    if (num_cols < 0) {
+        fprintf(stderr, "Error: Failed to allocate memory for sorting\n");
+        return rows;
+    }
     
     size_t len = vec_length(rows); // total number of rows
     if (len <= 1) {
+        free(cols);
         return rows;  // only the header or empty, return early
     }
     
@@ -284,6 +472,7 @@ static Vec *apply_sort(Vec *rows, const char *order_col) {
     Vec *data_rows = vec_new(len - 1);
     if (data_rows == NULL) {
         fprintf(stderr, "Error: Failed to allocate memory for sorting\n");
+        free(cols);
         return rows;
     }
     
@@ -291,13 +480,15 @@ static Vec *apply_sort(Vec *rows, const char *order_col) {
         Row *row = vec_get(rows, i);
         if (row == NULL || vec_push(data_rows, row) != 0) {
             vec_free(data_rows);
+            free(cols);
             return rows;
         }
     }
     
     // sort only the data rows
-    Vec *sorted_data = sort_by_column(data_rows, col_index, is_ascending);
+    Vec *sorted_data = sort_by_columns(data_rows, cols, num_cols, threads);
     vec_free(data_rows);  // free the temporary data_rows vector
+    free(cols);
     
     if (sorted_data == NULL) {
         fprintf(stderr, "Error: ORDER BY failed\n");
@@ -335,14 +526,370 @@ static Vec *apply_sort(Vec *rows, const char *order_col) {
     return result;
 }
 
+// Query arguments pushed down into the CSV reader once the header is known
+typedef struct QueryPushdown {
+    const char *select_cols;  // --select list (NULL writes every column)
+    const char *where_cond;  // --where condition
+    const char *group_by_col;  // --group-by column
+    const char *order_by_col;  // --order-by columns with optional :asc/:desc
+    WhereCond *cond;  // where_cond bound to the header, if valid (caller frees)
+} QueryPushdown;
+
+/*
+ * Marks the columns a query reads, so the parser can skip the others
+ * Without SELECT every column is written, and a column that does not
+ * resolve is left for the query to report, so both parse every column
+ * (returns -1).
+ */
+static int mark_query_columns(const Row *header, unsigned char *keep, const QueryPushdown *query) {
+    if (query->select_cols == NULL) return -1;
+
+    int num_cols = row_num_cells(header);
+    HMap *name_map = build_name_to_index_map(header);
+    int *indices = NULL;
+    int num_indices = 0;
+    int ok = name_map != NULL &&
+             select_parse_indices(query->select_cols, name_map, num_cols, &indices, &num_indices) == 0;
+    hmap_free(name_map);
+    for (int i = 0; ok && i < num_indices; i++) {
+        ok = indices[i] >= 0 && indices[i] < num_cols;
+        if (ok) keep[indices[i]] = 1;
+    }
+    free(indices);
+
+    if (ok && query->where_cond != NULL) {
+        WhereCond *cond = where_compile(header, query->where_cond);
+        ok = cond != NULL;
+        if (ok) keep[where_column(cond)] = 1;
+        where_free(cond);
+    }
+
+    if (ok && query->group_by_col != NULL) {
+        int col_index = get_column_index(header, query->group_by_col);
+        ok = col_index >= 0;
+        if (ok) keep[col_index] = 1;
+    }
+
+    if (ok && query->order_by_col != NULL) {
+        char col_name[256]; // column name buffer
+        SortColumn *cols = NULL;
+        int num_cols = resolve_order_by(header, query->order_by_col, &cols, col_name, sizeof(col_name));
+        ok = num_cols > 0;
+        for (int i = 0; i < num_cols; i++) keep[cols[i].col_index] = 1;
+        free(cols);
+    }
+    return ok ? 0 : -1;
+}
+
+/*
+ * Limits a reader to the columns and rows a query needs once the header is
+ * read (a CsvHeaderFn, see csv_read_pushdown)
+ * A WHERE that does not compile is left for the query to report.
+ */
+static int push_down_query(const Row *header, CsvReader *reader, void *arg) {
+    QueryPushdown *query = arg;
+    int num_cols = row_num_cells(header);
+    unsigned char *keep = calloc((size_t)num_cols, 1);
+    if (keep == NULL) return -1;
+
+    int result = 0;
+    if (mark_query_columns(header, keep, query) == 0) {
+        result = csv_reader_project(reader, keep, num_cols);
+    }
+    free(keep);
+
+    if (result == 0 && query->where_cond != NULL) {
+        query->cond = where_compile(header, query->where_cond);
+        if (query->cond != NULL) result = csv_reader_filter(reader, query->cond);
+    }
+    return result;
+}
+
+/*
+ * Finds the records an equality WHERE can match, using the index of its
+ * column when one exists for the current version of the --file input
+ * Returns NULL (read every row) when the condition or input cannot use an index.
+ */
+static size_t *index_candidates(const WhereCond *cond, const CacheKey *source_id, size_t *count) {
+    int col_index;
+    const char *value;
+    if (source_id == NULL || !where_equality(cond, &col_index, &value)) {
+        return NULL;
+    }
+
+    Index *index = index_open(g_file_path, col_index, source_id);
+    if (index == NULL) {
+        return NULL;
+    }
+
+    size_t *offsets = index_lookup(index, value, count);
+    index_close(index);
+    return offsets;
+}
+
+/*
+ * Opens the zone map of a range WHERE's column when one exists for the
+ * current version of the --file input
+ * Returns NULL (read every row) when the condition or input cannot use one.
+ */
+static ZoneMap *open_zonemap(const WhereCond *cond, const CacheKey *source_id) {
+    int col_index;
+    if (source_id == NULL || !where_ordering(cond, &col_index)) {
+        return NULL;
+    }
+    return zonemap_open(g_file_path, col_index, source_id);
+}
+
+/*
+ * Checks whether the condition may hold for a row of a zone map block
+ */
+static int zone_may_match(const WhereCond *cond, const ZoneBlock *block) {
+    return where_may_match_range(cond, block->min_value, block->max_value, block->num_empty > 0);
+}
+
+// Data rows of a result still to skip (--offset) and to write (--limit)
+typedef struct RowWindow {
+    size_t skip;  // rows left to skip
+    size_t left;  // rows left to write (SIZE_MAX without --limit)
+} RowWindow;
+
+// Where stream_csv sends its rows
+typedef struct RowSink {
+    Writer *out;
+    const int *indices;  // SELECT columns (NULL writes every column)
+    int num_indices;
+    RowWindow window;
+    ExtSort *sorter;  // ORDER BY rows are sorted here before written (or NULL)
+    int sort_col;  // highest ORDER BY column
+    int first_row;  // 1 until a row is taken
+} RowSink;
+
+/*
+ * Writes a result row unless the --offset part of the window still skips it
+ * Returns nonzero once the window is complete (an ExtSortFn).
+ */
+static int emit_row(const Row *row, void *arg) {
+    RowSink *sink = arg;
+    if (sink->window.skip > 0) {
+        sink->window.skip--;
+    } else {
+        csv_write_row_to(sink->out, row, sink->indices, sink->num_indices);
+        sink->window.left--;
+    }
+    return sink->window.left == 0;
+}
+
+/*
+ * Passes a row that matched the query on: to the sorter with ORDER BY,
+ * otherwise straight to emit_row
+ * As apply_sort, ORDER BY fails when the first row lacks a sort column,
+ * and the rows are then written unsorted.
+ */
+static int take_row(RowSink *sink, const Row *row) {
+    if (sink->sorter != NULL && sink->first_row && row_num_cells(row) <= sink->sort_col) {
+        fprintf(stderr, "Error: ORDER BY failed\n");
+        extsort_free(sink->sorter);
+        sink->sorter = NULL;
+    }
+    sink->first_row = 0;
+
+    if (sink->sorter == NULL) {
+        emit_row(row, sink);
+        return 0;
+    }
+    return extsort_add(sink->sorter, row);
+}
+
+/*
+ * Streams CSV rows from reader to out one at a time
+ * Used when there is no GROUP BY or ORDER BY, so memory use does not grow
+ * with the input: each row is filtered, projected and written as it is read.
+ * The arena (if any) is reset after every row, since no row outlives its turn.
+ *
+ * Also used for an ORDER BY (without GROUP BY) under --memory-limit: the
+ * matching rows go to an external sorter (extsort.h) that keeps at most
+ * memory_limit bytes of them in memory, spilling sorted runs to temporary
+ * files, and the merged runs are written at the end.
+ *
+ * With source_id (mapped --file input only), an indexed equality WHERE
+ * seeks to the candidate records and rechecks just those, and a range WHERE
+ * with a zone map reads only the runs of blocks it does not rule out.
+ * Reading stops once the window (--offset/--limit) is complete.
+ *
+ * Operation order per row: WHERE, then (sort, then) SELECT, then write.
+ */
+static int stream_csv(CsvReader *reader, Writer *out, Arena *arena, const char *select_cols,
+                      const char *where_cond, const char *order_by_col, size_t memory_limit, int threads,
+                      const CacheKey *source_id, RowWindow window) {
+    Row *header = csv_reader_next(reader);
+    if (header == NULL) {
+        if (csv_reader_failed(reader)) {
+            fprintf(stderr, "Error: Failed to read CSV\n");
+        } else {
+            fprintf(stderr, "Error: CSV file is empty\n");
+        }
+        return 1;
+    }
+
+    // bind WHERE condition to the header (rows stay unfiltered if it is invalid)
+    WhereCond *cond = NULL;
+    if (where_cond != NULL) {
+        cond = where_compile(header, where_cond);
+        if (cond == NULL) {
+            fprintf(stderr, "Error: WHERE filtering failed\n");
+        }
+    }
+
+    // resolve SELECT columns against the header
+    int *indices = NULL; // NULL writes every header column
+    int num_indices = row_num_cells(header);
+    if (select_cols != NULL) {
+        if (csv_validate_columns(header, select_cols) != 0) {
+            fprintf(stderr, "Error: Invalid column selection\n");
+            where_free(cond);
+            row_free(header);
+            return 1;
+        }
+
+        HMap *name_map = build_name_to_index_map(header);
+        if (name_map == NULL ||
+            select_parse_indices(select_cols, name_map, num_indices, &indices, &num_indices) != 0) {
+            fprintf(stderr, "Error: Failed to parse column selection\n");
+            hmap_free(name_map);
+            where_free(cond);
+            row_free(header);
+            return 1;
+        }
+        hmap_free(name_map);
+    }
+
+    RowSink sink = { out, indices, num_indices, window, NULL, -1, 1 };
+
+    // ORDER BY columns (rows stay unsorted if one is not found, as in apply_sort);
+    // the sorter is set up before any output, so a bad $TMPDIR writes nothing
+    if (order_by_col != NULL) {
+        char col_name[256]; // column name buffer
+        SortColumn *cols = NULL;
+        int num_cols = resolve_order_by(header, order_by_col, &cols, col_name, sizeof(col_name));
+        for (int i = 0; i < num_cols; i++) {
+            if (cols[i].col_index > sink.sort_col) sink.sort_col = cols[i].col_index;
+        }
+        if (num_cols == 0) {
+            fprintf(stderr, "Error: Column '%s' not found for ORDER BY\n", col_name);
+        } else if (num_cols < 0 || (sink.sorter = extsort_new(cols, num_cols, memory_limit, threads)) == NULL) {
+            fprintf(stderr, "Error: Failed to set up sorting (temporary files go to $TMPDIR or /tmp)\n");
+            free(cols);
+            free(indices);
+            where_free(cond);
+            row_free(header);
+            return 1;
+        }
+        free(cols);
+    }
+
+    csv_write_row_to(out, header, indices, num_indices);
+
+    // later rows only need the selected, filtered and sorted columns
+    QueryPushdown query = { select_cols, where_cond, NULL, order_by_col, NULL };
+    unsigned char *keep = calloc((size_t)row_num_cells(header), 1);
+    if (keep != NULL && mark_query_columns(header, keep, &query) == 0) {
+        csv_reader_project(reader, keep, row_num_cells(header)); // parses all if it fails
+    }
+    free(keep);
+    row_free(header); // header cells are invalidated by the next read anyway
+
+    Row *row;
+    ZoneMap *zones;
+    int result = 0;
+    size_t num_candidates = 0;
+    size_t *candidates = index_candidates(cond, source_id, &num_candidates);
+    if (candidates != NULL) {
+        // candidates only share a hash with the value, so each is rechecked
+        for (size_t i = 0; i < num_candidates && sink.window.left > 0 && result == 0; i++) {
+            if (csv_reader_seek(reader, candidates[i]) != 0 || (row = csv_reader_next(reader)) == NULL) {
+                break;
+            }
+            if (where_match(cond, row)) {
+                result = take_row(&sink, row);
+            }
+            row_free(row);
+            arena_reset(arena);
+        }
+        free(candidates);
+    } else if ((zones = open_zonemap(cond, source_id)) != NULL) {
+        size_t num_blocks = zonemap_num_blocks(zones);
+        size_t i = 0;
+        while (i < num_blocks && sink.window.left > 0 && result == 0) {
+            // find the next run of blocks that may match, seek past the others
+            while (i < num_blocks && !zone_may_match(cond, zonemap_block(zones, i))) i++;
+            if (i == num_blocks) break;
+            size_t run_start = zonemap_block(zones, i)->start;
+            while (i < num_blocks && zone_may_match(cond, zonemap_block(zones, i))) i++;
+            size_t run_end = zonemap_block(zones, i - 1)->end;
+
+            if (csv_reader_seek(reader, run_start) != 0) break;
+            while (sink.window.left > 0 && result == 0 && (row = csv_reader_next(reader)) != NULL) {
+                // the first record past the run belongs to a skipped block
+                int in_run = csv_reader_offset(reader) < run_end;
+                if (in_run && where_match(cond, row)) {
+                    result = take_row(&sink, row);
+                }
+                row_free(row);
+                arena_reset(arena);
+                if (!in_run) break;
+            }
+        }
+        zonemap_close(zones);
+    } else {
+        // the reader skips records failing the condition before tokenizing them
+        csv_reader_filter(reader, cond);
+        while (sink.window.left > 0 && result == 0 && (row = csv_reader_next(reader)) != NULL) {
+            result = take_row(&sink, row);
+            row_free(row);
+            arena_reset(arena);
+        }
+    }
+
+    if (result != 0) {
+        fprintf(stderr, "Error: ORDER BY failed\n");
+        result = 1;
+    } else if (csv_reader_failed(reader)) {
+        fprintf(stderr, "Error: Failed to read CSV\n");
+        result = 1;
+    } else if (sink.sorter != NULL && extsort_finish(sink.sorter, emit_row, &sink) != 0) {
+        fprintf(stderr, "Error: ORDER BY failed\n");
+        result = 1;
+    }
+
+    extsort_free(sink.sorter);
+
+    free(indices);
+    where_free(cond);
+    return result;
+}
+
 /*
  * Processes CSV file
+ * Reads from the mapped file when map is given (with up to threads parse
+ * threads), otherwise from input, and writes the result to out. ORDER BY
+ * also sorts with up to threads threads. Data rows
+ * only hold the columns the query reads, and rows failing a valid WHERE
+ * are dropped while reading (see push_down_query).
  * 
- * Operation order: reads, WHERE, GROUP BY, ORDER BY, and SELECT, then writes output.
+ * Operation order: reads, WHERE, GROUP BY, ORDER BY, --offset/--limit and
+ * SELECT, then writes output.
  */
-static int process_csv(FILE* input, const char* select_cols, const char* where_cond,
-                       const char *group_by_col, const char *order_by_col) {
-    Vec* rows = csv_read(input);
+static int process_csv(FILE* input, CsvMap *map, int threads, Writer *out, const char* select_cols,
+                       const char* where_cond, const char *group_by_col, const char *order_by_col,
+                       RowWindow window) {
+    QueryPushdown query = { select_cols, where_cond, group_by_col, order_by_col, NULL };
+    Vec* rows = map != NULL ? csv_read_mapped_pushdown(map, threads, push_down_query, &query)
+                            : csv_read_pushdown(input, push_down_query, &query);
+
+    // the reader already applied a valid WHERE
+    if (query.cond != NULL) where_cond = NULL;
+    where_free(query.cond);
+
     if (rows == NULL) {
         fprintf(stderr, "Error: Failed to read CSV\n");
         return 1;
@@ -369,12 +916,15 @@ static int process_csv(FILE* input, const char* select_cols, const char* where_c
     }
 
     // apply ORDER BY
-    rows = apply_sort(rows, order_by_col);
+    rows = apply_sort(rows, order_by_col, threads);
     if (rows == NULL) {
         fprintf(stderr, "Error: ORDER BY failed\n");
         return 1;
     }
 
+    // keep the --offset/--limit window of the ordered rows
+    rows = apply_limit(rows, window.skip, window.left);
+
     // validate SELECT columns (if provided)
     if (select_cols != NULL) {
         Row* header = vec_get(rows, 0);
@@ -382,19 +932,13 @@ static int process_csv(FILE* input, const char* select_cols, const char* where_c
         // free rows if header is NULL
         if (header == NULL) {
             fprintf(stderr, "Error: No header row found\n");
-            for (size_t i = 0; i < vec_length(rows); i++) {
-                row_free(vec_get(rows, i));
-            }
-            vec_free(rows);
+            free_rows(rows);
             return 1;
         }
 
         if (csv_validate_columns(header, select_cols) != 0) {
             fprintf(stderr, "Error: Invalid column selection\n");
-            for (size_t i = 0; i < vec_length(rows); ++i) {
-                row_free(vec_get(rows, i));
-            }
-            vec_free(rows);
+            free_rows(rows);
             return 1;
         }
     }
@@ -408,25 +952,191 @@ static int process_csv(FILE* input, const char* select_cols, const char* where_c
 
     // write output CSV
     // after SELECT projection, rows already contain only selected columns,
-    // so pass NULL to csv_write to write all columns from projected rows
-    if (csv_write(stdout, rows, NULL) != 0) {
+    // so pass NULL to csv_write_to to write all columns from projected rows
+    if (csv_write_to(out, rows, NULL) != 0) {
 
         // write failed
         fprintf(stderr, "Error: Failed to write output\n");
+        free_rows(rows);
+        return 1;
+    }
 
-        for (size_t i = 0; i < vec_length(rows); ++i) {
-            row_free(vec_get(rows, i));
+    // cleanup (arena rows are released with the arena)
+    free_rows(rows);
+
+    return 0;
+}
+
+/*
+ * Builds an index (--build-index) or zone map (--build-zonemap) of one
+ * column of the --file input with the given builder
+ * The file is only written for a regular file whose identity (source_id)
+ * was taken before it was mapped.
+ */
+static int build_sidecar(CsvMap *map, const CacheKey *source_id, const char *flag, const char *col_name,
+                         const char *what,
+                         int (*build)(CsvReader *, int, const char *, const CacheKey *)) {
+    if (map == NULL || source_id == NULL) {
+        fprintf(stderr, "Error: %s requires a regular --file input\n", flag);
+        return 1;
+    }
+
+    CsvReader *reader = csv_reader_open_mapped(map);
+    Row *header = reader != NULL ? csv_reader_next(reader) : NULL;
+    if (header == NULL) {
+        if (reader == NULL || csv_reader_failed(reader)) {
+            fprintf(stderr, "Error: Failed to read CSV\n");
+        } else {
+            fprintf(stderr, "Error: CSV file is empty\n");
         }
-        vec_free(rows);
+        csv_reader_close(reader);
         return 1;
     }
 
-    // cleanup
-    for (size_t i = 0; i < vec_length(rows); ++i) {
-        row_free(vec_get(rows, i));
+    int col_index = get_column_index(header, col_name);
+    row_free(header);
+    if (col_index < 0) {
+        fprintf(stderr, "Error: Column '%s' not found for %s\n", col_name, flag);
+        csv_reader_close(reader);
+        return 1;
     }
-    vec_free(rows);
 
+    int result = 0;
+    if (build(reader, col_index, g_file_path, source_id) != 0) {
+        fprintf(stderr, "Error: Failed to write %s for %s\n", what, g_file_path);
+        result = 1;
+    }
+    csv_reader_close(reader);
+    return result;
+}
+
+/*
+ * Checks whether the --output file is the input file
+ * Opening the output truncates it, which would wipe the input before it is
+ * read (and fault on a mapped input), so such a run must be refused.
+ * A missing output file is never the input.
+ */
+static int output_is_input(const char *output_path, const char *input_path) {
+    struct stat out_st, in_st;
+    if (stat(output_path, &out_st) != 0) return 0;
+
+    int in_ok = input_path != NULL ? stat(input_path, &in_st) == 0 : fstat(STDIN_FILENO, &in_st) == 0;
+    return in_ok && out_st.st_dev == in_st.st_dev && out_st.st_ino == in_st.st_ino;
+}
+
+/*
+ * Loads the input into a Table
+ * Uses the cache image when one is given; otherwise parses the input and,
+ * with a cache key, saves the parsed table as the source's new image (a
+ * failed save only costs the next run a parse).
+ */
+static Table *load_table(FILE *input, CsvMap *map, const CacheImage *cache, const CacheKey *key) {
+    if (cache != NULL) {
+        return cache_table(cache);
+    }
+
+    Table *table = map != NULL ? csv_read_mapped_table(map) : csv_read_table(input);
+    if (table != NULL && key != NULL && cache_save(g_file_path, key, table) != 0) {
+        fprintf(stderr, "Warning: Cannot write cache file %s%s\n", g_file_path, CACHE_SUFFIX);
+    }
+    return table;
+}
+
+/*
+ * Processes a loaded Table with the column-oriented engine (--columnar, --cache)
+ * Same operation order and error handling as process_csv, but every operator
+ * scans columns and narrows, sorts or projects the table in place instead of
+ * building new Vecs. ORDER BY sorts with up to threads threads. Takes
+ * ownership of table (NULL if loading failed).
+ */
+static int process_table(Table *table, int threads, Writer *out, const char* select_cols,
+                         const char* where_cond, const char *group_by_col, const char *order_by_col,
+                         RowWindow window) {
+    if (table == NULL) {
+        fprintf(stderr, "Error: Failed to read CSV\n");
+        return 1;
+    }
+
+    if (table_num_rows(table) == 0) {
+        fprintf(stderr, "Error: CSV file is empty\n");
+        table_free(table);
+        return 1;
+    }
+
+    // column names are resolved against a copy of the header row
+    Row *header = table_get_row(table, 0);
+    if (header == NULL) {
+        fprintf(stderr, "Error: No header row found\n");
+        table_free(table);
+        return 1;
+    }
+
+    // apply WHERE condition (rows stay unfiltered if it fails)
+    if (where_cond != NULL && where_filter_table(table, where_cond) != 0) {
+        fprintf(stderr, "Error: WHERE filtering failed\n");
+    }
+
+    // apply GROUP BY
+    if (group_by_col != NULL) {
+        int col_index = get_column_index(header, group_by_col);
+        if (col_index < 0) {
+            fprintf(stderr, "Error: Column '%s' not found for GROUP BY\n", group_by_col);
+        } else if (group_table_by_column(table, col_index) != 0) {
+            fprintf(stderr, "Error: GROUP BY failed\n");
+        }
+    }
+
+    // apply ORDER BY
+    if (order_by_col != NULL) {
+        char col_name[256]; // column name buffer
+        SortColumn *cols = NULL;
+        int num_cols = resolve_order_by(header, order_by_col, &cols, col_name, sizeof(col_name));
+        if (num_cols == 0) {
+            fprintf(stderr, "Error: Column '%s' not found for ORDER BY\n", col_name);
+        } else if (num_cols < 0 || sort_table_by_columns(table, cols, num_cols, threads) != 0) {
+            fprintf(stderr, "Error: ORDER BY failed\n");
+        }
+        free(cols);
+    }
+
+    // keep the --offset/--limit window: move it up behind the header
+    size_t num_data = table_num_rows(table) - 1;
+    size_t skip = window.skip < num_data ? window.skip : num_data;
+    size_t count = window.left < num_data - skip ? window.left : num_data - skip;
+    size_t *records = table_rows(table);
+    memmove(records + 1, records + 1 + skip, count * sizeof(size_t));
+    table_set_num_rows(table, 1 + count);
+
+    // validate and apply SELECT
+    if (select_cols != NULL) {
+        if (csv_validate_columns(header, select_cols) != 0) {
+            fprintf(stderr, "Error: Invalid column selection\n");
+            row_free(header);
+            table_free(table);
+            return 1;
+        }
+
+        HMap *name_map = build_name_to_index_map(header);
+        int *indices = NULL;
+        int num_indices = 0;
+        if (name_map == NULL ||
+            select_parse_indices(select_cols, name_map, row_num_cells(header), &indices, &num_indices) != 0 ||
+            select_project_table(table, indices, num_indices) != 0) {
+            fprintf(stderr, "Error: Failed to parse column selection\n");
+        }
+        hmap_free(name_map);
+        free(indices);
+    }
+    row_free(header);
+
+    // write output CSV
+    if (csv_write_table(out, table) != 0) {
+        fprintf(stderr, "Error: Failed to write output\n");
+        table_free(table);
+        return 1;
+    }
+
+    table_free(table);
     return 0;
 }
 
@@ -439,23 +1149,142 @@ int main(int argc, char* argv[]) {
         return (parse_result == -1) ? 0 : 1;
     }
 
+    // --output must not truncate the file the query reads
+    if (g_output_path != NULL && (g_use_stdin || g_file_path != NULL) &&
+        output_is_input(g_output_path, g_use_stdin ? NULL : g_file_path)) {
+        fprintf(stderr, "Error: Output file %s is the input file\n", g_output_path);
+        cli_cleanup();
+        return 1;
+    }
+
     FILE* input = stdin;
+    CsvMap *map = NULL;
+    CacheImage *cache = NULL;
+    CacheKey source_id;
+    int have_source_id = 0;
+    int cacheable = 0;
+    int read_ahead = 0;  // input is already read ahead (gzip, io_uring)
 
     if (!g_use_stdin) {
         if (g_file_path == NULL) {
             fprintf(stderr, "Error: No input file specified\n");
             return 1;
         }
-        input = fopen(g_file_path, "r");
-        if (input == NULL) {
-            fprintf(stderr, "Error: Cannot open file %s\n", g_file_path);
-            return 1;
+
+        // the key is taken before the source is read, so a cache image or
+        // index of newer contents is never saved under it
+        have_source_id = cache_key(g_file_path, &source_id) == 0;
+        if (g_cache && have_source_id && g_build_index_col == NULL && g_build_zonemap_col == NULL) {
+            cacheable = 1;
+            cache = cache_open(g_file_path, &source_id);
+        }
+
+        // regular files are mapped (or read through io_uring when asked and
+        // available), anything else (pipes, devices, gzip files) is streamed
+        // (a current cache image replaces the source entirely)
+        input = NULL;
+        int compressed = cache == NULL && gzip_detect(g_file_path);
+        int sidecar = g_build_index_col != NULL || g_build_zonemap_col != NULL;
+        if (cache == NULL && !compressed && g_io_uring && !sidecar) {
+            input = uring_open(g_file_path);
+        }
+        if (cache == NULL && !compressed && input == NULL) {
+            map = csv_map_open(g_file_path);
+        }
+        read_ahead = compressed || input != NULL;
+        if (cache == NULL && map == NULL && input == NULL) {
+            input = compressed ? gzip_open(g_file_path) : fopen(g_file_path, "r");
+            if (input == NULL) {
+                fprintf(stderr, "Error: Cannot open file %s\n", g_file_path);
+                return 1;
+            }
         }
     }
 
-    int result = process_csv(input, g_select_cols, g_where_cond, g_group_by_col, g_order_by_col);
+    // --build-index and --build-zonemap only write their files
+    if (g_build_index_col != NULL || g_build_zonemap_col != NULL) {
+        const CacheKey *key = have_source_id ? &source_id : NULL;
+        int result = 0;
+        if (g_build_index_col != NULL) {
+            result = build_sidecar(map, key, "--build-index", g_build_index_col, "index", index_build);
+        }
+        if (result == 0 && g_build_zonemap_col != NULL) {
+            result = build_sidecar(map, key, "--build-zonemap", g_build_zonemap_col, "zone map", zonemap_build);
+        }
+        csv_map_close(map);
+        if (input != NULL && input != stdin) fclose(input);
+        cli_cleanup();
+        return result;
+    }
+
+    // stdin, pipes and devices are filled into one buffer by a separate thread
+    // while the parser works on the other (gzip streams are read ahead already)
+    if (input != NULL && !read_ahead) {
+        FILE *ahead = prefetch_stream(input, input != stdin);
+        if (ahead != NULL) input = ahead;
+    }
+
+    // result destination (stdout unless --output is given)
+    Writer *out = g_output_path != NULL ? writer_open_path(g_output_path) : writer_open_fd(STDOUT_FILENO, 0);
+    if (out == NULL) {
+        if (g_output_path != NULL) {
+            fprintf(stderr, "Error: Cannot open output file %s\n", g_output_path);
+        } else {
+            fprintf(stderr, "Error: Failed to allocate output buffer\n");
+        }
+        cache_close(cache);
+        csv_map_close(map);
+        if (input != NULL && input != stdin) fclose(input);
+        return 1;
+    }
+
+    // query-lifetime allocations (plain malloc if the arena cannot be created)
+    Arena *arena = arena_new(0);
+    arena_set_current(arena);
+
+    // data rows to skip and to write (--offset/--limit)
+    RowWindow window = { (size_t)g_offset, g_limit < 0 ? SIZE_MAX : (size_t)g_limit };
+
+    int result;
+    if (cacheable) {
+        // cached or not, the query runs on the Table the image holds
+        Table *table = load_table(input, map, cache, &source_id);
+        result = process_table(table, g_threads, out, g_select_cols, g_where_cond, g_group_by_col, g_order_by_col, window);
+    } else if (g_group_by_col == NULL && (g_order_by_col == NULL || g_memory_limit > 0)) {
+        // nothing needs the whole table in memory, stream rows through
+        // (an ORDER BY under --memory-limit spills sorted runs to disk)
+        CsvReader *reader = map != NULL ? csv_reader_open_mapped(map) : csv_reader_open(input);
+        if (reader == NULL) {
+            fprintf(stderr, "Error: Failed to read CSV\n");
+            result = 1;
+        } else {
+            result = stream_csv(reader, out, arena, g_select_cols, g_where_cond, g_order_by_col, g_memory_limit,
+                                g_threads, map != NULL && have_source_id ? &source_id : NULL, window);
+            csv_reader_close(reader);
+        }
+    } else {
+        result = g_columnar
+            ? process_table(load_table(input, map, NULL, NULL), g_threads, out, g_select_cols, g_where_cond,
+                            g_group_by_col, g_order_by_col, window)
+            : process_csv(input, map, g_threads, out, g_select_cols, g_where_cond, g_group_by_col, g_order_by_col,
+                          window);
+    }
+
+    // a failed write is only reported once, after the last flush
+    if (writer_close(out) != 0 && result == 0) {
+        fprintf(stderr, "Error: Failed to write output\n");
+        result = 1;
+    }
+
+    if (g_stats) print_arena_stats(arena);
+    arena_set_current(NULL);
+    arena_free(arena);
 
-    if (!g_use_stdin && input != NULL) {
+    // rows pointing into the mapping are released with the arena above
+    // (and tables over the cache image were freed by process_table)
+    cache_close(cache);
+    csv_map_close(map);
+    if (input != NULL && input != stdin) {
         fclose(input);
     }
 
@@ -0,0 +1,281 @@
+/*
+ * Provides read-ahead input streams.
+ * A separate thread fills a bounded queue of buffers from a source (a plain
+ * stream such as stdin or a pipe, or a gzip inflater, see gzip.c), and the
+ * parser drains the queue through an ordinary FILE* (a glibc cookie
+ * stream). Waiting on the producer of a pipeline, or inflating, thus
+ * overlaps with parsing, and the queue bounds how far the reader thread
+ * can run ahead. Every reader that takes a FILE* works unchanged.
+ * The thread is detached: closing the stream only asks it to stop, and
+ * whichever side finishes last frees the shared state, so closing never
+ * waits on a source that blocks (an idle pipe).
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _GNU_SOURCE  // fopencookie
+
+#include "../include/prefetch.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+// One queued buffer
+typedef struct PrefetchSlot {
+    char *data;  // buffer_size bytes
+    size_t len;  // number of valid bytes
+} PrefetchSlot;
+
+// State shared by the reader thread and the stream
+typedef struct Prefetch {
+    PrefetchFill fill;  // reads the source
+    PrefetchRelease release;  // frees the source (may be NULL)
+    void *source;  // source handed to fill and release
+    size_t buffer_size;  // bytes per slot
+    int depth;  // number of slots
+    PrefetchSlot *slots;  // ring of buffers
+    pthread_mutex_t lock;  // guards everything below
+    pthread_cond_t filled;  // a slot was queued or the thread stopped
+    pthread_cond_t drained;  // a slot was handed back or the stream closed
+    size_t head;  // first queued slot (owned by the stream while queued)
+    size_t count;  // number of queued slots
+    size_t pos;  // bytes of the head slot already read (stream side only)
+    int done;  // 1 once the thread queued its last slot
+    int failed;  // 1 if a fill failed
+    int closing;  // 1 once the stream is closed
+    int refs;  // thread and stream still using this state
+} Prefetch;
+
+/*
+ * Internal helper: frees the state and releases the source.
+ */
+static void free_prefetch(Prefetch *p) {
+    if (p->release != NULL) p->release(p->source);
+    if (p->slots != NULL) {
+        for (int i = 0; i < p->depth; i++) free(p->slots[i].data);
+    }
+    free(p->slots);
+    pthread_cond_destroy(&p->drained);
+    pthread_cond_destroy(&p->filled);
+    pthread_mutex_destroy(&p->lock);
+    free(p);
+}
+
+/*
+ * Internal helper: drops one reference, freeing the state with the last.
+ * The caller holds the lock, which this releases.
+ */
+static void unref_unlock(Prefetch *p) {
+    int last = --p->refs == 0;
+    pthread_mutex_unlock(&p->lock);
+    if (last) free_prefetch(p);
+}
+
+/*
+ * Internal helper: reader thread. Fills free slots until the source ends,
+ * fails, or the stream is closed.
+ *
+ * RETURN: NULL (pthread start routine)
+ */
+static void *prefetch_main(void *arg) {
+    Prefetch *p = arg;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (p->count == (size_t)p->depth && !p->closing) {
+            pthread_cond_wait(&p->drained, &p->lock);
+        }
+        if (p->closing) break;
+
+        // the free slot is not seen by the stream until it is queued
+        PrefetchSlot *slot = &p->slots[(p->head + p->count) % (size_t)p->depth];
+        pthread_mutex_unlock(&p->lock);
+        long n = p->fill(p->source, slot->data, p->buffer_size);
+        pthread_mutex_lock(&p->lock);
+
+        if (n > 0) {
+            slot->len = (size_t)n;
+            p->count++;
+        } else {
+            p->done = 1;
+            p->failed = n < 0;
+        }
+        pthread_cond_broadcast(&p->filled);
+        if (p->done) break;
+    }
+    unref_unlock(p);
+    return NULL;
+}
+
+/*
+ * Internal helper: cookie read function. Copies queued bytes into buf,
+ * waiting for the reader thread when the queue is empty.
+ *
+ * RETURN: bytes copied (0 at end of input), -1 if a fill failed
+ */
+static ssize_t prefetch_read(void *cookie, char *buf, size_t size) {
+    Prefetch *p = cookie;
+    size_t total = 0;
+
+    while (total < size) {
+        pthread_mutex_lock(&p->lock);
+        while (p->count == 0 && !p->done) {
+            pthread_cond_wait(&p->filled, &p->lock);
+        }
+        int empty = p->count == 0;
+        int failed = p->failed;
+        pthread_mutex_unlock(&p->lock);
+
+        if (empty) {
+            // report a failure once the bytes before it are delivered
+            if (failed && total == 0) return -1;
+            break;
+        }
+
+        // the head slot is not touched by the thread while it is queued
+        PrefetchSlot *slot = &p->slots[p->head];
+        size_t n = slot->len - p->pos;
+        if (n > size - total) n = size - total;
+        memcpy(buf + total, slot->data + p->pos, n);
+        p->pos += n;
+        total += n;
+
+        if (p->pos == slot->len) {
+            pthread_mutex_lock(&p->lock);
+            p->head = (p->head + 1) % (size_t)p->depth;
+            p->count--;
+            p->pos = 0;
+            pthread_cond_signal(&p->drained);
+            pthread_mutex_unlock(&p->lock);
+        }
+    }
+    return (ssize_t)total;
+}
+
+/*
+ * Internal helper: cookie close function. Asks the reader thread to stop;
+ * the state goes with whichever of the two lets go last.
+ *
+ * RETURN: 0
+ */
+static int prefetch_close(void *cookie) {
+    Prefetch *p = cookie;
+
+    pthread_mutex_lock(&p->lock);
+    p->closing = 1;
+    pthread_cond_broadcast(&p->drained);
+    unref_unlock(p);
+    return 0;
+}
+
+/*
+ * Opens a stream read ahead from a source by a separate thread.
+ *
+ * parameters:
+ * - fill: reads the next bytes of the source
+ * - release: frees the source after the last fill (may be NULL)
+ * - source: passed to fill and release
+ * - buffer_size: bytes per queued buffer
+ * - depth: number of buffers (at least 2, so one fills while one is read)
+ *
+ * RETURN: FILE* to read and fclose, NULL on bad input or allocation or
+ *         thread start failure (the source is then left to the caller)
+ */
+FILE *prefetch_open(PrefetchFill fill, PrefetchRelease release, void *source, size_t buffer_size, int depth) {
+    if (fill == NULL || buffer_size == 0 || depth < 2) return NULL;
+
+    Prefetch *p = calloc(1, sizeof(Prefetch));
+    if (p == NULL) return NULL;
+
+    p->fill = fill;
+    p->source = source;
+    p->buffer_size = buffer_size;
+    p->depth = depth;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->filled, NULL);
+    pthread_cond_init(&p->drained, NULL);
+
+    int ok = (p->slots = calloc((size_t)depth, sizeof(PrefetchSlot))) != NULL;
+    for (int i = 0; ok && i < depth; i++) {
+        ok = (p->slots[i].data = malloc(buffer_size)) != NULL;
+    }
+
+    cookie_io_functions_t io = { .read = prefetch_read, .write = NULL, .seek = NULL, .close = prefetch_close };
+    FILE *stream = ok ? fopencookie(p, "r", io) : NULL;
+    if (stream == NULL) {
+        free_prefetch(p);
+        return NULL;
+    }
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    p->refs = 2;
+    ok = pthread_attr_init(&attr) == 0;
+    if (ok) {
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        ok = pthread_create(&thread, &attr, prefetch_main, p) == 0;
+        pthread_attr_destroy(&attr);
+    }
+    if (!ok) {
+        // without a thread the stream holds the only reference
+        p->refs = 1;
+        fclose(stream);
+        return NULL;
+    }
+
+    // the source belongs to the thread from now on
+    p->release = release;
+    return stream;
+}
+
+// Source of a read-ahead stream over a FILE*
+typedef struct StreamSource {
+    FILE *file;  // stream to read
+    int close_file;  // 1 to fclose file on release
+} StreamSource;
+
+/*
+ * Internal helper: fill callback over a FILE*.
+ */
+static long stream_fill(void *source, char *buf, size_t cap) {
+    StreamSource *s = source;
+    size_t n = fread(buf, 1, cap, s->file);
+    if (n == 0 && ferror(s->file)) return -1;
+    return (long)n;
+}
+
+/*
+ * Internal helper: release callback over a FILE*.
+ */
+static void stream_release(void *source) {
+    StreamSource *s = source;
+    if (s->close_file) fclose(s->file);
+    free(s);
+}
+
+/*
+ * Opens a double-buffered read-ahead stream over a FILE*: one buffer is
+ * filled from the source while the parser reads the other.
+ *
+ * parameters:
+ * - source: stream to read (stdin, a pipe or a device)
+ * - close_source: nonzero to fclose source with the returned stream
+ *
+ * RETURN: FILE* to read and fclose, NULL on bad input or failure (source
+ *         is then left open)
+ */
+FILE *prefetch_stream(FILE *source, int close_source) {
+    if (source == NULL) return NULL;
+
+    StreamSource *s = malloc(sizeof(StreamSource));
+    if (s == NULL) return NULL;
+    s->file = source;
+    s->close_file = close_source;
+
+    FILE *stream = prefetch_open(stream_fill, stream_release, s, PREFETCH_STREAM_BUFFER_SIZE, PREFETCH_STREAM_DEPTH);
+    if (stream == NULL) free(s);
+    return stream;
+}
@@ -1,6 +1,14 @@
 /*
  * Provides a structure to store a single CSV row with multiple cells.
- * Each cell value is stored as a dynamically allocated string.
+ * A row is one allocation: a small header, a table with one 32-bit offset
+ * per cell, and the cell bytes themselves, stored back to back. View rows
+ * keep the same offset table but point it at a buffer owned elsewhere
+ * (e.g. a memory-mapped input file) instead of copying the bytes.
+ * Cells changed after construction are appended to a separate overflow
+ * buffer that is only allocated on the first row_set_cell().
+ * When the calling thread has a current arena (see arena.h), rows and their
+ * overflow buffers are allocated from it and row_free() leaves them to be
+ * released with the arena.
  *
  * AUTHOR: Billy
  * DATE: November 11, 2025
@@ -8,16 +16,64 @@
  */
 
 #include "../include/row.h"
+#include "../include/arena.h"
 #include <stdlib.h>
 #include <string.h>
 
-// Row structure: stores array of cell values (strings)
+// Offset marking a NULL cell
+#define ROW_NULL_CELL UINT32_MAX
+
+// Offset flag: the cell lives in the overflow buffer, not at base
+#define ROW_HEAP_BIT 0x80000000u
+
+// Row flags: memory owned by an arena instead of malloc
+#define ROW_IN_ARENA 1u  // the row allocation itself
+#define ROW_HEAP_IN_ARENA 2u  // the overflow buffer
+
+// Row structure: offset table plus (unless a view) the cell bytes
 struct Row {
-    char **cells;  // array of string pointers
+    const char *base;  // cell bytes: inline after the offsets, or the borrowed buffer
+    char *heap;  // overflow bytes of cells set with row_set_cell (NULL until needed)
+    uint32_t heap_len;  // used bytes of heap
+    uint32_t heap_cap;  // allocated bytes of heap
     int num_cols;  // number of columns in this row
+    uint32_t flags;  // ROW_IN_ARENA / ROW_HEAP_IN_ARENA
+    uint32_t offsets[];  // per cell: offset from base, ROW_HEAP_BIT | offset into heap, or ROW_NULL_CELL
 };
 
-/* 
+/*
+ * Internal helper: allocates a row with room for data_len inline bytes,
+ * from the current arena if there is one
+ * Cell offsets are left uninitialized
+ *
+ * parameters:
+ * - num_cols: number of columns in the row (must be > 0)
+ * - data_len: bytes to reserve after the offset table
+ *
+ * RETURN: pointer to new Row on success, NULL on bad size or allocation failure
+ */
+static Row *row_alloc(int num_cols, size_t data_len) {
+    if (num_cols <= 0 || data_len > ROW_MAX_BYTES) return NULL;
+
+    size_t table = (size_t)num_cols * sizeof(uint32_t);
+    size_t size = sizeof(Row) + table + data_len;
+    Arena *arena = arena_current();
+
+    Row *row = arena ? arena_alloc(arena, size) : malloc(size);
+    if (row == NULL) { // allocation failed
+        return NULL;
+    }
+    row->flags = arena ? ROW_IN_ARENA : 0;
+
+    row->base = (const char *)row->offsets + table;
+    row->heap = NULL;
+    row->heap_len = 0;
+    row->heap_cap = 0;
+    row->num_cols = num_cols;
+    return row;
+}
+
+/*
  * Creates a new row with the specified number of columns
  * All cells are initialized to NULL
  *
@@ -27,30 +83,99 @@ struct Row {
  * RETURN: pointer to new Row on success, NULL on allocation failure
  */
 Row *row_new(int num_cols) {
+    Row *row = row_alloc(num_cols, 0);
+    if (row == NULL) return NULL;
 
-    // bad parameters
-    if (num_cols <= 0) return NULL;
-    
-    // allocate row structure
-    Row *row = malloc(sizeof(Row));
-    if (row == NULL) { // allocation failed
-        return NULL;
+    for (int i = 0; i < num_cols; i++) row->offsets[i] = ROW_NULL_CELL;
+    return row;
+}
+
+/*
+ * Creates a row from a tokenized line in a single allocation
+ * The len bytes of line are copied as one block, so every cell must be
+ * NUL-terminated inside them (separators already replaced by '\0')
+ *
+ * parameters:
+ * - line: tokenized line bytes
+ * - len: number of bytes to copy, including the last cell's terminator
+ * - offsets: start of each cell relative to line
+ * - num_cols: number of cells (must be > 0)
+ *
+ * RETURN: pointer to new Row on success, NULL on bad input or allocation failure
+ */
+Row *row_new_packed(const char *line, size_t len, const uint32_t *offsets, int num_cols) {
+    if (line == NULL || offsets == NULL) return NULL;
+
+    Row *row = row_alloc(num_cols, len);
+    if (row == NULL) return NULL;
+
+    memcpy((char *)row->base, line, len);
+    memcpy(row->offsets, offsets, (size_t)num_cols * sizeof(uint32_t));
+    return row;
+}
+
+/*
+ * Creates a view row over a tokenized line without copying it
+ * The line is not freed with the row, so it must outlive the row
+ *
+ * parameters:
+ * - line: tokenized line bytes (cells NUL-terminated)
+ * - offsets: start of each cell relative to line
+ * - num_cols: number of cells (must be > 0)
+ *
+ * RETURN: pointer to new Row on success, NULL on bad input or allocation failure
+ */
+Row *row_new_view(const char *line, const uint32_t *offsets, int num_cols) {
+    if (line == NULL || offsets == NULL) return NULL;
+
+    Row *row = row_alloc(num_cols, 0);
+    if (row == NULL) return NULL;
+
+    row->base = line; // not part of the allocation, never freed
+    memcpy(row->offsets, offsets, (size_t)num_cols * sizeof(uint32_t));
+    return row;
+}
+
+/*
+ * Creates a row holding copies of the given strings in a single allocation
+ *
+ * parameters:
+ * - values: num_cols strings (NULL entries become NULL cells)
+ * - num_cols: number of cells (must be > 0)
+ *
+ * RETURN: pointer to new Row on success, NULL on bad input or allocation failure
+ */
+Row *row_new_from_cells(const char *const *values, int num_cols) {
+    if (values == NULL || num_cols <= 0) return NULL;
+
+    size_t total = 0;
+    for (int i = 0; i < num_cols; i++) {
+        if (values[i] != NULL) total += strlen(values[i]) + 1;
     }
-    
-    // allocate array of string pointers, initialize to NULL
-    row->cells = calloc(num_cols, sizeof(char *));
-    if (row->cells == NULL) { // allocation failed
-        free(row);
-        return NULL;
+
+    Row *row = row_alloc(num_cols, total);
+    if (row == NULL) return NULL;
+
+    char *out = (char *)row->base;
+    for (int i = 0; i < num_cols; i++) {
+        if (values[i] == NULL) {
+            row->offsets[i] = ROW_NULL_CELL;
+            continue;
+        }
+        size_t len = strlen(values[i]) + 1;
+        memcpy(out, values[i], len);
+        row->offsets[i] = (uint32_t)(out - row->base);
+        out += len;
     }
-    
-    row->num_cols = num_cols;
     return row;
 }
 
-/* 
+/*
  * Sets the cell value at the specified column inde
  * The value string is copied internally, so the caller can free the original
+ * The copy goes to the row's overflow buffer (reused in place when the new
+ * value fits over the old one), so pointers previously returned by
+ * row_get_cell() for this row may be invalidated
  *
  * parameters:
  * - row: row to modify
@@ -62,27 +187,66 @@ Row *row_new(int num_cols) {
 int row_set_cell(Row *row, int col, const char *value) {
     // bad parameters
     if (row == NULL || col < 0 || col >= row->num_cols) return -1;
-    
-    // free existing cell value if already exists
-    if (row->cells[col] != NULL) {
-        free(row->cells[col]);
-        row->cells[col] = NULL;
+
+    if (value == NULL) {
+        row->offsets[col] = ROW_NULL_CELL;
+        return 0;
     }
-    
-    if (value == NULL) return 0;
-    
-    // copy value string (caller can free the original)
-    size_t len = strlen(value);
-    row->cells[col] = malloc(len + 1); // allow space for '\0' terminator
-    if (row->cells[col] == NULL) { // allocation failed
-        return -1;
+
+    size_t len = strlen(value) + 1; // allow space for '\0' terminator
+    uint32_t old = row->offsets[col];
+
+    // overwrite the previous overflow copy if the new value fits
+    if (old != ROW_NULL_CELL && (old & ROW_HEAP_BIT)) {
+        char *slot = row->heap + (old & ~ROW_HEAP_BIT);
+        if (strlen(slot) + 1 >= len) {
+            memmove(slot, value, len);
+            return 0;
+        }
     }
-    
-    strcpy(row->cells[col], value);
+
+    if ((size_t)row->heap_len + len > ROW_MAX_BYTES) return -1;
+
+    if (row->heap_len + len > row->heap_cap) {
+        size_t new_cap = row->heap_cap ? row->heap_cap : 64;
+        while (new_cap < row->heap_len + len) new_cap *= 2;
+        if (new_cap > ROW_MAX_BYTES) new_cap = ROW_MAX_BYTES;
+
+        // value may point into the buffer being moved
+        const char *old_heap = row->heap;
+        int inside = (old_heap != NULL && value >= old_heap && value < old_heap + row->heap_len);
+        size_t value_off = inside ? (size_t)(value - old_heap) : 0;
+
+        char *new_heap;
+        Arena *arena = arena_current();
+        if (arena != NULL && (row->heap == NULL || (row->flags & ROW_HEAP_IN_ARENA))) {
+            // arena memory cannot be resized, copy into a bigger piece
+            new_heap = arena_alloc(arena, new_cap);
+            if (new_heap != NULL && row->heap_len > 0) memcpy(new_heap, row->heap, row->heap_len);
+            if (new_heap != NULL) row->flags |= ROW_HEAP_IN_ARENA;
+        } else if (row->flags & ROW_HEAP_IN_ARENA) {
+            // arena no longer current: move the buffer to malloc
+            new_heap = malloc(new_cap);
+            if (new_heap != NULL) memcpy(new_heap, row->heap, row->heap_len);
+            if (new_heap != NULL) row->flags &= ~ROW_HEAP_IN_ARENA;
+        } else {
+            new_heap = realloc(row->heap, new_cap);
+        }
+        if (new_heap == NULL) { // allocation failed
+            return -1;
+        }
+        row->heap = new_heap;
+        row->heap_cap = (uint32_t)new_cap;
+        if (inside) value = new_heap + value_off;
+    }
+
+    memcpy(row->heap + row->heap_len, value, len);
+    row->offsets[col] = ROW_HEAP_BIT | row->heap_len;
+    row->heap_len += (uint32_t)len;
     return 0;
 }
 
-/* 
+/*
  * Retrieves the cell value at the specified column index.
  *
  * parameters:
@@ -95,10 +259,13 @@ const char *row_get_cell(const Row *row, int col) {
     // bad parameters
     if (row == NULL || col < 0 || col >= row->num_cols) return NULL;
 
-    return row->cells[col]; // may be NULL if cell itself is NULL
+    uint32_t off = row->offsets[col];
+    if (off == ROW_NULL_CELL) return NULL; // cell itself is NULL
+    if (off & ROW_HEAP_BIT) return row->heap + (off & ~ROW_HEAP_BIT);
+    return row->base + off;
 }
 
-/* 
+/*
  * Returns the number of columns in the row
  *
  * parameters:
@@ -110,9 +277,11 @@ int row_num_cells(const Row *row) {
     return row == NULL ? 0 : row->num_cols;
 }
 
-/* 
+/*
  * Frees all resources associated with the row
- * All cell strings are freed, then the row structure itself
+ * The overflow buffer is freed, then the row allocation itself
+ * (borrowed bytes of a view row are left alone, and memory owned by an
+ * arena is released with the arena instead)
  *
  * parameters:
  * - row: row to free (safe to pass NULL)
@@ -122,17 +291,7 @@ int row_num_cells(const Row *row) {
 void row_free(Row *row) {
 
     if (row == NULL) return;
-    
-    // free all cell strings if exists
-    if (row->cells != NULL) {
-        for (int i = 0; i < row->num_cols; i++) {
-            if (row->cells[i] != NULL) {
-                free(row->cells[i]);
-            }
-        }
-        free(row->cells);
-    }
-    
-    free(row);
-}
 
+    if (!(row->flags & ROW_HEAP_IN_ARENA)) free(row->heap);
+    if (!(row->flags & ROW_IN_ARENA)) free(row);
+}
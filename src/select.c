@@ -209,24 +209,47 @@ Vec *select_project_rows(const Vec *rows, const int *indices, int n_indices){
         return NULL;
     }
 
+    const char **cells = malloc(sizeof(char *) * n_indices);
+    if(cells == NULL){
+        vec_free(result);
+        return NULL;
+    }
+
     for(int i= 0; i<total_rows; i++){
         const Row *src = vec_get(rows,i);
-        Row *dst = row_new(n_indices);
+        for(int j = 0; j <n_indices; j++){
+            cells[j] = row_get_cell(src, indices[j]);
+        }
+
+        // one allocation per projected row
+        Row *dst = row_new_from_cells(cells, n_indices);
         if(dst == NULL){
+            free(cells);
             vec_free(result);
             return NULL;
         }
-
-        for(int j = 0; j <n_indices; j++){
-            const char *cell = row_get_cell(src, indices[j]);
-            if (row_set_cell(dst, j, cell) != 0) {
-                row_free(dst);
-                vec_free(result);
-                return NULL;
-            }
-        }
         vec_push(result, dst);
     }
+    free(cells);
     return result;
 
-}
\ No newline at end of file
+}
+
+
+/*
+ * Projects a column-oriented table onto the selected columns, in place.
+ * No cells are copied: the table only records which columns are visible.
+ * 
+ * Parameters:
+ *  table: table to project
+ *  indices: array of column indices that are selected
+ *  n_indices: number of indexes
+ * 
+ *  Returns: 0 on success, or -1
+ */
+int select_project_table(Table *table, const int *indices, int n_indices){
+    if (table == NULL || indices == NULL || n_indices <= 0){
+        return -1;
+    }
+    return table_project(table, indices, n_indices);
+}
@@ -1,8 +1,14 @@
 /*
- * Implements basic sorting for CSV rows using qsort().
- * Uses a global comparator with the target column + direction
- * so qsort does not need additional context.
- * Sorting supports both numeric and text ordering based on content.
+ * Implements basic sorting for CSV rows.
+ * The sort column is read once into an array of (key, position) pairs,
+ * integers already parsed, and that array is sorted instead of the rows:
+ * radix sorted when every key is an integer, with qsort() otherwise.
+ * With several threads, partitions are sorted and merged in parallel.
+ * Sorting by several columns encodes each row's cells into one binary key
+ * (directions included) that compares with a single memcmp.
+ * Sorting supports both numeric and text ordering based on content:
+ * integers and decimals compare by value, other cells as text, in one
+ * total order shared by every sort path (see sort_key_compare).
  * 
  * AUTHOR: Vivek Patel
  * DATE: November 17, 2025
@@ -13,14 +19,35 @@
 #include "../include/sort.h"
 #include "../include/vec.h"
 #include "../include/row.h"
+#include "../include/table.h"
 #include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// global temporary variables for comparator
-static int g_sort_col = 0;
-static int g_sort_ascending = 1;  // 1 for ascending, 0 for descending
+// Fewest keys per thread worth a parallel sort
+#define SORT_PARALLEL_MIN_KEYS (16u << 10)
+
+// Most threads a single sort uses
+#define SORT_MAX_THREADS 64
+
+// First byte of an encoded cell, in ascending order (see sort_key_encode)
+enum {
+    ENCODED_MISSING = 0x00,
+    ENCODED_LOW_TEXT = 0x10,
+    ENCODED_NEGATIVE = 0x20,
+    ENCODED_ZERO = 0x21,
+    ENCODED_POSITIVE = 0x22,
+    ENCODED_TEXT = 0x30
+};
+
+// Integer sort key as radix sorted: value orders like the key as unsigned
+typedef struct RadixPair {
+    uint64_t value;
+    size_t pos;
+} RadixPair;
 
 /* Checks whether a C-string represents a valid integer literal.
  * Accepts optional leading '+' or '-' sign followed by digits.)
@@ -46,53 +73,634 @@ static int is_int_str(const char *s) {
     return 1;
 }
 
-/* qsort comparator for Row* items.
+/* Checks whether a C-string is a decimal number: an optional sign, then
+ * digits with at most one '.' among them (at least one digit in all).
  * 
  * PARAMETERS:
- *   a, b - pointers to Row*
+ *   s  - input string
+ *
+ * RETURNS:
+ *   1  if s is a decimal number
+ *   0  otherwise
+ */
+static int is_decimal_str(const char *s) {
+    int digits = 0, dots = 0;
+    if (*s == '+' || *s == '-') s++;
+    for (; *s; s++) {
+        if (isdigit((unsigned char)*s)) digits++;
+        else if (*s == '.' && dots++ == 0) continue;
+        else return 0;
+    }
+    return digits > 0;
+}
+
+/* Compares two decimal numbers (see is_decimal_str) by value, exactly.
+ * 
+ * PARAMETERS:
+ *   a, b - decimal numbers
  *
  * RETURNS:
  *   negative if a < b
  *   zero     if a == b
  *   positive if a > b
  */
-static int rowptr_compare(const void *a, const void *b) {
-    
-    // Unwrap Row* from qsort
-    const Row *ra = *(Row * const *)a;
-    const Row *rb = *(Row * const *)b;
+static int decimal_compare(const char *a, const char *b) {
+    int a_neg = *a == '-', b_neg = *b == '-';
+    if (*a == '+' || *a == '-') a++;
+    if (*b == '+' || *b == '-') b++;
 
-    if (!ra || !rb)
-        return 0;
+    // Zero has no sign ("-0" == "0")
+    if (a_neg && strspn(a, "0.") == strlen(a)) a_neg = 0;
+    if (b_neg && strspn(b, "0.") == strlen(b)) b_neg = 0;
+    if (a_neg != b_neg) return a_neg ? -1 : 1;
 
-    // Get target column values
-    const char *sa = row_get_cell(ra, g_sort_col);
-    const char *sb = row_get_cell(rb, g_sort_col);
+    // Longer integer part (without leading zeros) is larger, then digit by digit
+    while (*a == '0') a++;
+    while (*b == '0') b++;
+    size_t a_int = strcspn(a, "."), b_int = strcspn(b, ".");
+    int result = (a_int > b_int) - (a_int < b_int);
+    if (result == 0) result = memcmp(a, b, a_int);
+    if (result == 0) {
+        // Fractions digit by digit, missing digits counting as 0
+        a += a_int + (a[a_int] == '.');
+        b += b_int + (b[b_int] == '.');
+        while (result == 0 && (*a || *b)) {
+            char da = *a ? *a++ : '0';
+            char db = *b ? *b++ : '0';
+            result = (da > db) - (da < db);
+        }
+    }
+    return a_neg ? -result : result;
+}
 
-    // Handle missing cells
-    if (!sa && !sb) return 0;
-    if (!sa) return -1;
-    if (!sb) return 1;
+/* Fills in the sort key of one cell, parsing integer cells once.
+ * 
+ * PARAMETERS:
+ *   key  - key to fill in
+ *   cell - cell value (NULL for a missing cell)
+ *   pos  - position of the row before sorting
+ */
+void sort_key_init(SortKey *key, const char *cell, size_t pos) {
+    key->text = cell;
+    key->pos = pos;
+    key->num = 0;
+
+    if (!cell) {
+        key->kind = SORT_KEY_MISSING;
+        return;
+    }
 
-    // Numeric comparison if both look like integers
-    int a_int = is_int_str(sa);
-    int b_int = is_int_str(sb);
+    if (is_int_str(cell)) {
+        errno = 0;
+        key->num = strtoll(cell, NULL, 10);
+        if (errno != ERANGE) {
+            key->kind = SORT_KEY_INT;
+            return;
+        }
+    }
+
+    if (is_decimal_str(cell)) {
+        key->kind = SORT_KEY_DECIMAL;  // includes integers beyond int64_t
+    } else if ((unsigned char)cell[0] < '+') {
+        key->kind = SORT_KEY_LOW_TEXT;  // strcmp puts it before any number
+    } else {
+        key->kind = SORT_KEY_TEXT;
+    }
+}
 
+/* Compares two sort keys in the given direction.
+ * Missing cells come first, numbers compare by value and texts with
+ * strcmp. Numbers go between the texts strcmp puts before any number
+ * (first byte below '+', such as "") and all other texts, so the order is
+ * total and every sort algorithm agrees on it. Encoded keys (both
+ * SORT_KEY_ENCODED) compare with memcmp, ignoring ascending. Equal keys
+ * keep their original order.
+ * 
+ * PARAMETERS:
+ *   a, b      - sort keys
+ *   ascending - 1 for ascending order, 0 for descending order
+ *
+ * RETURNS:
+ *   negative if a < b
+ *   zero     if a == b
+ *   positive if a > b
+ */
+int sort_key_compare(const SortKey *a, const SortKey *b, int ascending) {
     int result;
-    if (a_int && b_int) {
-        long ia = strtol(sa, NULL, 10);
-        long ib = strtol(sb, NULL, 10);
-        result = (ia > ib) - (ia < ib);
+
+    if (a->kind == SORT_KEY_ENCODED) {
+        // Encoded keys already hold their columns' directions
+        size_t a_len = (size_t)a->num, b_len = (size_t)b->num;
+        result = memcmp(a->text, b->text, a_len < b_len ? a_len : b_len);
+        if (result == 0) result = (a_len > b_len) - (a_len < b_len);
+    } else if (a->kind == SORT_KEY_MISSING || b->kind == SORT_KEY_MISSING) {
+        // Handle missing cells (first in either direction)
+        result = (b->kind == SORT_KEY_MISSING) - (a->kind == SORT_KEY_MISSING);
     } else {
-        result = strcmp(sa, sb);
+        // Integers and decimals are one class of numbers
+        int a_class = a->kind == SORT_KEY_DECIMAL ? SORT_KEY_INT : a->kind;
+        int b_class = b->kind == SORT_KEY_DECIMAL ? SORT_KEY_INT : b->kind;
+
+        if (a_class != b_class) {
+            result = (a_class > b_class) - (a_class < b_class);
+        } else if (a->kind == SORT_KEY_INT && b->kind == SORT_KEY_INT) {
+            result = (a->num > b->num) - (a->num < b->num);
+        } else if (a_class == SORT_KEY_INT) {
+            result = decimal_compare(a->text, b->text);
+        } else {
+            result = strcmp(a->text, b->text);
+        }
+
+        // Flip direction for descending
+        if (!ascending) result = -result;
     }
-    
-    // Flip direction for descending
-    return g_sort_ascending ? result : -result;
+
+    // Ties keep the original row order
+    return result != 0 ? result : (a->pos > b->pos) - (a->pos < b->pos);
+}
+
+/* qsort comparator for ascending SortKey items. */
+static int key_compare_asc(const void *a, const void *b) {
+    return sort_key_compare(a, b, 1);
+}
+
+/* qsort comparator for descending SortKey items. */
+static int key_compare_desc(const void *a, const void *b) {
+    return sort_key_compare(a, b, 0);
+}
+
+/* Encodes a cell so that memcmp orders encodings like sort_key_compare.
+ * A tag byte gives the kind: missing, low text, negative number, zero,
+ * positive number or text, in sort order. Texts follow as their bytes and
+ * a 0 byte (cells hold no 0 bytes, so shorter prefixes sort first).
+ * A nonzero number follows as its exponent (digits before the point once
+ * leading zeros are gone, negative for fractions below 0.1), biased into a
+ * big-endian uint32_t, then its significant digits and a 0 byte, all
+ * inverted for negative numbers; equal values get equal encodings. For
+ * descending order every byte is inverted, except the tag of a missing
+ * cell, which sorts first in either direction.
+ * 
+ * PARAMETERS:
+ *   out       - destination, strlen(cell) + SORT_KEY_ENCODE_EXTRA bytes
+ *   cell      - cell value (NULL for a missing cell)
+ *   ascending - 1 for ascending order, 0 for descending order
+ *
+ * RETURNS:
+ *   number of bytes written
+ */
+size_t sort_key_encode(unsigned char *out, const char *cell, int ascending) {
+    if (!cell) {
+        out[0] = ENCODED_MISSING;
+        return 1;
+    }
+
+    size_t len;
+    if (is_decimal_str(cell)) {
+        int negative = *cell == '-';
+        const char *s = cell + (*cell == '+' || *cell == '-');
+        while (*s == '0') s++;
+
+        // Significant digits, from the integer part on or the first nonzero fraction digit
+        size_t int_len = strcspn(s, ".");
+        const char *frac = s + int_len + (s[int_len] == '.');
+        int64_t exponent = (int64_t)int_len;
+        unsigned char *digits = out + 5;
+        memcpy(digits, s, int_len);
+        size_t num_digits = int_len;
+        if (int_len == 0) {
+            while (*frac == '0') {
+                frac++;
+                exponent--;
+            }
+        }
+        for (; *frac; frac++) digits[num_digits++] = (unsigned char)*frac;
+        while (num_digits > 0 && digits[num_digits - 1] == '0') num_digits--;
+
+        if (num_digits == 0) {
+            out[0] = ENCODED_ZERO;  // "-0" == "0.00"
+            len = 1;
+        } else {
+            uint32_t biased = (uint32_t)(exponent + INT64_C(0x80000000));
+            out[0] = negative ? ENCODED_NEGATIVE : ENCODED_POSITIVE;
+            out[1] = (unsigned char)(biased >> 24);
+            out[2] = (unsigned char)(biased >> 16);
+            out[3] = (unsigned char)(biased >> 8);
+            out[4] = (unsigned char)biased;
+            digits[num_digits] = 0;
+            len = num_digits + 6;
+
+            // larger magnitudes sort first among negative numbers
+            if (negative) {
+                for (size_t i = 1; i < len; i++) out[i] = (unsigned char)~out[i];
+            }
+        }
+    } else {
+        size_t cell_len = strlen(cell);
+        out[0] = (unsigned char)cell[0] < '+' ? ENCODED_LOW_TEXT : ENCODED_TEXT;
+        memcpy(out + 1, cell, cell_len);
+        out[cell_len + 1] = 0;
+        len = cell_len + 2;
+    }
+
+    if (!ascending) {
+        for (size_t i = 0; i < len; i++) out[i] = (unsigned char)~out[i];
+    }
+    return len;
+}
+
+/* Encodes the cells of a row in several columns into one key, growing
+ * the buffer as needed.
+ * 
+ * PARAMETERS:
+ *   row      - row to encode
+ *   cols     - columns to encode, in order
+ *   num_cols - number of columns
+ *   buf      - buffer receiving the key (may point to NULL)
+ *   cap      - size of *buf
+ *
+ * RETURNS:
+ *   length of the key
+ *   0 on memory failure
+ */
+size_t sort_key_encode_row(const Row *row, const SortColumn *cols, int num_cols,
+                           unsigned char **buf, size_t *cap) {
+    size_t need = 0;
+    for (int c = 0; c < num_cols; c++) {
+        const char *cell = row_get_cell(row, cols[c].col_index);
+        need += (cell ? strlen(cell) : 0) + SORT_KEY_ENCODE_EXTRA;
+    }
+    if (need > *cap) {
+        size_t new_cap = *cap * 2 > need ? *cap * 2 : need;
+        unsigned char *grown = realloc(*buf, new_cap);
+        if (!grown)
+            return 0;
+        *buf = grown;
+        *cap = new_cap;
+    }
+
+    size_t len = 0;
+    for (int c = 0; c < num_cols; c++) {
+        len += sort_key_encode(*buf + len, row_get_cell(row, cols[c].col_index), cols[c].ascending);
+    }
+    return len;
+}
+
+/* Helper: cell getter for encode_keys reading an array of rows.
+ * Parameters: source (Row **), i (row), col_index (column)
+ * Returns: the cell, NULL if missing
+ */
+static const char *row_cell(const void *source, size_t i, int col_index) {
+    Row *const *rows = source;
+    return row_get_cell(rows[i], col_index);
+}
+
+// Records of a table, as read by table_cell
+typedef struct TableSource {
+    const Table *table;
+    const size_t *records;
+} TableSource;
+
+/* Helper: cell getter for encode_keys reading table records.
+ * Parameters: source (TableSource *), i (record position), col_index (column)
+ * Returns: the cell, NULL if missing
+ */
+static const char *table_cell(const void *source, size_t i, int col_index) {
+    const TableSource *table = source;
+    return table_column_cell(table_column(table->table, col_index), table->records[i]);
+}
+
+/* Helper: encodes the cells of len rows in several columns into one key
+ * per row (SORT_KEY_ENCODED), all in one buffer.
+ * Parameters: keys (receives the keys, keys[i].pos == i)
+ *             offsets (scratch, len entries)
+ *             len (number of rows)
+ *             cols, num_cols (columns to encode, in order)
+ *             cell_of, source (cell getter and what it reads)
+ * Returns: the buffer the keys point into (caller frees), NULL on memory failure
+ */
+static unsigned char *encode_keys(SortKey *keys, size_t *offsets, size_t len, const SortColumn *cols,
+                                  int num_cols, const char *(*cell_of)(const void *, size_t, int),
+                                  const void *source) {
+    size_t cap = len * 16 + SORT_KEY_ENCODE_EXTRA;
+    size_t used = 0;
+    unsigned char *data = malloc(cap);
+    if (!data)
+        return NULL;
+
+    for (size_t i = 0; i < len; i++) {
+        offsets[i] = used;
+        for (int c = 0; c < num_cols; c++) {
+            const char *cell = cell_of(source, i, cols[c].col_index);
+            size_t need = used + (cell ? strlen(cell) : 0) + SORT_KEY_ENCODE_EXTRA;
+            if (need > cap) {
+                while (cap < need) cap *= 2;
+                unsigned char *grown = realloc(data, cap);
+                if (!grown) {
+                    free(data);
+                    return NULL;
+                }
+                data = grown;
+            }
+            used += sort_key_encode(data + used, cell, cols[c].ascending);
+        }
+        keys[i] = (SortKey){ (int64_t)(used - offsets[i]), NULL, i, SORT_KEY_ENCODED };
+    }
+
+    // the buffer has stopped moving
+    for (size_t i = 0; i < len; i++) keys[i].text = (const char *)data + offsets[i];
+    return data;
+}
+
+/* Radix sorts the integer keys of an array with no text keys.
+ * Each key becomes an unsigned 64-bit value that orders like the key in
+ * the wanted direction (sign bit flipped, all bits flipped for descending)
+ * and (value, position) pairs go through one stable counting pass per
+ * byte, skipping bytes that are the same in every key. Missing cells go
+ * first, in their original order, as in sort_key_compare.
+ * 
+ * PARAMETERS:
+ *   keys      - keys to sort (every kind is SORT_KEY_INT or SORT_KEY_MISSING)
+ *   len       - number of keys
+ *   ascending - 1 for ascending order, 0 for descending order
+ *   order     - receives the positions of the keys in sorted order
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on memory failure
+ */
+static int radix_sort_keys(const SortKey *keys, size_t len, int ascending, size_t *order) {
+    RadixPair *pairs = malloc(sizeof(RadixPair) * len);
+    RadixPair *tmp = malloc(sizeof(RadixPair) * len);
+    size_t (*counts)[256] = calloc(8, sizeof(*counts));
+    if (!pairs || !tmp || !counts) {
+        free(pairs);
+        free(tmp);
+        free(counts);
+        return -1;
+    }
+
+    // Missing cells first; histogram every byte of the others in one pass
+    size_t missing = 0;
+    size_t n = 0;
+    uint64_t flip = ascending ? UINT64_C(1) << 63 : ~(UINT64_C(1) << 63);
+    for (size_t i = 0; i < len; i++) {
+        if (keys[i].kind == SORT_KEY_MISSING) {
+            order[missing++] = keys[i].pos;
+            continue;
+        }
+        uint64_t value = (uint64_t)keys[i].num ^ flip;
+        pairs[n++] = (RadixPair){ value, keys[i].pos };
+        for (int byte = 0; byte < 8; byte++) counts[byte][(value >> (byte * 8)) & 0xff]++;
+    }
+
+    // One stable counting pass per byte that differs between keys
+    for (int byte = 0; byte < 8 && n > 0; byte++) {
+        size_t *count = counts[byte];
+        if (count[(pairs[0].value >> (byte * 8)) & 0xff] == n) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) tmp[count[(pairs[i].value >> (byte * 8)) & 0xff]++] = pairs[i];
+
+        RadixPair *swap = pairs;
+        pairs = tmp;
+        tmp = swap;
+    }
+
+    for (size_t i = 0; i < n; i++) order[missing + i] = pairs[i].pos;
+
+    free(pairs);
+    free(tmp);
+    free(counts);
+    return 0;
+}
+
+// One thread's share of a parallel sort: a partition to sort, or a range
+// of the output of merging two sorted runs
+typedef struct {
+    const SortKey *keys;  // all keys, keys[i].pos == i (sorting pass)
+    size_t *order;        // scratch positions, as long as keys (sorting pass)
+    const SortKey *a;     // first run (merging pass)
+    size_t a_len;
+    const SortKey *b;     // second run (merging pass)
+    size_t b_len;
+    SortKey *out;         // destination, indexed like keys / the merged runs
+    size_t start;         // first output index
+    size_t end;           // one past the last output index
+    int ascending;
+    int all_int;          // every key is SORT_KEY_INT or SORT_KEY_MISSING
+    int failed;           // set on memory failure
+} SortTask;
+
+/* Helper: sorts keys[start, end) of a task into out[start, end).
+ * Parameters: arg (SortTask*)
+ * Returns: NULL (pthread start routine)
+ */
+static void *sort_part(void *arg) {
+    SortTask *task = arg;
+    size_t len = task->end - task->start;
+    SortKey *out = task->out + task->start;
+
+    if (task->all_int) {
+        size_t *order = task->order + task->start;
+        if (radix_sort_keys(task->keys + task->start, len, task->ascending, order) != 0) {
+            task->failed = 1;
+            return NULL;
+        }
+        for (size_t i = 0; i < len; i++) out[i] = task->keys[order[i]];
+    } else {
+        memcpy(out, task->keys + task->start, sizeof(SortKey) * len);
+        qsort(out, len, sizeof(SortKey), task->ascending ? key_compare_asc : key_compare_desc);
+    }
+    return NULL;
+}
+
+/* Helper: finds how many keys of run a come before output index k of the
+ * merge of runs a and b (the co-rank of k); b has the rest.
+ * Parameters: k (output index, at most a_len + b_len)
+ *             a, a_len, b, b_len (sorted runs)
+ *             ascending (direction of the runs)
+ * Returns: keys of a among the first k merged keys
+ */
+static size_t co_rank(size_t k, const SortKey *a, size_t a_len, const SortKey *b, size_t b_len, int ascending) {
+    size_t lo = k > b_len ? k - b_len : 0;
+    size_t hi = k < a_len ? k : a_len;
+
+    // smallest i whose a[i] comes after b[k - i - 1]; keys never tie
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (sort_key_compare(&b[k - i - 1], &a[i], ascending) < 0) hi = i;
+        else lo = i + 1;
+    }
+    return lo;
+}
+
+/* Helper: writes output indexes [start, end) of the merge of a task's runs.
+ * Parameters: arg (SortTask*)
+ * Returns: NULL (pthread start routine)
+ */
+static void *merge_part(void *arg) {
+    SortTask *task = arg;
+    size_t i = co_rank(task->start, task->a, task->a_len, task->b, task->b_len, task->ascending);
+    size_t j = task->start - i;
+    size_t i_end = co_rank(task->end, task->a, task->a_len, task->b, task->b_len, task->ascending);
+    size_t j_end = task->end - i_end;
+
+    SortKey *out = task->out + task->start;
+    while (i < i_end && j < j_end) {
+        if (sort_key_compare(&task->b[j], &task->a[i], task->ascending) < 0) *out++ = task->b[j++];
+        else *out++ = task->a[i++];
+    }
+    while (i < i_end) *out++ = task->a[i++];
+    while (j < j_end) *out++ = task->b[j++];
+    return NULL;
+}
+
+/* Helper: runs fn on every task, one thread per task.
+ * The calling thread takes task 0, and a task whose thread cannot be
+ * created is run inline after the others have been started.
+ * Parameters: fn (pthread start routine taking a SortTask*)
+ *             tasks (tasks to run)
+ *             count (number of tasks)
+ * Returns: void
+ */
+static void run_tasks(void *(*fn)(void *), SortTask *tasks, int count) {
+    pthread_t threads[SORT_MAX_THREADS];
+    char started[SORT_MAX_THREADS] = { 0 };
+
+    for (int i = 1; i < count; i++) {
+        if (pthread_create(&threads[i], NULL, fn, &tasks[i]) == 0) started[i] = 1;
+    }
+
+    fn(&tasks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else fn(&tasks[i]);
+    }
+}
+
+/* Helper: sorts keys with count threads. Each thread sorts one partition
+ * into a run, then pairs of runs are merged in rounds; every merge is cut
+ * into equal output ranges by co-rank, so all threads work on every round.
+ * Keys never tie, so the result is the sequential order.
+ * Parameters: keys (keys to sort, keys[i].pos == i)
+ *             len (number of keys)
+ *             ascending (1 for ascending order, 0 for descending order)
+ *             all_int (every key is SORT_KEY_INT or SORT_KEY_MISSING)
+ *             order (receives the positions of the keys in sorted order)
+ *             count (threads, 2 to SORT_MAX_THREADS)
+ * Returns: 0 on success, -1 on memory failure
+ */
+static int parallel_sort_keys(const SortKey *keys, size_t len, int ascending, int all_int,
+                              size_t *order, int count) {
+    SortKey *runs = malloc(sizeof(SortKey) * len);
+    SortKey *merged = malloc(sizeof(SortKey) * len);
+    if (!runs || !merged) {
+        free(runs);
+        free(merged);
+        return -1;
+    }
+
+    // run r is runs[bounds[r], bounds[r + 1])
+    size_t bounds[SORT_MAX_THREADS + 1];
+    SortTask tasks[SORT_MAX_THREADS];
+    int failed = 0;
+    for (int t = 0; t <= count; t++) bounds[t] = len / (size_t)count * (size_t)t;
+    bounds[count] = len;
+
+    for (int t = 0; t < count; t++) {
+        tasks[t] = (SortTask){ .keys = keys, .order = order, .out = runs, .start = bounds[t],
+                               .end = bounds[t + 1], .ascending = ascending, .all_int = all_int };
+    }
+    run_tasks(sort_part, tasks, count);
+    for (int t = 0; t < count; t++) failed |= tasks[t].failed;
+
+    int num_runs = count;
+    while (!failed && num_runs > 1) {
+        int pairs = num_runs / 2;
+        int per_pair = count / pairs;
+        int num_tasks = 0;
+
+        for (int p = 0; p < pairs; p++) {
+            size_t a = bounds[2 * p], b = bounds[2 * p + 1], end = bounds[2 * p + 2];
+            for (int t = 0; t < per_pair; t++) {
+                tasks[num_tasks++] = (SortTask){
+                    .a = runs + a, .a_len = b - a, .b = runs + b, .b_len = end - b, .out = merged + a,
+                    .start = (end - a) / (size_t)per_pair * (size_t)t,
+                    .end = t == per_pair - 1 ? end - a : (end - a) / (size_t)per_pair * (size_t)(t + 1),
+                    .ascending = ascending
+                };
+            }
+        }
+
+        // an odd last run moves to the next round as it is
+        if (num_runs % 2 != 0) {
+            size_t last = bounds[num_runs - 1];
+            memcpy(merged + last, runs + last, sizeof(SortKey) * (len - last));
+        }
+        run_tasks(merge_part, tasks, num_tasks);
+
+        num_runs = (num_runs + 1) / 2;
+        for (int r = 1; r < num_runs; r++) bounds[r] = bounds[2 * r];
+        bounds[num_runs] = len;
+
+        SortKey *swap = runs;
+        runs = merged;
+        merged = swap;
+    }
+
+    if (!failed) {
+        for (size_t i = 0; i < len; i++) order[i] = runs[i].pos;
+    }
+    free(runs);
+    free(merged);
+    return failed ? -1 : 0;
+}
+
+/* Sorts an array of sort keys.
+ * Keys that are all integers (or missing) are radix sorted; any text key
+ * falls back to qsort with the direction's comparator. With more than one
+ * thread, large arrays are sorted in partitions and merged in parallel.
+ * No state is shared between calls, so several sorts may run at once.
+ * 
+ * PARAMETERS:
+ *   keys        - keys to sort, keys[i].pos == i (reordered by qsort)
+ *   len         - number of keys
+ *   ascending   - 1 for ascending order, 0 for descending order
+ *   order       - receives the positions of the keys in sorted order
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on memory failure
+ */
+static int sort_keys(SortKey *keys, size_t len, int ascending, size_t *order, int num_threads) {
+    int all_int = 1;
+    for (size_t i = 0; i < len && all_int; i++) {
+        if (keys[i].kind != SORT_KEY_INT && keys[i].kind != SORT_KEY_MISSING) all_int = 0;
+    }
+
+    size_t max_threads = len / SORT_PARALLEL_MIN_KEYS;
+    int count = num_threads < SORT_MAX_THREADS ? num_threads : SORT_MAX_THREADS;
+    if ((size_t)count > max_threads) count = (int)max_threads;
+    if (count > 1)
+        return parallel_sort_keys(keys, len, ascending, all_int, order, count);
+
+    if (all_int)
+        return radix_sort_keys(keys, len, ascending, order);
+
+    qsort(keys, len, sizeof(SortKey), ascending ? key_compare_asc : key_compare_desc);
+    for (size_t i = 0; i < len; i++) order[i] = keys[i].pos;
+    return 0;
 }
 
 /* Sorts rows by column and returns a new sorted vector.
- * The original vector is not modified.
+ * The original vector is not modified; rows with equal cells keep their
+ * original order.
  * 
  * PARAMETERS:
  *   rows      - Vec* of Row*
@@ -104,6 +712,24 @@ static int rowptr_compare(const void *a, const void *b) {
  *   NULL on invalid input or memory failure.
  */
 Vec *sort_by_column(Vec *rows, int col_index, int ascending) {
+    return sort_by_column_parallel(rows, col_index, ascending, 1);
+}
+
+/* Sorts rows by column with up to num_threads threads.
+ * Same result as sort_by_column; large inputs are split into partitions
+ * that are sorted and then merged in parallel.
+ * 
+ * PARAMETERS:
+ *   rows        - Vec* of Row*
+ *   col_index   - column index to sort by 
+ *   ascending   - 1 for ascending order, 0 for descending order
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   A new Vec* containing the sorted rows.
+ *   NULL on invalid input or memory failure.
+ */
+Vec *sort_by_column_parallel(Vec *rows, int col_index, int ascending, int num_threads) {
     if (!rows || col_index < 0)
         return NULL;
 
@@ -138,43 +764,337 @@ Vec *sort_by_column(Vec *rows, int col_index, int ascending) {
     if (col_index >= row_num_cells(first))
         return NULL;
 
-    // Buffer used by qsort
-    Row **tmp = malloc(sizeof(Row *) * len);
-    if (!tmp)
+    // Sort keys, read from the rows once
+    SortKey *keys = malloc(sizeof(SortKey) * len);
+    if (!keys)
         return NULL;
 
-    // Copy rows into temp array
     for (size_t i = 0; i < len; i++) {
         Row *current = vec_get(rows, i);
         if (!current) {
-            free(tmp);
+            free(keys);
             return NULL;
         }
-        tmp[i] = current;
+        sort_key_init(&keys[i], row_get_cell(current, col_index), i);
     }
 
-    // Comparator configuration
-    g_sort_col = col_index;
-    g_sort_ascending = ascending;
-    
-    // Preform sorting
-    qsort(tmp, len, sizeof(Row *), rowptr_compare);
+    size_t *order = malloc(sizeof(size_t) * len);
+    if (!order || sort_keys(keys, len, ascending, order, num_threads) != 0) {
+        free(order);
+        free(keys);
+        return NULL;
+    }
+    free(keys);
 
     // Build a NEW vector with sorted rows
     Vec *sorted = vec_new(len);
     if (!sorted) {
-        free(tmp);
+        free(order);
         return NULL;
     }
 
     for (size_t i = 0; i < len; i++) {
-        if (vec_push(sorted, tmp[i]) != 0) {
+        if (vec_push(sorted, vec_get(rows, order[i])) != 0) {
             vec_free(sorted);
-            free(tmp);
+            free(order);
             return NULL;
         }
     }
 
-    free(tmp);
+    free(order);
     return sorted;
+}
+
+/* Sorts an array of rows by column, in place, with up to num_threads
+ * threads. Same order as sort_by_column, but rows missing the column may
+ * come anywhere in the array (they sort first).
+ * 
+ * PARAMETERS:
+ *   rows        - array of Row*
+ *   len         - number of rows
+ *   col_index   - column index to sort by 
+ *   ascending   - 1 for ascending order, 0 for descending order
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid input or memory failure
+ */
+int sort_rows(Row **rows, size_t len, int col_index, int ascending, int num_threads) {
+    if ((!rows && len > 0) || col_index < 0)
+        return -1;
+    if (len <= 1)
+        return 0;
+
+    SortKey *keys = malloc(sizeof(SortKey) * len);
+    size_t *order = malloc(sizeof(size_t) * len);
+    if (!keys || !order) {
+        free(keys);
+        free(order);
+        return -1;
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < len && !failed; i++) {
+        if (!rows[i]) failed = 1;
+        else sort_key_init(&keys[i], row_get_cell(rows[i], col_index), i);
+    }
+
+    if (failed || sort_keys(keys, len, ascending, order, num_threads) != 0) {
+        free(keys);
+        free(order);
+        return -1;
+    }
+
+    // Positions become rows; keys' memory holds the old order meanwhile
+    Row **old = (Row **)keys;
+    memcpy(old, rows, sizeof(Row *) * len);
+    for (size_t i = 0; i < len; i++) rows[i] = old[order[i]];
+
+    free(keys);
+    free(order);
+    return 0;
+}
+
+/* Sorts rows by several columns and returns a new sorted vector.
+ * With one column this is sort_by_column_parallel; otherwise the rows are
+ * copied into the new vector and sorted there by sort_rows_by_columns.
+ * 
+ * PARAMETERS:
+ *   rows        - Vec* of Row*
+ *   cols        - columns to sort by, in order, each with its direction
+ *   num_cols    - number of columns
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   A new Vec* containing the sorted rows.
+ *   NULL on invalid input or memory failure.
+ */
+Vec *sort_by_columns(Vec *rows, const SortColumn *cols, int num_cols, int num_threads) {
+    if (!rows || !cols || num_cols < 1)
+        return NULL;
+
+    if (num_cols == 1)
+        return sort_by_column_parallel(rows, cols[0].col_index, cols[0].ascending, num_threads);
+
+    size_t len = vec_length(rows);
+    if (len == 0)
+        return NULL;
+
+    // Like sort_by_column, a single row needs no columns
+    Row *first = vec_get(rows, 0);
+    if (!first)
+        return NULL;
+    for (int c = 0; c < num_cols; c++) {
+        if (cols[c].col_index < 0 || (len > 1 && cols[c].col_index >= row_num_cells(first)))
+            return NULL;
+    }
+
+    Vec *sorted = vec_new(len);
+    if (!sorted)
+        return NULL;
+
+    for (size_t i = 0; i < len; i++) {
+        if (vec_push(sorted, vec_get(rows, i)) != 0) {
+            vec_free(sorted);
+            return NULL;
+        }
+    }
+
+    if (sort_rows_by_columns(vec_get_data(sorted), len, cols, num_cols, num_threads) != 0) {
+        vec_free(sorted);
+        return NULL;
+    }
+    return sorted;
+}
+
+/* Sorts an array of rows by several columns, in place. With one column
+ * this is sort_rows; otherwise each row's cells are encoded into one key
+ * (sort_key_encode) and the keys are sorted comparing them with memcmp.
+ * 
+ * PARAMETERS:
+ *   rows        - array of Row*
+ *   len         - number of rows
+ *   cols        - columns to sort by, in order, each with its direction
+ *   num_cols    - number of columns
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid input or memory failure
+ */
+int sort_rows_by_columns(Row **rows, size_t len, const SortColumn *cols, int num_cols, int num_threads) {
+    if ((!rows && len > 0) || !cols || num_cols < 1)
+        return -1;
+    for (int c = 0; c < num_cols; c++) {
+        if (cols[c].col_index < 0)
+            return -1;
+    }
+
+    if (num_cols == 1)
+        return sort_rows(rows, len, cols[0].col_index, cols[0].ascending, num_threads);
+    if (len <= 1)
+        return 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!rows[i])
+            return -1;
+    }
+
+    SortKey *keys = malloc(sizeof(SortKey) * len);
+    size_t *order = malloc(sizeof(size_t) * len);
+    unsigned char *data = keys && order ? encode_keys(keys, order, len, cols, num_cols, row_cell, rows) : NULL;
+    if (!data || sort_keys(keys, len, 1, order, num_threads) != 0) {
+        free(data);
+        free(keys);
+        free(order);
+        return -1;
+    }
+    free(data);
+
+    // Positions become rows; keys' memory holds the old order meanwhile
+    Row **old = (Row **)keys;
+    memcpy(old, rows, sizeof(Row *) * len);
+    for (size_t i = 0; i < len; i++) rows[i] = old[order[i]];
+
+    free(keys);
+    free(order);
+    return 0;
+}
+
+/* Sorts the data rows of a column-oriented table by column, in place.
+ * The header (visible row 0) stays first; only record ids are moved, in
+ * the order of sort keys read from the sort column.
+ * Integer columns are compared on their parsed int64_t values.
+ * 
+ * PARAMETERS:
+ *   table     - table to sort
+ *   col_index - visible column index to sort by 
+ *   ascending - 1 for ascending order, 0 for descending order
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid input or memory failure
+ */
+int sort_table_by_column(Table *table, int col_index, int ascending) {
+    return sort_table_by_column_parallel(table, col_index, ascending, 1);
+}
+
+/* Sorts the data rows of a table by column with up to num_threads threads.
+ * Same result as sort_table_by_column.
+ * 
+ * PARAMETERS:
+ *   table       - table to sort
+ *   col_index   - visible column index to sort by 
+ *   ascending   - 1 for ascending order, 0 for descending order
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid input or memory failure
+ */
+int sort_table_by_column_parallel(Table *table, int col_index, int ascending, int num_threads) {
+    if (!table || col_index < 0)
+        return -1;
+
+    const TableColumn *column = table_column(table, col_index);
+    if (!column)
+        return -1;
+
+    size_t len = table_num_rows(table);
+    if (len <= 2)
+        return 0; // header plus at most one row is already sorted
+
+    size_t *records = table_rows(table) + 1;
+    size_t count = len - 1;
+
+    SortKey *keys = malloc(sizeof(SortKey) * count);
+    size_t *order = malloc(sizeof(size_t) * count);
+    if (!keys || !order) {
+        free(keys);
+        free(order);
+        return -1;
+    }
+
+    // Integer columns reuse their parsed values; other columns (doubles
+    // included) get the keys of sort_by_column, numbers ordered by value
+    for (size_t i = 0; i < count; i++) {
+        const char *cell = table_column_cell(column, records[i]);
+        if (column->type == COLUMN_INT64 && cell) {
+            keys[i] = (SortKey){ column->ints[records[i]], cell, i, SORT_KEY_INT };
+        } else {
+            sort_key_init(&keys[i], cell, i);
+        }
+    }
+
+    if (sort_keys(keys, count, ascending, order, num_threads) != 0) {
+        free(keys);
+        free(order);
+        return -1;
+    }
+
+    // Positions become record ids; keys' memory holds the old ids meanwhile
+    size_t *old = (size_t *)keys;
+    memcpy(old, records, sizeof(size_t) * count);
+    for (size_t i = 0; i < count; i++) records[i] = old[order[i]];
+
+    free(keys);
+    free(order);
+    return 0;
+}
+
+/* Sorts the data rows of a table by several columns, in place, with up to
+ * num_threads threads. With one column this is
+ * sort_table_by_column_parallel; otherwise the cells of each record are
+ * encoded into one key, as in sort_rows_by_columns.
+ * 
+ * PARAMETERS:
+ *   table       - table to sort
+ *   cols        - visible columns to sort by, in order, each with its direction
+ *   num_cols    - number of columns
+ *   num_threads - threads that may be used
+ *
+ * RETURNS:
+ *   0  on success
+ *   -1 on invalid input or memory failure
+ */
+int sort_table_by_columns(Table *table, const SortColumn *cols, int num_cols, int num_threads) {
+    if (!table || !cols || num_cols < 1)
+        return -1;
+
+    if (num_cols == 1)
+        return sort_table_by_column_parallel(table, cols[0].col_index, cols[0].ascending, num_threads);
+
+    for (int c = 0; c < num_cols; c++) {
+        if (cols[c].col_index < 0 || !table_column(table, cols[c].col_index))
+            return -1;
+    }
+
+    size_t len = table_num_rows(table);
+    if (len <= 2)
+        return 0; // header plus at most one row is already sorted
+
+    size_t *records = table_rows(table) + 1;
+    size_t count = len - 1;
+    TableSource source = { table, records };
+
+    SortKey *keys = malloc(sizeof(SortKey) * count);
+    size_t *order = malloc(sizeof(size_t) * count);
+    unsigned char *data = keys && order ? encode_keys(keys, order, count, cols, num_cols, table_cell, &source) : NULL;
+    if (!data || sort_keys(keys, count, 1, order, num_threads) != 0) {
+        free(data);
+        free(keys);
+        free(order);
+        return -1;
+    }
+    free(data);
+
+    // Positions become record ids; keys' memory holds the old ids meanwhile
+    size_t *old = (size_t *)keys;
+    memcpy(old, records, sizeof(size_t) * count);
+    for (size_t i = 0; i < count; i++) records[i] = old[order[i]];
+
+    free(keys);
+    free(order);
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,500 @@
+/*
+ * Provides a column-oriented table for queries that load the whole input.
+ * Each column keeps its cells back to back in one byte buffer plus an
+ * array of per-record offsets, so an operator that touches one column
+ * scans one contiguous buffer instead of chasing a Row pointer per cell.
+ * Operators do not copy data: they reorder or compact the list of visible
+ * record ids (the row selection) and the list of visible columns.
+ * Record 0 is the header, matching the Vec-of-Row convention.
+ * After loading, columns whose cells are all numbers also keep the parsed
+ * values in a native int64_t or double array, so filters and sorts on them
+ * compare values instead of re-parsing text.
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#include "../include/table.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initial number of records and cell bytes per column
+#define TABLE_INITIAL_RECORDS 64
+#define TABLE_INITIAL_BYTES 1024
+
+// Number of data records sampled to guess a column's type
+#define TABLE_TYPE_SAMPLE 1024
+
+struct Table {
+    TableColumn *columns;  // physical columns
+    int num_columns;  // number of physical columns
+    size_t num_records;  // records appended
+    size_t records_cap;  // records each offsets array can hold
+    size_t *rows;  // visible record ids, in output order
+    size_t num_rows;  // number of visible rows
+    int *cols;  // visible columns (indices into columns)
+    int num_cols;  // number of visible columns
+    int borrowed;  // column buffers belong to the caller (e.g. a cache image)
+};
+
+/*
+ * Internal helper: grows every column's offsets array and the row list to
+ * hold at least one more record.
+ *
+ * RETURN: 0 on success, -1 on allocation failure
+ */
+static int grow_records(Table *table) {
+    size_t cap = table->records_cap ? table->records_cap * 2 : TABLE_INITIAL_RECORDS;
+
+    size_t *rows = realloc(table->rows, cap * sizeof(size_t));
+    if (rows == NULL) return -1;
+    table->rows = rows;
+
+    for (int c = 0; c < table->num_columns; c++) {
+        size_t *offsets = realloc(table->columns[c].offsets, cap * sizeof(size_t));
+        if (offsets == NULL) return -1;
+        table->columns[c].offsets = offsets;
+    }
+    table->records_cap = cap;
+    return 0;
+}
+
+/*
+ * Internal helper: appends one NUL-terminated cell to a column.
+ *
+ * RETURN: offset of the copy on success, TABLE_NULL_CELL on allocation failure
+ */
+static size_t column_push(TableColumn *column, const char *cell) {
+    size_t len = strlen(cell) + 1;
+
+    if (column->cap - column->len < len) {
+        size_t cap = column->cap ? column->cap : TABLE_INITIAL_BYTES;
+        while (cap - column->len < len) cap *= 2;
+
+        char *data = realloc(column->data, cap);
+        if (data == NULL) return TABLE_NULL_CELL;
+        column->data = data;
+        column->cap = cap;
+    }
+
+    size_t offset = column->len;
+    memcpy(column->data + offset, cell, len);
+    column->len += len;
+    return offset;
+}
+
+/*
+ * Creates a new, empty table.
+ *
+ * parameters:
+ * - num_cols: number of columns (0 for a table of empty input)
+ *
+ * RETURN: pointer to new Table on success, NULL on bad input or allocation failure
+ */
+Table *table_new(int num_cols) {
+    if (num_cols < 0) return NULL;
+
+    Table *table = calloc(1, sizeof(Table));
+    if (table == NULL) return NULL;
+
+    // one slot even for an empty table, so NULL always means failure
+    size_t slots = num_cols > 0 ? (size_t)num_cols : 1;
+    table->columns = calloc(slots, sizeof(TableColumn));
+    table->cols = malloc(slots * sizeof(int));
+    if (table->columns == NULL || table->cols == NULL) {
+        free(table->columns);
+        free(table->cols);
+        free(table);
+        return NULL;
+    }
+
+    table->num_columns = num_cols;
+    table->num_cols = num_cols;
+    for (int c = 0; c < num_cols; c++) table->cols[c] = c;
+    return table;
+}
+
+/*
+ * Creates a table over columns that already hold every record, e.g. the
+ * sections of a mapped cache image. The column buffers are not copied.
+ *
+ * parameters:
+ * - columns: num_cols columns with num_records offsets (and values) each
+ * - num_cols: number of columns (0 for a table of empty input)
+ * - num_records: number of records in every column (header included)
+ *
+ * RETURN: pointer to new Table on success, NULL on bad input or allocation failure
+ */
+Table *table_new_borrowed(const TableColumn *columns, int num_cols, size_t num_records) {
+    if (columns == NULL && num_cols > 0) return NULL;
+
+    Table *table = table_new(num_cols);
+    if (table == NULL) return NULL;
+
+    table->rows = malloc((num_records > 0 ? num_records : 1) * sizeof(size_t));
+    if (table->rows == NULL) {
+        table_free(table);
+        return NULL;
+    }
+
+    if (num_cols > 0) memcpy(table->columns, columns, (size_t)num_cols * sizeof(TableColumn));
+    for (size_t r = 0; r < num_records; r++) table->rows[r] = r;
+
+    table->num_records = num_records;
+    table->records_cap = num_records;
+    table->num_rows = num_records;
+    table->borrowed = 1;
+    return table;
+}
+
+/*
+ * Appends a record from a tokenized line and makes it visible.
+ *
+ * parameters:
+ * - table: table to append to
+ * - line: tokenized line, every cell NUL-terminated
+ * - offsets: start of each cell in line
+ * - num_cells: number of cells in the line
+ *
+ * RETURN: 0 on success, -1 on bad input or allocation failure
+ */
+int table_append_row(Table *table, const char *line, const uint32_t *offsets, int num_cells) {
+    if (table == NULL || line == NULL || (offsets == NULL && num_cells > 0)) return -1;
+
+    // appending after an operator ran would mix records into its selection
+    if (table->num_rows != table->num_records || table->borrowed) return -1;
+
+    if (table->num_records == table->records_cap && grow_records(table) != 0) return -1;
+
+    size_t record = table->num_records;
+    for (int c = 0; c < table->num_columns; c++) {
+        TableColumn *column = &table->columns[c];
+        if (c >= num_cells) {
+            column->offsets[record] = TABLE_NULL_CELL;
+            continue;
+        }
+
+        size_t offset = column_push(column, line + offsets[c]);
+        if (offset == TABLE_NULL_CELL) return -1;
+        column->offsets[record] = offset;
+    }
+
+    table->rows[table->num_rows++] = record;
+    table->num_records++;
+    return 0;
+}
+
+/*
+ * Internal helper: parses an optionally signed run of decimal digits (the
+ * same cells the sort treats as integers) that fits in int64_t.
+ *
+ * RETURN: 1 and the value in out on success, 0 if cell is not such an integer
+ */
+static int parse_int64(const char *cell, int64_t *out) {
+    const char *p = cell;
+    if (*p == '+' || *p == '-') p++;
+    if (*p == '\0') return 0;
+
+    for (; *p != '\0'; p++) {
+        if (!isdigit((unsigned char)*p)) return 0;
+    }
+
+    errno = 0;
+    long long value = strtoll(cell, NULL, 10);
+    if (errno == ERANGE) return 0;
+
+    *out = (int64_t)value;
+    return 1;
+}
+
+/*
+ * Internal helper: parses a cell that strtod() consumes completely, so the
+ * value equals what atof() gives for the same cell.
+ *
+ * RETURN: 1 and the value in out on success, 0 if cell is not a number
+ */
+static int parse_double(const char *cell, double *out) {
+    char *end;
+    double value = strtod(cell, &end);
+    if (end == cell || *end != '\0') return 0;
+
+    *out = value;
+    return 1;
+}
+
+/*
+ * Internal helper: returns the narrowest type that holds both a column
+ * type and one of its cells.
+ */
+static ColumnType widen_type(ColumnType type, const char *cell) {
+    int64_t i;
+    double d;
+
+    if (type == COLUMN_INT64 && parse_int64(cell, &i)) return COLUMN_INT64;
+    if (type != COLUMN_STRING && parse_double(cell, &d)) return COLUMN_DOUBLE;
+    return COLUMN_STRING;
+}
+
+/*
+ * Internal helper: guesses a column's type from its first data records.
+ * A column with no cells in the sample stays text.
+ */
+static ColumnType sample_type(const TableColumn *column, size_t num_records) {
+    size_t end = num_records < TABLE_TYPE_SAMPLE + 1 ? num_records : TABLE_TYPE_SAMPLE + 1;
+    ColumnType type = COLUMN_INT64;
+    int seen = 0;
+
+    for (size_t r = 1; r < end && type != COLUMN_STRING; r++) {
+        const char *cell = table_column_cell(column, r);
+        if (cell == NULL) continue;
+        type = widen_type(type, cell);
+        seen = 1;
+    }
+    return seen ? type : COLUMN_STRING;
+}
+
+/*
+ * Internal helper: parses every data record of a column into its int64_t
+ * or double array (already allocated for the given type). The header and
+ * missing cells get 0, which is what atof() gives for them.
+ *
+ * RETURN: type if every cell fits, otherwise a wider type for the first
+ *         cell that does not
+ */
+static ColumnType fill_values(TableColumn *column, size_t num_records, ColumnType type) {
+    if (num_records > 0) {
+        if (type == COLUMN_INT64) column->ints[0] = 0;
+        else column->reals[0] = 0.0;
+    }
+
+    for (size_t r = 1; r < num_records; r++) {
+        const char *cell = table_column_cell(column, r);
+        int ok;
+
+        if (type == COLUMN_INT64) {
+            column->ints[r] = 0;
+            ok = cell == NULL || parse_int64(cell, &column->ints[r]);
+        } else {
+            column->reals[r] = 0.0;
+            ok = cell == NULL || parse_double(cell, &column->reals[r]);
+        }
+        if (!ok) return widen_type(type, cell);
+    }
+    return type;
+}
+
+/*
+ * Infers the type of every column from a sample of data records, then
+ * parses each numeric column into a native array. A column whose later
+ * cells do not fit the sampled type is widened (int64 to double to text)
+ * and parsed again.
+ *
+ * parameters:
+ * - table: fully loaded table
+ *
+ * RETURN: 0 on success, -1 if table is NULL or borrowed, or on allocation
+ *         failure (every column is then left as COLUMN_STRING)
+ */
+int table_infer_types(Table *table) {
+    if (table == NULL || table->borrowed) return -1;
+
+    size_t n = table->num_records;
+    for (int c = 0; c < table->num_columns; c++) {
+        TableColumn *column = &table->columns[c];
+        free(column->ints);
+        free(column->reals);
+        column->ints = NULL;
+        column->reals = NULL;
+        column->type = COLUMN_STRING;
+
+        ColumnType type = sample_type(column, n);
+        while (type != COLUMN_STRING) {
+            if (type == COLUMN_INT64) column->ints = malloc(n * sizeof(int64_t));
+            else column->reals = malloc(n * sizeof(double));
+
+            if (column->ints == NULL && column->reals == NULL) {
+                for (int k = 0; k < c; k++) {
+                    free(table->columns[k].ints);
+                    free(table->columns[k].reals);
+                    table->columns[k].ints = NULL;
+                    table->columns[k].reals = NULL;
+                    table->columns[k].type = COLUMN_STRING;
+                }
+                return -1;
+            }
+
+            ColumnType fits = fill_values(column, n, type);
+            if (fits == type) break;
+
+            free(column->ints);
+            free(column->reals);
+            column->ints = NULL;
+            column->reals = NULL;
+            type = fits;
+        }
+        column->type = type;
+    }
+    return 0;
+}
+
+/*
+ * Returns the number of visible rows.
+ *
+ * parameters:
+ * - table: table to query
+ *
+ * RETURN: number of visible rows (header included), 0 if table is NULL
+ */
+size_t table_num_rows(const Table *table) {
+    return table == NULL ? 0 : table->num_rows;
+}
+
+/*
+ * Returns the number of visible columns.
+ *
+ * parameters:
+ * - table: table to query
+ *
+ * RETURN: number of visible columns, 0 if table is NULL
+ */
+int table_num_cols(const Table *table) {
+    return table == NULL ? 0 : table->num_cols;
+}
+
+/*
+ * Returns the record ids of the visible rows, which operators may reorder
+ * or compact in place.
+ *
+ * parameters:
+ * - table: table to query
+ *
+ * RETURN: array of table_num_rows() record ids, NULL if table is NULL
+ */
+size_t *table_rows(const Table *table) {
+    return table == NULL ? NULL : table->rows;
+}
+
+/*
+ * Shrinks the visible rows to the first count entries of table_rows().
+ *
+ * parameters:
+ * - table: table to modify
+ * - count: number of rows to keep
+ *
+ * RETURN: 0 on success, -1 if table is NULL or count exceeds the visible rows
+ */
+int table_set_num_rows(Table *table, size_t count) {
+    if (table == NULL || count > table->num_rows) return -1;
+    table->num_rows = count;
+    return 0;
+}
+
+/*
+ * Returns a visible column.
+ *
+ * parameters:
+ * - table: table to query
+ * - col: visible column index (0-based)
+ *
+ * RETURN: pointer to the column, NULL if table is NULL or col is out of range
+ */
+const TableColumn *table_column(const Table *table, int col) {
+    if (table == NULL || col < 0 || col >= table->num_cols) return NULL;
+    return &table->columns[table->cols[col]];
+}
+
+/*
+ * Keeps only the given visible columns, in the given order. A column may
+ * be listed more than once; no cell data is copied.
+ *
+ * parameters:
+ * - table: table to modify
+ * - indices: visible column indices
+ * - count: number of indices (must be > 0)
+ *
+ * RETURN: 0 on success, -1 on bad input or allocation failure
+ */
+int table_project(Table *table, const int *indices, int count) {
+    if (table == NULL || indices == NULL || count <= 0) return -1;
+
+    int *cols = malloc((size_t)count * sizeof(int));
+    if (cols == NULL) return -1;
+
+    for (int i = 0; i < count; i++) {
+        if (indices[i] < 0 || indices[i] >= table->num_cols) {
+            free(cols);
+            return -1;
+        }
+        cols[i] = table->cols[indices[i]];
+    }
+
+    free(table->cols);
+    table->cols = cols;
+    table->num_cols = count;
+    return 0;
+}
+
+/*
+ * Returns the cell at a visible row and column.
+ *
+ * parameters:
+ * - table: table to query
+ * - row: visible row index (0 is the header)
+ * - col: visible column index
+ *
+ * RETURN: cell string, NULL if an index is out of range or the cell is missing
+ */
+const char *table_get_cell(const Table *table, size_t row, int col) {
+    const TableColumn *column = table_column(table, col);
+    if (column == NULL || row >= table->num_rows) return NULL;
+    return table_column_cell(column, table->rows[row]);
+}
+
+/*
+ * Copies a visible row into a new Row with one cell per visible column.
+ *
+ * parameters:
+ * - table: table to read
+ * - row: visible row index (0 is the header)
+ *
+ * RETURN: pointer to new Row on success, NULL on bad input or allocation failure
+ */
+Row *table_get_row(const Table *table, size_t row) {
+    if (table == NULL || row >= table->num_rows) return NULL;
+
+    const char **cells = malloc((size_t)table->num_cols * sizeof(char *));
+    if (cells == NULL) return NULL;
+
+    for (int c = 0; c < table->num_cols; c++) {
+        cells[c] = table_get_cell(table, row, c);
+    }
+
+    Row *result = row_new_from_cells(cells, table->num_cols);
+    free(cells);
+    return result;
+}
+
+/*
+ * Frees the table and all its columns (borrowed column buffers are left
+ * to their owner).
+ *
+ * parameters:
+ * - table: table to free (safe to pass NULL)
+ */
+void table_free(Table *table) {
+    if (table == NULL) return;
+
+    for (int c = 0; c < table->num_columns && !table->borrowed; c++) {
+        free(table->columns[c].data);
+        free(table->columns[c].offsets);
+        free(table->columns[c].ints);
+        free(table->columns[c].reals);
+    }
+    free(table->columns);
+    free(table->rows);
+    free(table->cols);
+    free(table);
+}
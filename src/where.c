@@ -5,6 +5,7 @@
  * name ("age", "name", …), and <op> is one of: ==, !=, >=, <=, >, <.
  * The module parses the condition, locates the target column, and returns
  * a new Vec* containing only the filetered rows
+ * (or narrows a column-oriented Table in place, see where_filter_table)
  * 
  * AUTHOR: Nadeem Mohamed
  * DATE: November 17, 2025
@@ -14,6 +15,7 @@
 #include "../include/where.h"
 #include "../include/row.h"
 #include "../include/vec.h"
+#include "../include/table.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -285,37 +287,25 @@ static int find_column_index(const Row *header, const char *column_token) {
     return -1;  
 }
 
+// Parsed condition bound to a column of a specific header
+struct WhereCond {
+    int col_index;  // target column
+    int op_type;  // one of OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE
+    char *rhs_value;  // right-hand-side constant
+    double rhs_number;  // atof(rhs_value), for <, <=, >, >=
+};
+
 /*
- * Compare one cell value against the right-hand side of the condition.
- * For == and !=, a plain string comparison is used.
- * For <, <=, >, >=, both strings are converted to double 
+ * Compare two numbers with one of the ordering operators.
  *
  * parameters:
- *  cell_value: value from the CSV row for the target column.
- *  rhs_value:  right-hand-side constant from the condition.
- *  op_type:    operator type (one of OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE).
+ *  left_num:  value of the cell.
+ *  right_num: value of the right-hand-side constant.
+ *  op_type:   operator type (one of OP_LT, OP_LE, OP_GT, OP_GE).
  *
- * RETURN: 1 on success
+ * RETURN: 1 if the comparison holds, 0 otherwise
  */
-static int matches_condition(
-    const char *cell_value,
-    const char *rhs_value,
-    int op_type
-) {
-    if (cell_value == NULL) cell_value = "";
-    if (rhs_value == NULL) rhs_value = "";
-
-    if (op_type == OP_EQ) {
-        return strcmp(cell_value, rhs_value) == 0;
-    }
-    if (op_type == OP_NE) {
-        return strcmp(cell_value, rhs_value) != 0;
-    }
-
-
-    double left_num = atof(cell_value);
-    double right_num = atof(rhs_value);
-
+static int compare_numbers(double left_num, double right_num, int op_type) {
     if (op_type == OP_LT) {
         return left_num < right_num;
     }
@@ -332,26 +322,44 @@ static int matches_condition(
     return 0;
 }
 
+/*
+ * Compare one cell value against the right-hand side of the condition.
+ * For == and !=, a plain string comparison is used.
+ * For <, <=, >, >=, the cell is converted to double and compared with the
+ * already converted constant
+ *
+ * parameters:
+ *  cell_value: value from the CSV row for the target column.
+ *  cond:       compiled condition.
+ *
+ * RETURN: 1 on success
+ */
+static int matches_condition(const char *cell_value, const WhereCond *cond) {
+    if (cell_value == NULL) cell_value = "";
+
+    if (cond->op_type == OP_EQ) {
+        return strcmp(cell_value, cond->rhs_value) == 0;
+    }
+    if (cond->op_type == OP_NE) {
+        return strcmp(cell_value, cond->rhs_value) != 0;
+    }
 
+    return compare_numbers(atof(cell_value), cond->rhs_number, cond->op_type);
+}
 
 /*
- * Applies a single where condition to the table. Parses the condition and then
- * finds the target column, and returns a new Vec containing the header plus the rows that 
- * satisfy the conditions.
+ * Parses a condition and resolves its column against the header row, so the
+ * same condition can be checked against many rows (e.g. while streaming).
  * 
  * Parameters:
- *  rows: Vec* of Row* representing the full dataset
- *  condition: condition to check
+ *  header: header row used to resolve column names
+ *  condition: condition to parse
  * 
- * Returns: A new Vec* containing the header row plus the rows that satisfy the condition
+ * Returns: newly allocated WhereCond on success (free with where_free),
+ *          NULL on invalid condition, unknown column or allocation failure
  */
-Vec *where_filter(const Vec *rows, const char *condition) {
-    if (rows == NULL || condition == NULL || *condition == '\0') {
-        return NULL;
-    }
-
-    size_t total_rows = vec_length(rows);
-    if (total_rows == 0) {
+WhereCond *where_compile(const Row *header, const char *condition) {
+    if (header == NULL || condition == NULL || *condition == '\0') {
         return NULL;
     }
 
@@ -364,44 +372,254 @@ Vec *where_filter(const Vec *rows, const char *condition) {
         return NULL;
     }
 
-    //Get header row
-    const Row *header = vec_get(rows, 0);
-    if (header == NULL) {
-        free(col_token);
+    int col_index = find_column_index(header, col_token);
+    free(col_token);
+    if (col_index < 0) {
         free(rhs_value);
         return NULL;
     }
 
-    int col_index = find_column_index(header, col_token);
-    if (col_index < 0) {
-        free(col_token);
+    WhereCond *cond = malloc(sizeof(WhereCond));
+    if (cond == NULL) {
         free(rhs_value);
         return NULL;
     }
 
+    cond->col_index = col_index;
+    cond->op_type = op_type;
+    cond->rhs_value = rhs_value;
+    cond->rhs_number = atof(rhs_value);
+    return cond;
+}
+
+/*
+ * Checks a single row against a compiled condition.
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ *  row: row to test
+ * 
+ * Returns: 1 if the row satisfies the condition, 0 otherwise
+ */
+int where_match(const WhereCond *cond, const Row *row) {
+    if (cond == NULL || row == NULL) return 0;
+
+    const char *cell = row_get_cell(row, cond->col_index);
+    return matches_condition(cell, cond);
+}
+
+/*
+ * Checks a single cell value of the condition's column, for callers that
+ * locate the cell themselves (e.g. in raw CSV bytes).
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ *  cell: cell value, NULL for a missing cell (compares like "")
+ * 
+ * Returns: 1 if the cell satisfies the condition, 0 otherwise
+ */
+int where_match_cell(const WhereCond *cond, const char *cell) {
+    if (cond == NULL) return 0;
+    return matches_condition(cell, cond);
+}
+
+/*
+ * Reports the column a condition tests, so callers can tell which columns
+ * of a row it reads.
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ * 
+ * Returns: target column index, -1 if cond is NULL
+ */
+int where_column(const WhereCond *cond) {
+    return cond == NULL ? -1 : cond->col_index;
+}
+
+/*
+ * Reports whether a condition is an equality test, so callers can look the
+ * value up in an index instead of checking every row.
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ *  col_index: set to the target column (may be NULL)
+ *  value: set to the right-hand-side constant, owned by cond (may be NULL)
+ * 
+ * Returns: 1 if cond is column==value, 0 otherwise
+ */
+int where_equality(const WhereCond *cond, int *col_index, const char **value) {
+    if (cond == NULL || cond->op_type != OP_EQ) return 0;
+
+    if (col_index != NULL) *col_index = cond->col_index;
+    if (value != NULL) *value = cond->rhs_value;
+    return 1;
+}
+
+/*
+ * Reports whether a condition is an ordering test (<, <=, >, >=), so callers
+ * can rule out blocks of rows with a zone map of its column.
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ *  col_index: set to the target column (may be NULL)
+ * 
+ * Returns: 1 if cond compares the column numerically, 0 otherwise
+ */
+int where_ordering(const WhereCond *cond, int *col_index) {
+    if (cond == NULL || cond->op_type == OP_EQ || cond->op_type == OP_NE) return 0;
+
+    if (col_index != NULL) *col_index = cond->col_index;
+    return 1;
+}
+
+/*
+ * Reports whether a condition can hold for some row of a block, given only
+ * the block's summary of the target column: the smallest and largest atof()
+ * value of its present cells and whether any cell is missing or empty
+ * (those compare as 0). NaN cells never match, so they may be left out of
+ * the range.
+ * 
+ * Parameters:
+ *  cond: condition from where_compile
+ *  min_value, max_value: value range of the present cells (min > max if none)
+ *  has_empty: nonzero if the block has missing or empty cells
+ * 
+ * Returns: 0 if no row of the block can match an ordering condition,
+ *          1 otherwise (always 1 for == and !=)
+ */
+int where_may_match_range(const WhereCond *cond, double min_value, double max_value, int has_empty) {
+    if (!where_ordering(cond, NULL)) return 1;
+
+    if (has_empty && compare_numbers(0.0, cond->rhs_number, cond->op_type)) return 1;
+    if (min_value > max_value) return 0;
+
+    // < and <= hold for some value iff they hold for the smallest one
+    if (cond->op_type == OP_LT || cond->op_type == OP_LE) {
+        return compare_numbers(min_value, cond->rhs_number, cond->op_type);
+    }
+    return compare_numbers(max_value, cond->rhs_number, cond->op_type);
+}
+
+/*
+ * Frees a condition returned by where_compile.
+ * 
+ * Parameters:
+ *  cond: condition to free (safe to pass NULL)
+ */
+void where_free(WhereCond *cond) {
+    if (cond == NULL) return;
+    free(cond->rhs_value);
+    free(cond);
+}
+
+/*
+ * Applies a single where condition to the table. Parses the condition and then
+ * finds the target column, and returns a new Vec containing the header plus the rows that 
+ * satisfy the conditions.
+ * 
+ * Parameters:
+ *  rows: Vec* of Row* representing the full dataset
+ *  condition: condition to check
+ * 
+ * Returns: A new Vec* containing the header row plus the rows that satisfy the condition
+ */
+Vec *where_filter(const Vec *rows, const char *condition) {
+    if (rows == NULL || condition == NULL || *condition == '\0') {
+        return NULL;
+    }
+
+    size_t total_rows = vec_length(rows);
+    if (total_rows == 0) {
+        return NULL;
+    }
+
+    //Get header row and bind the condition to it
+    Row *header_row = vec_get(rows, 0);
+    WhereCond *cond = where_compile(header_row, condition);
+    if (cond == NULL) {
+        return NULL;
+    }
+
     //Prepare result vector: at most total_rows rows
     Vec *result = vec_new(total_rows);
     if (result == NULL) {
-        free(col_token);
-        free(rhs_value);
+        where_free(cond);
         return NULL;
     }
 
     //Always keep the header as the first row 
-    Row *header_row = vec_get(rows, 0);
     vec_push(result, header_row);
 
     //Filter the remaining rows 
     for (size_t i = 1; i < total_rows; i++) {
         Row *r = vec_get(rows, i);
-        const char *cell = row_get_cell(r, col_index);
-
-        if (matches_condition(cell, rhs_value, op_type)) {
+        if (where_match(cond, r)) {
             vec_push(result, r);   
         }
     }
 
-    free(col_token);
-    free(rhs_value);
+    where_free(cond);
     return result;
 }
+
+/*
+ * Applies a single where condition to a column-oriented table. The target
+ * column is scanned directly and the visible rows are compacted in place,
+ * keeping the header plus the rows that satisfy the condition.
+ * Ordering operators on a numeric column compare its native values, which
+ * equal atof() of the cells (missing cells are 0, like atof("")).
+ * 
+ * Parameters:
+ *  table: table to filter (record ids are reused, no cells are copied)
+ *  condition: condition to check
+ * 
+ * Returns: 0 on success, -1 on invalid condition, unknown column or empty table
+ */
+int where_filter_table(Table *table, const char *condition) {
+    if (table == NULL || condition == NULL || *condition == '\0') {
+        return -1;
+    }
+
+    size_t total_rows = table_num_rows(table);
+    if (total_rows == 0) {
+        return -1;
+    }
+
+    //Bind the condition to the header row
+    Row *header_row = table_get_row(table, 0);
+    WhereCond *cond = where_compile(header_row, condition);
+    row_free(header_row);
+    if (cond == NULL) {
+        return -1;
+    }
+
+    //Scan the target column, keeping the header as the first row
+    const TableColumn *column = table_column(table, cond->col_index);
+    size_t *rows = table_rows(table);
+    size_t kept = 1;
+    int numeric_op = cond->op_type != OP_EQ && cond->op_type != OP_NE;
+
+    if (numeric_op && column->type == COLUMN_INT64) {
+        for (size_t i = 1; i < total_rows; i++) {
+            if (compare_numbers((double)column->ints[rows[i]], cond->rhs_number, cond->op_type)) {
+                rows[kept++] = rows[i];
+            }
+        }
+    } else if (numeric_op && column->type == COLUMN_DOUBLE) {
+        for (size_t i = 1; i < total_rows; i++) {
+            if (compare_numbers(column->reals[rows[i]], cond->rhs_number, cond->op_type)) {
+                rows[kept++] = rows[i];
+            }
+        }
+    } else {
+        for (size_t i = 1; i < total_rows; i++) {
+            const char *cell = table_column_cell(column, rows[i]);
+            if (matches_condition(cell, cond)) {
+                rows[kept++] = rows[i];
+            }
+        }
+    }
+
+    where_free(cond);
+    return table_set_num_rows(table, kept);
+}
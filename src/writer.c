@@ -0,0 +1,211 @@
+/*
+ * Provides a buffered writer for query output.
+ * Bytes are appended to a large user-space buffer with memcpy and handed
+ * to the kernel with write() in big chunks, instead of going through a
+ * stdio call per cell. Data larger than the free buffer space is sent
+ * together with the buffered bytes in a single writev(), without copying.
+ * Short writes and EINTR are retried; the first error sticks, so callers
+ * can write freely and check once at the end (writer_close).
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "../include/writer.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Default buffer size
+#define WRITER_BUFFER_SIZE (1u << 20)
+
+struct Writer {
+    int fd;  // destination file descriptor
+    int owns_fd;  // 1 if writer_close must close fd
+    int failed;  // 1 once a write has failed
+    char *buf;  // output buffer
+    size_t cap;  // size of buf
+    size_t len;  // buffered bytes
+};
+
+/*
+ * Internal helper: writes every byte of up to two spans, retrying short
+ * writes and EINTR.
+ *
+ * parameters:
+ * - fd: destination
+ * - iov: spans to write (modified while writing)
+ * - count: number of spans (1 or 2)
+ *
+ * RETURN: 0 on success, -1 on write error
+ */
+static int write_all(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        // drop fully written spans, then advance into the next one
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov[0].iov_len) {
+            done -= iov[0].iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov[0].iov_base = (char *)iov[0].iov_base + done;
+            iov[0].iov_len -= done;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Creates a writer on an open file descriptor.
+ *
+ * parameters:
+ * - fd: destination (left open by writer_close)
+ * - buffer_size: bytes to buffer, 0 for the 1 MiB default
+ *
+ * RETURN: pointer to new Writer on success, NULL on bad fd or allocation failure
+ */
+Writer *writer_open_fd(int fd, size_t buffer_size) {
+    if (fd < 0) return NULL;
+    if (buffer_size == 0) buffer_size = WRITER_BUFFER_SIZE;
+
+    Writer *writer = calloc(1, sizeof(Writer));
+    if (writer == NULL) return NULL;
+
+    writer->buf = malloc(buffer_size);
+    if (writer->buf == NULL) {
+        free(writer);
+        return NULL;
+    }
+    writer->fd = fd;
+    writer->cap = buffer_size;
+    return writer;
+}
+
+/*
+ * Creates a writer on a file, created or truncated.
+ *
+ * parameters:
+ * - path: file to write
+ *
+ * RETURN: pointer to new Writer on success, NULL if the file cannot be
+ *         opened or allocation failed
+ */
+Writer *writer_open_path(const char *path) {
+    if (path == NULL) return NULL;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return NULL;
+
+    Writer *writer = writer_open_fd(fd, 0);
+    if (writer == NULL) {
+        close(fd);
+        return NULL;
+    }
+    writer->owns_fd = 1;
+    return writer;
+}
+
+/*
+ * Appends bytes to the output.
+ * Small writes are copied into the buffer; a write that does not fit is
+ * sent along with the buffer in one writev() if it is at least as large as
+ * the buffer, otherwise the buffer is flushed first.
+ *
+ * parameters:
+ * - writer: writer to append to
+ * - data: bytes to write
+ * - len: number of bytes
+ *
+ * RETURN: 0 on success, -1 on write error (or earlier failure)
+ */
+int writer_write(Writer *writer, const char *data, size_t len) {
+    if (writer == NULL || (data == NULL && len > 0)) return -1;
+    if (writer->failed) return -1;
+
+    if (len <= writer->cap - writer->len) {
+        memcpy(writer->buf + writer->len, data, len);
+        writer->len += len;
+        return 0;
+    }
+
+    if (len >= writer->cap) {
+        struct iovec iov[2] = {
+            { writer->buf, writer->len },
+            { (void *)data, len },
+        };
+        int rc = writer->len > 0 ? write_all(writer->fd, iov, 2) : write_all(writer->fd, iov + 1, 1);
+        writer->len = 0;
+        if (rc != 0) writer->failed = 1;
+        return rc;
+    }
+
+    if (writer_flush(writer) != 0) return -1;
+    memcpy(writer->buf, data, len);
+    writer->len = len;
+    return 0;
+}
+
+/*
+ * Writes all buffered bytes.
+ *
+ * parameters:
+ * - writer: writer to flush
+ *
+ * RETURN: 0 on success, -1 on write error (or earlier failure)
+ */
+int writer_flush(Writer *writer) {
+    if (writer == NULL || writer->failed) return -1;
+    if (writer->len == 0) return 0;
+
+    struct iovec iov = { writer->buf, writer->len };
+    writer->len = 0;
+    if (write_all(writer->fd, &iov, 1) != 0) {
+        writer->failed = 1;
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Reports whether a write has failed.
+ *
+ * parameters:
+ * - writer: writer to query
+ *
+ * RETURN: 1 after a failed write (or for NULL), 0 otherwise
+ */
+int writer_failed(const Writer *writer) {
+    return writer == NULL ? 1 : writer->failed;
+}
+
+/*
+ * Flushes and frees the writer, closing its file if it opened it.
+ *
+ * parameters:
+ * - writer: writer to close (safe to pass NULL)
+ *
+ * RETURN: 0 on success, -1 if any write or the close failed
+ */
+int writer_close(Writer *writer) {
+    if (writer == NULL) return 0;
+
+    int rc = writer_flush(writer);
+    if (writer->owns_fd && close(writer->fd) != 0) rc = -1;
+
+    free(writer->buf);
+    free(writer);
+    return rc;
+}
@@ -0,0 +1,277 @@
+/*
+ * Provides on-disk zone maps for range WHERE filters (--build-zonemap).
+ * A zone map splits the records of a source into blocks of
+ * ZONEMAP_BLOCK_ROWS and stores, per block, its byte range, the smallest
+ * and largest value of one column (as the WHERE operators <, <=, >, >=
+ * read it, with atof) and how many of its cells are missing or empty. A
+ * streamed range filter then seeks past every block whose summary rules it
+ * out, without tokenizing those records. Like indexes, a zone map records
+ * the source's identity and is ignored once the source changes.
+ *
+ * AUTHOR: Billy
+ * DATE: October 16, 2026
+ * VERSION: v2.1.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "../include/zonemap.h"
+#include "../include/row.h"
+#include "../include/writer.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ZONEMAP_MAGIC "CSVLZMP1"
+#define ZONEMAP_VERSION 1
+#define ZONEMAP_BYTE_ORDER 0x01020304u
+
+// Initial number of blocks collected while building
+#define ZONEMAP_INITIAL_BLOCKS 64
+
+// File header, followed by num_blocks blocks
+typedef struct ZoneMapHeader {
+    char magic[8];  // ZONEMAP_MAGIC
+    uint32_t version;  // ZONEMAP_VERSION
+    uint32_t byte_order;  // ZONEMAP_BYTE_ORDER as stored by the writer
+    uint32_t column;  // summarized column
+    uint32_t reserved;  // 0
+    uint64_t block_rows;  // records per block (the last one may hold fewer)
+    uint64_t num_blocks;  // number of blocks
+    CacheKey key;  // identity of the source file
+} ZoneMapHeader;
+
+struct ZoneMap {
+    void *data;  // mapped zone map file
+    size_t size;  // size of the mapping
+    uint64_t num_blocks;  // number of blocks
+    const ZoneBlock *blocks;  // blocks in file order
+};
+
+/*
+ * Internal helper: builds "<source_path>.<column>.zmap", plus an optional
+ * extra suffix.
+ *
+ * RETURN: newly allocated path, NULL on allocation failure
+ */
+static char *zonemap_path(const char *source_path, int column, const char *extra) {
+    size_t len = strlen(source_path) + strlen(extra) + 32;
+    char *path = malloc(len);
+    if (path == NULL) return NULL;
+
+    snprintf(path, len, "%s.%d%s%s", source_path, column, ZONEMAP_SUFFIX, extra);
+    return path;
+}
+
+/*
+ * Internal helper: starts an empty block at a record offset.
+ */
+static void open_block(ZoneBlock *block, size_t start) {
+    memset(block, 0, sizeof(ZoneBlock));
+    block->start = start;
+    block->min_value = INFINITY;
+    block->max_value = -INFINITY;
+}
+
+/*
+ * Builds the zone map of one column and writes it next to the source file.
+ * The file is written under a temporary name and renamed into place only
+ * if the source still has the identity it was read with.
+ *
+ * parameters:
+ * - reader: mapped reader positioned after the header
+ * - column: column to summarize (any column; text cells count as atof() does)
+ * - source_path: path of the CSV file the reader maps
+ * - key: identity of the source taken before it was mapped
+ *
+ * RETURN: 0 on success, -1 on bad input, read or write failure, or if the
+ *         source changed while it was being read
+ */
+int zonemap_build(CsvReader *reader, int column, const char *source_path, const CacheKey *key) {
+    if (reader == NULL || column < 0 || source_path == NULL || key == NULL) return -1;
+
+    ZoneBlock *blocks = malloc(ZONEMAP_INITIAL_BLOCKS * sizeof(ZoneBlock));
+    size_t count = 0;
+    size_t cap = ZONEMAP_INITIAL_BLOCKS;
+    Row *row;
+    while (blocks != NULL && (row = csv_reader_next(reader)) != NULL) {
+        size_t offset = csv_reader_offset(reader);
+
+        // a record past a full block closes it and starts the next one
+        if (count == 0 || blocks[count - 1].num_rows == ZONEMAP_BLOCK_ROWS) {
+            if (count == cap) {
+                ZoneBlock *grown = realloc(blocks, cap * 2 * sizeof(ZoneBlock));
+                if (grown == NULL) {
+                    row_free(row);
+                    free(blocks);
+                    blocks = NULL;
+                    break;
+                }
+                blocks = grown;
+                cap *= 2;
+            }
+            if (count > 0) blocks[count - 1].end = offset;
+            open_block(&blocks[count++], offset);
+        }
+
+        // NaN cells never match an ordering test, so they stay out of the range
+        ZoneBlock *block = &blocks[count - 1];
+        const char *cell = row_get_cell(row, column);
+        if (cell == NULL || *cell == '\0') {
+            block->num_empty++;
+        } else {
+            double value = atof(cell);
+            if (value < block->min_value) block->min_value = value;
+            if (value > block->max_value) block->max_value = value;
+        }
+        block->num_rows++;
+        row_free(row);
+    }
+    if (blocks == NULL || csv_reader_failed(reader)) {
+        free(blocks);
+        return -1;
+    }
+    if (count > 0) blocks[count - 1].end = key->size;
+
+    ZoneMapHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ZONEMAP_MAGIC, sizeof(header.magic));
+    header.version = ZONEMAP_VERSION;
+    header.byte_order = ZONEMAP_BYTE_ORDER;
+    header.column = (uint32_t)column;
+    header.block_rows = ZONEMAP_BLOCK_ROWS;
+    header.num_blocks = count;
+    header.key = *key;
+
+    char *path = zonemap_path(source_path, column, "");
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%ld", (long)getpid());
+    char *tmp_path = zonemap_path(source_path, column, suffix);
+    Writer *out = (path != NULL && tmp_path != NULL) ? writer_open_path(tmp_path) : NULL;
+
+    int result = -1;
+    if (out != NULL) {
+        writer_write(out, (const char *)&header, sizeof(header));
+        writer_write(out, (const char *)blocks, count * sizeof(ZoneBlock));
+        // a source rewritten while it was read must not be summarized under the old key
+        result = writer_close(out);
+        if (result == 0) {
+            result = cache_commit(tmp_path, path, source_path, key);
+        } else {
+            unlink(tmp_path);
+        }
+    }
+
+    free(blocks);
+    free(path);
+    free(tmp_path);
+    return result;
+}
+
+/*
+ * Maps the zone map of a column and checks that it belongs to the given
+ * source identity and that its blocks are ordered byte ranges of the source.
+ *
+ * parameters:
+ * - source_path: path of the CSV file
+ * - column: summarized column
+ * - key: current identity of the source (from cache_key)
+ *
+ * RETURN: pointer to new ZoneMap on success, NULL if the zone map is
+ *         missing, stale or corrupt
+ */
+ZoneMap *zonemap_open(const char *source_path, int column, const CacheKey *key) {
+    if (source_path == NULL || column < 0 || key == NULL) return NULL;
+
+    char *path = zonemap_path(source_path, column, "");
+    if (path == NULL) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    free(path);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(ZoneMapHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (data == MAP_FAILED) return NULL;
+
+    // the blocks must fill the rest of the file exactly
+    const ZoneMapHeader *header = data;
+    size_t size = (size_t)st.st_size;
+    int valid = memcmp(header->magic, ZONEMAP_MAGIC, sizeof(header->magic)) == 0 &&
+                header->version == ZONEMAP_VERSION && header->byte_order == ZONEMAP_BYTE_ORDER &&
+                header->column == (uint32_t)column && memcmp(&header->key, key, sizeof(CacheKey)) == 0 &&
+                header->block_rows >= 1 &&
+                header->num_blocks == (size - sizeof(ZoneMapHeader)) / sizeof(ZoneBlock) &&
+                sizeof(ZoneMapHeader) + header->num_blocks * sizeof(ZoneBlock) == size;
+
+    // readers can only be sent forward through the source
+    const ZoneBlock *blocks = (const ZoneBlock *)(header + 1);
+    uint64_t previous_end = 0;
+    for (uint64_t i = 0; valid && i < header->num_blocks; i++) {
+        valid = blocks[i].start >= previous_end && blocks[i].start <= blocks[i].end &&
+                blocks[i].end <= key->size;
+        previous_end = blocks[i].end;
+    }
+
+    ZoneMap *zonemap = valid ? malloc(sizeof(ZoneMap)) : NULL;
+    if (zonemap == NULL) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    zonemap->data = data;
+    zonemap->size = size;
+    zonemap->num_blocks = header->num_blocks;
+    zonemap->blocks = blocks;
+    return zonemap;
+}
+
+/*
+ * Returns the number of blocks.
+ *
+ * parameters:
+ * - zonemap: zone map from zonemap_open
+ *
+ * RETURN: number of blocks, 0 if zonemap is NULL
+ */
+size_t zonemap_num_blocks(const ZoneMap *zonemap) {
+    return zonemap != NULL ? (size_t)zonemap->num_blocks : 0;
+}
+
+/*
+ * Returns one block summary.
+ *
+ * parameters:
+ * - zonemap: zone map from zonemap_open
+ * - i: block number, in file order
+ *
+ * RETURN: pointer into the mapping, NULL if zonemap is NULL or i is out of bounds
+ */
+const ZoneBlock *zonemap_block(const ZoneMap *zonemap, size_t i) {
+    if (zonemap == NULL || i >= zonemap->num_blocks) return NULL;
+    return &zonemap->blocks[i];
+}
+
+/*
+ * Unmaps a zone map.
+ *
+ * parameters:
+ * - zonemap: zone map to close (safe to pass NULL)
+ */
+void zonemap_close(ZoneMap *zonemap) {
+    if (zonemap == NULL) return;
+
+    munmap(zonemap->data, zonemap->size);
+    free(zonemap);
+}
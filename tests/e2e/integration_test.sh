@@ -254,5 +254,95 @@ test "ORDER BY numeric index with direction" \
     "$BINARY --file $TEST_FILE --order-by 1:desc" \
     "Should handle numeric index with direction in ORDER BY"
 
+# Test 35: Parallel load
+test "ORDER BY with parallel load" \
+    "$BINARY --file $TEST_FILE --threads 4 --order-by age" \
+    "Should match the single-threaded ORDER BY output"
+
+# Test 36: Invalid thread count
+test "Invalid thread count" \
+    "$BINARY --file $TEST_FILE --threads 0 2>&1" \
+    "Should show error for invalid thread count"
+
+# Test 37: Output file
+test "Output to file" \
+    "$BINARY --file $TEST_FILE --where 'age>25' --output test_integration_out.csv && cat test_integration_out.csv && rm -f test_integration_out.csv" \
+    "Should write the filtered rows to the output file"
+
+# Test 38: Column-oriented engine
+test "Columnar GROUP BY and ORDER BY" \
+    "$BINARY --file $TEST_FILE --columnar --where 'salary>50000' --group-by department --order-by salary:desc --select department,salary" \
+    "Should match the row-based engine output"
+
+# Test 39: Parsed-table cache (first run writes the image, second run maps it)
+test "Cached query" \
+    "cp $TEST_FILE test_integration_cache.csv && $BINARY --file test_integration_cache.csv --cache --order-by age:desc && $BINARY --file test_integration_cache.csv --cache --order-by age:desc && ls test_integration_cache.csv.cache && rm -f test_integration_cache.csv test_integration_cache.csv.cache" \
+    "Should print the same sorted rows twice and keep the cache file"
+
+# Test 40: Hash index for equality WHERE
+test "Indexed equality WHERE" \
+    "$BINARY --file $TEST_FILE --build-index department && $BINARY --file $TEST_FILE --where 'department==Sales' && rm -f $TEST_FILE.2.idx" \
+    "Should show Bob and Eve, read through the department index"
+
+# Test 41: Zone map for range WHERE
+test "Zone-mapped range WHERE" \
+    "$BINARY --file $TEST_FILE --build-zonemap salary && $BINARY --file $TEST_FILE --where 'salary>=60000' && $BINARY --file $TEST_FILE --where 'salary>90000' && rm -f $TEST_FILE.3.zmap" \
+    "Should show Alice, Charlie and Diana, then only the header (the one block is skipped)"
+
+# Test 42: Gzip-compressed input
+test "Gzip-compressed file" \
+    "gzip -c $TEST_FILE > $TEST_FILE.gz && $BINARY --file $TEST_FILE.gz --where 'age>=28' --order-by salary; rm -f $TEST_FILE.gz" \
+    "Should show Diana and Bob, sorted by salary, read from the compressed copy"
+
+# Test 43: io_uring reads
+test "io_uring file reads" \
+    "$BINARY --file $TEST_FILE --io-uring --where 'age>=28' --order-by salary" \
+    "Should show Diana and Bob, sorted by salary (same as without --io-uring)"
+
+# Test 44: Row limit and offset
+test "Limit and offset" \
+    "$BINARY --file $TEST_FILE --limit 2 && $BINARY --file $TEST_FILE --order-by salary:desc --offset 1 --limit 2" \
+    "Should show Alice and Bob, then Alice and Diana (second and third highest salary)"
+
+# Test 45: Parallel ORDER BY
+test "Parallel ORDER BY" \
+    "awk 'BEGIN { print \"id,score\"; for (i = 0; i < 100000; i++) print i \",\" (i * 7919) % 1000 }' > test_integration_sort.csv && $BINARY --file test_integration_sort.csv --order-by score:desc > test_integration_sort.1 && $BINARY --file test_integration_sort.csv --threads 4 --order-by score:desc > test_integration_sort.4 && cmp test_integration_sort.1 test_integration_sort.4 && echo identical; rm -f test_integration_sort.csv test_integration_sort.1 test_integration_sort.4" \
+    "Should print identical (4 sort threads give the single-threaded order)"
+
+# Test 46: External ORDER BY
+test "External ORDER BY" \
+    "awk 'BEGIN { print \"id,score,name\"; for (i = 0; i < 100000; i++) print i \",\" (i * 7919) % 1000 \",name\" i }' > test_integration_sort.csv && $BINARY --file test_integration_sort.csv --order-by score:desc > test_integration_sort.1 && $BINARY --file test_integration_sort.csv --memory-limit 1M --order-by score:desc > test_integration_sort.ext && cmp test_integration_sort.1 test_integration_sort.ext && echo identical; rm -f test_integration_sort.csv test_integration_sort.1 test_integration_sort.ext" \
+    "Should print identical (sorted runs spilled to disk merge into the in-memory order)"
+
+# Test 47: Multi-column ORDER BY
+test "Multi-column ORDER BY" \
+    "$BINARY --file $TEST_FILE --order-by age:asc,department:desc,salary --select name,age,department,salary" \
+    "Should sort by age, then department descending, then salary (Eve, Alice, Charlie, Diana, Bob)"
+
+# Test 48: Quote inside an unquoted field
+test "Mid-field quote" \
+    "printf 'id,desc,qty\\n1,12\" ruler,3\\n2,pen,5\\n3,cup,7\\n' > test_integration_quote.csv && gzip -c test_integration_quote.csv > test_integration_quote.csv.gz && $BINARY --file test_integration_quote.csv | cmp - test_integration_quote.csv && $BINARY - < test_integration_quote.csv | cmp - test_integration_quote.csv && $BINARY --file test_integration_quote.csv --threads 4 | cmp - test_integration_quote.csv && $BINARY --file test_integration_quote.csv.gz | cmp - test_integration_quote.csv && echo identical; rm -f test_integration_quote.csv test_integration_quote.csv.gz" \
+    "Should print identical (the quote in 12\" ruler is kept as text, so all 4 rows print as in the input)"
+
+# Test 49: Output to the input file
+test "Output to the input file" \
+    "cp $TEST_FILE test_integration_same.csv && $BINARY --file test_integration_same.csv --order-by age --output test_integration_same.csv; echo \"rc=\$?\"; cmp test_integration_same.csv $TEST_FILE && echo unchanged; rm -f test_integration_same.csv" \
+    "Should show an error and rc=1, then unchanged (the input is not truncated)"
+
+# Test 50: Decimals sort by value
+test "Decimal ORDER BY" \
+    "printf 'a\\n9.5\\n10.25\\n100\\n2\\n' > test_integration_dec.csv && $BINARY --file test_integration_dec.csv --order-by a && $BINARY --file test_integration_dec.csv --columnar --order-by a:desc && $BINARY --file test_integration_dec.csv --memory-limit 1M --order-by a; rm -f test_integration_dec.csv" \
+    "Should show 2, 9.5, 10.25, 100 (by value), then the reverse with --columnar, then the same order with --memory-limit"
+
+# Test 51: Sidecar builds take no query options
+test "Build index with a query" \
+    "$BINARY --file $TEST_FILE --build-index name --where 'age>30'; echo \"rc=\$?\"; ls $TEST_FILE.name.idx 2>/dev/null || echo 'no index'" \
+    "Should show an error and rc=1, then no index (the query is not silently dropped)"
+
+# Test 52: Unusable spill directory
+test "ORDER BY with an unusable TMPDIR" \
+    "TMPDIR=/nonexistent/csvlite $BINARY --file $TEST_FILE --order-by age --memory-limit 1M > test_integration_spill.csv; echo \"rc=\$?\"; wc -c < test_integration_spill.csv; rm -f test_integration_spill.csv" \
+    "Should show an error and rc=1, then 0 (nothing is written, not even the header)"
+
 echo "=== Tests Complete ==="
 echo "Tests run: $TESTS_RUN"
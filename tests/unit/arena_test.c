@@ -0,0 +1,140 @@
+/*
+* Unit tests for the arena allocator
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#include "../../include/arena.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Test 1: Allocations are aligned, distinct and writable
+void test_arena_alloc(void) {
+     Arena *arena = arena_new(1024);
+     TEST(arena != NULL, "arena_new() succeeds", "arena_new() fails");
+
+     char *a = arena_alloc(arena, 3);
+     char *b = arena_alloc(arena, 40);
+     TEST(a != NULL && b != NULL && a != b, "arena_alloc() returns distinct blocks", "arena_alloc() failed");
+     TEST(((uintptr_t)a % 16) == 0 && ((uintptr_t)b % 16) == 0,
+          "arena_alloc() aligns to 16 bytes",
+          "arena_alloc() misaligned"
+     );
+     memset(a, 'x', 3);
+     memset(b, 'y', 40);
+     TEST(a[2] == 'x' && b[0] == 'y' && b[39] == 'y', "allocations do not overlap", "allocations overlap");
+
+     char *s = arena_strdup(arena, "hello");
+     TEST(s != NULL && strcmp(s, "hello") == 0, "arena_strdup() copies string", "arena_strdup() wrong");
+
+     TEST(arena_alloc(NULL, 8) == NULL && arena_strdup(arena, NULL) == NULL,
+          "NULL input returns NULL",
+          "NULL input did not return NULL"
+     );
+     arena_free(arena);
+     arena_free(NULL); // safe to pass NULL
+     printf("Test 1: arena_alloc() - Complete\n\n");
+}
+
+// Test 2: Statistics, large allocations and reset
+void test_arena_stats_and_reset(void) {
+     Arena *arena = arena_new(1024);
+     ArenaStats stats;
+
+     for (int i = 0; i < 100; i++) arena_alloc(arena, 100);
+     char *big = arena_alloc(arena, 4096); // larger than a block
+     TEST(big != NULL, "large allocation succeeds", "large allocation fails");
+     memset(big, 0, 4096);
+
+     arena_stats(arena, &stats);
+     TEST(stats.num_allocs == 101 && stats.bytes_requested == 100 * 100 + 4096,
+          "stats count allocations and bytes",
+          "stats allocation counts wrong"
+     );
+     TEST(stats.num_blocks > 1 && stats.bytes_reserved >= stats.bytes_requested &&
+          stats.peak_reserved == stats.bytes_reserved,
+          "stats track blocks and reserved bytes",
+          "stats block counts wrong"
+     );
+
+     arena_reset(arena);
+     arena_stats(arena, &stats);
+     TEST(stats.num_blocks == 1 && stats.num_resets == 1 && stats.peak_reserved > stats.bytes_reserved,
+          "arena_reset() keeps one block and the peak",
+          "arena_reset() stats wrong"
+     );
+     TEST(arena_alloc(arena, 100) != NULL, "arena usable after reset", "arena unusable after reset");
+
+     arena_stats(NULL, &stats);
+     TEST(stats.num_allocs == 0 && stats.bytes_reserved == 0, "stats of NULL arena are zero", "stats of NULL arena not zero");
+     arena_free(arena);
+     printf("Test 2: arena_stats() and arena_reset() - Complete\n\n");
+}
+
+// Test 3: Adopting a child arena keeps its allocations alive
+void test_arena_adopt(void) {
+     Arena *parent = arena_new(0);
+     Arena *child = arena_new(0);
+     char *kept = arena_strdup(child, "from child");
+     arena_strdup(parent, "from parent");
+
+     arena_adopt(parent, child);
+     ArenaStats stats;
+     arena_stats(parent, &stats);
+     TEST(strcmp(kept, "from child") == 0 && stats.num_allocs == 2 && stats.num_blocks == 2,
+          "arena_adopt() moves blocks and stats",
+          "arena_adopt() wrong"
+     );
+     TEST(arena_alloc(parent, 16) != NULL, "parent usable after adopt", "parent unusable after adopt");
+     arena_adopt(parent, NULL); // safe to pass NULL
+     arena_free(parent);
+     printf("Test 3: arena_adopt() - Complete\n\n");
+}
+
+// Test 4: Current arena is per thread and cleared when freed
+void test_arena_current(void) {
+     TEST(arena_current() == NULL, "no current arena by default", "current arena set by default");
+
+     Arena *arena = arena_new(0);
+     arena_set_current(arena);
+     TEST(arena_current() == arena, "arena_set_current() sets arena", "arena_set_current() failed");
+
+     arena_free(arena);
+     TEST(arena_current() == NULL, "arena_free() clears current arena", "arena_free() left dangling current arena");
+     printf("Test 4: arena_current() - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Arena Unit Tests ===\n\n");
+
+     test_arena_alloc();
+     test_arena_stats_and_reset();
+     test_arena_adopt();
+     test_arena_current();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
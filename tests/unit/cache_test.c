@@ -0,0 +1,181 @@
+/*
+* Unit tests for the parsed-table cache
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/cache.h"
+#include "../../include/table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Appends one record whose cells are given as separate strings
+static void append_cells(Table *table, const char **cells, int count) {
+     char line[256];
+     uint32_t offsets[8];
+     size_t len = 0;
+     for (int i = 0; i < count; i++) {
+          offsets[i] = (uint32_t)len;
+          size_t n = strlen(cells[i]) + 1;
+          memcpy(line + len, cells[i], n);
+          len += n;
+     }
+     table_append_row(table, line, offsets, count);
+}
+
+// Builds the table of a small file: header plus three records (the last one short)
+static Table *make_table(void) {
+     Table *table = table_new(3);
+     append_cells(table, (const char *[]){ "id", "name", "score" }, 3);
+     append_cells(table, (const char *[]){ "1", "Alice", "9.5" }, 3);
+     append_cells(table, (const char *[]){ "2", "Bob", "7" }, 3);
+     append_cells(table, (const char *[]){ "3", "Cara" }, 2);
+     table_infer_types(table);
+     return table;
+}
+
+// Creates an empty source file and returns its path in path
+static void make_source(char *path) {
+     int fd = mkstemp(path);
+     if (fd >= 0) {
+          if (write(fd, "id,name,score\n", 14) != 14) perror("write");
+          close(fd);
+     }
+}
+
+// Removes a source file and its cache image
+static void remove_source(const char *path) {
+     char cache_path[256];
+     snprintf(cache_path, sizeof(cache_path), "%s%s", path, CACHE_SUFFIX);
+     unlink(cache_path);
+     unlink(path);
+}
+
+// Test 1: An image round-trips cells, types and values
+void test_cache_round_trip(void) {
+     char path[] = "/tmp/cache_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     TEST(cache_key(path, &key) == 0, "cache_key() succeeds", "cache_key() fails");
+     TEST(cache_open(path, &key) == NULL, "no image before the first save", "image found before saving");
+
+     Table *table = make_table();
+     TEST(cache_save(path, &key, table) == 0, "cache_save() succeeds", "cache_save() fails");
+     table_free(table);
+
+     CacheImage *image = cache_open(path, &key);
+     Table *cached = cache_table(image);
+     TEST(image != NULL && cached != NULL && table_num_rows(cached) == 4 && table_num_cols(cached) == 3,
+          "cached table has the saved dimensions",
+          "cached table missing or wrong size"
+     );
+     TEST(strcmp(table_get_cell(cached, 0, 2), "score") == 0 && strcmp(table_get_cell(cached, 2, 1), "Bob") == 0 &&
+          table_get_cell(cached, 3, 2) == NULL,
+          "cached cells match, missing cells stay missing",
+          "cached cells differ"
+     );
+     const TableColumn *ids = table_column(cached, 0);
+     const TableColumn *scores = table_column(cached, 2);
+     TEST(ids->type == COLUMN_INT64 && ids->ints[3] == 3 && scores->type == COLUMN_DOUBLE && scores->reals[1] == 9.5 &&
+          table_column(cached, 1)->type == COLUMN_STRING,
+          "column types and native values are cached",
+          "column types or values lost"
+     );
+
+     // operators work on the borrowed columns
+     size_t *rows = table_rows(cached);
+     rows[1] = rows[3];
+     TEST(table_set_num_rows(cached, 2) == 0 && strcmp(table_get_cell(cached, 1, 1), "Cara") == 0,
+          "cached table selection can be changed",
+          "cached table selection broken"
+     );
+     TEST(table_append_row(cached, "x", (const uint32_t[]){ 0 }, 1) == -1 && table_infer_types(cached) == -1,
+          "cached table rejects appends and re-inference",
+          "cached table modified its borrowed columns"
+     );
+     TEST(cache_save(path, &key, cached) == -1, "a narrowed table is not saved", "narrowed table saved");
+     table_free(cached);
+     cache_close(image);
+     cache_close(NULL); // safe to pass NULL
+
+     remove_source(path);
+     printf("Test 1: cache round trip - Complete\n\n");
+}
+
+// Test 2: Stale and damaged images are ignored
+void test_cache_invalid(void) {
+     char path[] = "/tmp/cache_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     cache_key(path, &key);
+     Table *table = make_table();
+     cache_save(path, &key, table);
+     table_free(table);
+
+     CacheKey changed = key;
+     changed.size++;
+     TEST(cache_open(path, &changed) == NULL, "image of a different size is stale", "stale image used");
+     changed = key;
+     changed.mtime_nsec++;
+     TEST(cache_open(path, &changed) == NULL, "image of a different mtime is stale", "stale image used");
+     table = make_table();
+     TEST(cache_save(path, &changed, table) == -1 && cache_open(path, &key) != NULL,
+          "a source changed during the parse is not saved",
+          "image saved for a changed source"
+     );
+     table_free(table);
+
+     // cut the image short
+     char cache_path[256];
+     snprintf(cache_path, sizeof(cache_path), "%s%s", path, CACHE_SUFFIX);
+     TEST(truncate(cache_path, 100) == 0 && cache_open(path, &key) == NULL,
+          "truncated image is rejected",
+          "truncated image accepted"
+     );
+
+     TEST(cache_key("/nonexistent_dir/data.csv", &key) == -1 && cache_key("/tmp", &key) == -1,
+          "cache_key() rejects missing files and directories",
+          "cache_key() accepted a bad path"
+     );
+     TEST(cache_open(NULL, &key) == NULL && cache_table(NULL) == NULL && cache_save(path, &key, NULL) == -1,
+          "NULL input is rejected",
+          "NULL input accepted"
+     );
+     remove_source(path);
+     printf("Test 2: invalid images - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Cache Unit Tests ===\n\n");
+
+     test_cache_round_trip();
+     test_cache_invalid();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
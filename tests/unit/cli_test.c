@@ -130,7 +130,156 @@ void test_cli_unknown_argument(void) {
     TEST(result == 0, "cli_parse_args returns 0 for unknown argument", "cli_parse_args did not fail for unknown argument");
 }
 
-// Test 10: Cleanup resets pointers
+// Test 10: Thread count argument
+void test_cli_threads(void) {
+    cli_init();
+    TEST(g_threads == 1, "g_threads is 1 by default", "g_threads not 1 by default");
+
+    char* argv[] = { "csvlite", "--threads", "8" };
+    int result = cli_parse_args(3, argv);
+    TEST(result == 1 && g_threads == 8, "--threads parsed successfully", "Failed to parse --threads");
+
+    cli_init();
+    char* bad_argv[] = { "csvlite", "--threads", "0" };
+    result = cli_parse_args(3, bad_argv);
+    TEST(result == 0 && g_threads == 1, "--threads rejects 0", "--threads accepted 0");
+
+    cli_init();
+    char* text_argv[] = { "csvlite", "--threads", "4x" };
+    result = cli_parse_args(3, text_argv);
+    TEST(result == 0, "--threads rejects non-numeric value", "--threads accepted non-numeric value");
+
+    cli_init();
+    char* missing_argv[] = { "csvlite", "--threads" };
+    result = cli_parse_args(2, missing_argv);
+    TEST(result == 0, "--threads requires a value", "--threads accepted missing value");
+}
+
+// Test 11: Output file and engine arguments
+void test_cli_output(void) {
+    cli_init();
+    TEST(g_output_path == NULL, "g_output_path is NULL by default", "g_output_path not NULL by default");
+
+    char* argv[] = { "csvlite", "--file", "data.csv", "--output", "out.csv" };
+    int result = cli_parse_args(5, argv);
+    TEST(result == 1 && g_output_path != NULL && strcmp(g_output_path, "out.csv") == 0,
+         "--output parsed successfully", "Failed to parse --output");
+
+    cli_init();
+    char* columnar_argv[] = { "csvlite", "--columnar" };
+    result = cli_parse_args(2, columnar_argv);
+    TEST(result == 1 && g_columnar == 1, "--columnar parsed successfully", "Failed to parse --columnar");
+
+    cli_init();
+    char* cache_argv[] = { "csvlite", "--file", "data.csv", "--cache" };
+    result = cli_parse_args(4, cache_argv);
+    TEST(result == 1 && g_cache == 1, "--cache parsed successfully", "Failed to parse --cache");
+
+    cli_init();
+    char* uring_argv[] = { "csvlite", "--file", "data.csv", "--io-uring" };
+    result = cli_parse_args(4, uring_argv);
+    TEST(result == 1 && g_io_uring == 1, "--io-uring parsed successfully", "Failed to parse --io-uring");
+
+    cli_init();
+    char* index_argv[] = { "csvlite", "--file", "data.csv", "--build-index", "id" };
+    result = cli_parse_args(5, index_argv);
+    TEST(result == 1 && g_build_index_col != NULL && strcmp(g_build_index_col, "id") == 0,
+         "--build-index parsed successfully", "Failed to parse --build-index");
+
+    cli_init();
+    char* index_missing_argv[] = { "csvlite", "--build-index" };
+    result = cli_parse_args(2, index_missing_argv);
+    TEST(result == 0, "--build-index requires a column", "--build-index accepted missing column");
+
+    cli_init();
+    char* zonemap_argv[] = { "csvlite", "--file", "data.csv", "--build-zonemap", "age" };
+    result = cli_parse_args(5, zonemap_argv);
+    TEST(result == 1 && g_build_zonemap_col != NULL && strcmp(g_build_zonemap_col, "age") == 0,
+         "--build-zonemap parsed successfully", "Failed to parse --build-zonemap");
+
+    cli_init();
+    char* zonemap_missing_argv[] = { "csvlite", "--build-zonemap" };
+    result = cli_parse_args(2, zonemap_missing_argv);
+    TEST(result == 0, "--build-zonemap requires a column", "--build-zonemap accepted missing column");
+
+    cli_init();
+    char* index_where_argv[] = { "csvlite", "--file", "data.csv", "--build-index", "id", "--where", "id==1" };
+    result = cli_parse_args(7, index_where_argv);
+    TEST(result == 0, "--build-index rejects query options", "--build-index accepted --where");
+
+    cli_init();
+    char* zonemap_order_argv[] = { "csvlite", "--file", "data.csv", "--order-by", "age", "--build-zonemap", "age" };
+    result = cli_parse_args(7, zonemap_order_argv);
+    TEST(result == 0, "--build-zonemap rejects query options", "--build-zonemap accepted --order-by");
+
+    cli_init();
+    char* missing_argv[] = { "csvlite", "--output" };
+    result = cli_parse_args(2, missing_argv);
+    TEST(result == 0, "--output requires a value", "--output accepted missing value");
+}
+
+// Test 12: Row limit and offset arguments
+void test_cli_limit(void) {
+    cli_init();
+    TEST(g_limit == -1 && g_offset == 0, "no limit or offset by default", "limit or offset set by default");
+
+    char* argv[] = { "csvlite", "--file", "data.csv", "--limit", "100", "--offset", "20" };
+    int result = cli_parse_args(7, argv);
+    TEST(result == 1 && g_limit == 100 && g_offset == 20, "--limit and --offset parsed successfully",
+         "Failed to parse --limit/--offset");
+
+    cli_init();
+    char* zero_argv[] = { "csvlite", "--limit", "0" };
+    result = cli_parse_args(3, zero_argv);
+    TEST(result == 1 && g_limit == 0, "--limit accepts 0", "--limit rejected 0");
+
+    cli_init();
+    char* bad_argv[] = { "csvlite", "--limit", "-5" };
+    result = cli_parse_args(3, bad_argv);
+    TEST(result == 0 && g_limit == -1, "--limit rejects negative counts", "--limit accepted a negative count");
+
+    cli_init();
+    char* text_argv[] = { "csvlite", "--offset", "ten" };
+    result = cli_parse_args(3, text_argv);
+    TEST(result == 0 && g_offset == 0, "--offset rejects non-numeric value", "--offset accepted non-numeric value");
+
+    cli_init();
+    char* missing_argv[] = { "csvlite", "--limit" };
+    result = cli_parse_args(2, missing_argv);
+    TEST(result == 0, "--limit requires a value", "--limit accepted missing value");
+}
+
+// Test 13: Memory limit argument
+void test_cli_memory_limit(void) {
+    cli_init();
+    TEST(g_memory_limit == 0, "g_memory_limit is 0 by default", "g_memory_limit not 0 by default");
+
+    char* argv[] = { "csvlite", "--memory-limit", "512M" };
+    int result = cli_parse_args(3, argv);
+    TEST(result == 1 && g_memory_limit == (size_t)512 << 20, "--memory-limit parses a size suffix", "Failed to parse --memory-limit 512M");
+
+    cli_init();
+    char* bytes_argv[] = { "csvlite", "--memory-limit", "4096" };
+    result = cli_parse_args(3, bytes_argv);
+    TEST(result == 1 && g_memory_limit == 4096, "--memory-limit parses plain bytes", "Failed to parse --memory-limit 4096");
+
+    cli_init();
+    char* zero_argv[] = { "csvlite", "--memory-limit", "0" };
+    result = cli_parse_args(3, zero_argv);
+    TEST(result == 0 && g_memory_limit == 0, "--memory-limit rejects 0", "--memory-limit accepted 0");
+
+    cli_init();
+    char* negative_argv[] = { "csvlite", "--memory-limit", "-1" };
+    result = cli_parse_args(3, negative_argv);
+    TEST(result == 0, "--memory-limit rejects negative size", "--memory-limit accepted negative size");
+
+    cli_init();
+    char* suffix_argv[] = { "csvlite", "--memory-limit", "5X" };
+    result = cli_parse_args(3, suffix_argv);
+    TEST(result == 0, "--memory-limit rejects unknown suffix", "--memory-limit accepted unknown suffix");
+}
+
+// Test 14: Cleanup resets pointers
 void test_cli_cleanup(void) {
     cli_init();
     char* argv[] = { "csvlite", "--file", "data.csv", "--select", "name" };
@@ -157,6 +306,10 @@ int main(void) {
     test_cli_group_and_order();
     test_cli_missing_file_value();
     test_cli_unknown_argument();
+    test_cli_threads();
+    test_cli_output();
+    test_cli_limit();
+    test_cli_memory_limit();
     test_cli_cleanup();
 
     printf("\n=== Test Summary ===\n");
@@ -6,6 +6,8 @@
 * VERSION: v2.0.0
 */
 
+#define _DEFAULT_SOURCE  // open_memstream
+
 #include "../../include/csv.h"
 #include "../../include/vec.h"
 #include "../../include/row.h"
@@ -134,6 +136,571 @@ static void test_csv_read_whitespace_and_missing(void) {
     free_rows(rows);
 }
 
+// Test: csv_read_mapped parses a mapped file like csv_read
+static void test_csv_read_mapped(void) {
+    const char *path = "test_csv_mapped.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for csv_read_mapped test", "failed to create file for csv_read_mapped");
+    if (!f) return;
+
+    // last line deliberately has no trailing newline
+    fputs(" name , age , city \n\nAlice,30,Seattle\nBob,25,", f);
+    fclose(f);
+
+    CsvMap* map = csv_map_open(path);
+    TEST(map != NULL, "csv_map_open maps regular file", "csv_map_open failed on regular file");
+    if (!map) {
+        remove(path);
+        return;
+    }
+
+    Vec* rows = csv_read_mapped(map);
+    TEST(rows != NULL && vec_length(rows) == 3, "csv_read_mapped keeps header and two data rows",
+         "csv_read_mapped wrong row count");
+    if (rows) {
+        Row* header = vec_get(rows, 0);
+        Row* bob = vec_get(rows, 2);
+        TEST(strcmp(row_get_cell(header, 0), "name") == 0 && strcmp(row_get_cell(header, 2), "city") == 0,
+             "mapped header cells trimmed correctly", "mapped header cells not trimmed correctly");
+        TEST(strcmp(row_get_cell(bob, 1), "25") == 0 && strcmp(row_get_cell(bob, 2), "") == 0,
+             "mapped unterminated last line parsed", "mapped unterminated last line wrong");
+        free_rows(rows);
+    }
+
+    csv_map_close(map);
+    remove(path);
+
+    TEST(csv_map_open("data/does_not_exist.csv") == NULL, "csv_map_open fails for missing file",
+         "csv_map_open did not fail for missing file");
+    TEST(csv_read_mapped(NULL) == NULL, "csv_read_mapped returns NULL for NULL map",
+         "csv_read_mapped did not return NULL for NULL map");
+}
+
+// Test: csv_reader_offset/csv_reader_seek jump between records of a mapped file
+static void test_csv_reader_seek(void) {
+    const char *path = "test_csv_seek.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for seek test", "failed to create file for seek test");
+    if (!f) return;
+    fputs("id,note\n1,\"multi\nline\"\n\n2,two\n3,three", f);
+    fclose(f);
+
+    CsvMap* map = csv_map_open(path);
+    CsvReader* reader = csv_reader_open_mapped(map);
+    size_t offsets[4] = {0};
+    Row* row;
+    int n = 0;
+    while (n < 4 && (row = csv_reader_next(reader)) != NULL) {
+        offsets[n++] = csv_reader_offset(reader);
+        row_free(row);
+    }
+    TEST(n == 4 && offsets[0] == 0 && offsets[1] == 8 && offsets[2] == 24 && offsets[3] == 30,
+         "csv_reader_offset reports record starts (blank lines skipped)", "csv_reader_offset wrong");
+    csv_reader_close(reader);
+    csv_map_close(map);
+
+    // a fresh mapping, read out of order but forward
+    map = csv_map_open(path);
+    reader = csv_reader_open_mapped(map);
+    TEST(csv_reader_seek(reader, offsets[3]) == 0 && (row = csv_reader_next(reader)) != NULL &&
+         strcmp(row_get_cell(row, 1), "three") == 0,
+         "csv_reader_seek reads an unterminated last record", "seek to last record failed");
+    row_free(row);
+    TEST(csv_reader_seek(reader, offsets[1]) == 0 && (row = csv_reader_next(reader)) != NULL &&
+         strcmp(row_get_cell(row, 1), "multi\nline") == 0,
+         "csv_reader_seek reads a multi-line record", "seek to multi-line record failed");
+    row_free(row);
+    TEST(csv_reader_seek(reader, 1000) == -1, "csv_reader_seek rejects offsets past the end",
+         "csv_reader_seek accepted an offset past the end");
+    csv_reader_close(reader);
+    csv_map_close(map);
+    remove(path);
+
+    f = tmpfile();
+    reader = f ? csv_reader_open(f) : NULL;
+    TEST(reader != NULL && csv_reader_offset(reader) == SIZE_MAX && csv_reader_seek(reader, 0) == -1,
+         "stream readers have no offsets", "stream reader reported offsets");
+    csv_reader_close(reader);
+    if (f) fclose(f);
+}
+
+// Test: csv_read_table/csv_read_mapped_table load columns and csv_write_table writes them back
+static void test_csv_read_table(void) {
+    const char *path = "test_csv_table.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for table test", "failed to create file for table test");
+    if (!f) return;
+    fputs("name,note\nAlice,\"a, b\"\nBob\n", f);
+    fclose(f);
+
+    f = fopen(path, "r");
+    Table* table = csv_read_table(f);
+    fclose(f);
+    TEST(table != NULL && table_num_rows(table) == 3 && table_num_cols(table) == 2,
+         "csv_read_table loads header and two rows", "csv_read_table wrong shape");
+    if (table) {
+        TEST(strcmp(table_get_cell(table, 1, 1), "a, b") == 0 && table_get_cell(table, 2, 1) == NULL,
+             "csv_read_table unquotes cells and keeps short rows short", "csv_read_table cells wrong");
+        table_free(table);
+    }
+
+    CsvMap* map = csv_map_open(path);
+    table = csv_read_mapped_table(map);
+    csv_map_close(map);  // the table owns copies of the cells
+    FILE* tmp = tmpfile();
+    Writer* writer = tmp ? writer_open_fd(fileno(tmp), 0) : NULL;
+    TEST(table != NULL && writer != NULL && csv_write_table(writer, table) == 0 && writer_close(writer) == 0,
+         "csv_write_table writes a mapped table", "csv_write_table failed");
+    if (tmp) {
+        rewind(tmp);
+        char buffer[128] = {0};
+        fread(buffer, 1, sizeof(buffer) - 1, tmp);
+        TEST(strcmp(buffer, "name,note\nAlice,\"a, b\"\nBob,\n") == 0,
+             "csv_write_table output matches csv_write", "csv_write_table output incorrect");
+        fclose(tmp);
+    }
+    table_free(table);
+    remove(path);
+
+    tmp = tmpfile();
+    table = tmp ? csv_read_table(tmp) : NULL;
+    TEST(table != NULL && table_num_rows(table) == 0, "csv_read_table gives an empty table for empty input",
+         "csv_read_table failed on empty input");
+    table_free(table);
+    if (tmp) fclose(tmp);
+    TEST(csv_read_table(NULL) == NULL && csv_read_mapped_table(NULL) == NULL,
+         "csv_read_table rejects NULL input", "csv_read_table accepted NULL input");
+}
+
+// Test: csv_read_mapped_parallel returns the same rows as a single-threaded load,
+// even when chunk boundaries fall inside quoted fields spanning several lines
+static void test_csv_read_mapped_parallel(void) {
+    const char *path = "test_csv_parallel.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for parallel read test", "failed to create file for parallel read test");
+    if (!f) return;
+
+    fputs("id,note\n", f);
+    for (int i = 0; i < 40000; i++) {
+        if (i % 7 == 0) fprintf(f, "%d,\"line one\nline \"\"two\"\", %d\"\n", i, i);
+        else fprintf(f, "%d,plain note %d\n", i, i);
+    }
+    fclose(f);
+
+    CsvMap* map = csv_map_open(path);
+    CsvMap* par_map = csv_map_open(path);
+    Vec* rows = map ? csv_read_mapped(map) : NULL;
+    Vec* par_rows = par_map ? csv_read_mapped_parallel(par_map, 5) : NULL;
+    TEST(rows != NULL && par_rows != NULL && vec_length(rows) == 40001 && vec_length(par_rows) == 40001,
+         "parallel read returns every row", "parallel read row count wrong");
+
+    int same = (rows != NULL && par_rows != NULL && vec_length(rows) == vec_length(par_rows));
+    for (size_t r = 0; same && r < vec_length(rows); r++) {
+        Row* a = vec_get(rows, r);
+        Row* b = vec_get(par_rows, r);
+        if (row_num_cells(a) != row_num_cells(b) ||
+            strcmp(row_get_cell(a, 0), row_get_cell(b, 0)) != 0 ||
+            strcmp(row_get_cell(a, 1), row_get_cell(b, 1)) != 0) {
+            same = 0;
+        }
+    }
+    TEST(same, "parallel read matches sequential read in order", "parallel read differs from sequential read");
+
+    free_rows(rows);
+    free_rows(par_rows);
+    csv_map_close(map);
+    csv_map_close(par_map);
+    remove(path);
+
+    TEST(csv_read_mapped_parallel(NULL, 4) == NULL, "csv_read_mapped_parallel returns NULL for NULL map",
+         "csv_read_mapped_parallel did not return NULL for NULL map");
+}
+
+// Pushdown used by the projection tests: keeps columns 0 and 2
+static int keep_first_and_third(const Row *header, CsvReader *reader, void *arg) {
+    (void)arg;
+    unsigned char keep[4] = { 1, 0, 1, 0 };
+    return row_num_cells(header) == 4 ? csv_reader_project(reader, keep, 4) : -1;
+}
+
+// Pushdown used by the filter tests: keeps rows passing the condition in arg
+static int filter_by(const Row *header, CsvReader *reader, void *arg) {
+    WhereCond **cond = arg;
+    *cond = where_compile(header, "score<5");
+    return *cond != NULL ? csv_reader_filter(reader, *cond) : -1;
+}
+
+// Test: projected reads parse only the chosen columns of the data rows,
+// on the stream, mapped and parallel paths alike
+static void test_csv_read_projected(void) {
+    const char *path = "test_csv_projected.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for projection test", "failed to create file for projection test");
+    if (!f) return;
+
+    fputs("id,note,score,extra\n", f);
+    for (int i = 0; i < 40000; i++) {
+        if (i % 2) fprintf(f, "%d,\"skip, me\n%d\", \"%d\" ,tail\n", i, i, i % 100);
+        else fprintf(f, "%d,\"skip, me\n%d\", %d ,tail\n", i, i, i % 100);
+    }
+    fputs("short\n", f);
+    fclose(f);
+
+    f = fopen(path, "r");
+    Vec* rows = f ? csv_read_pushdown(f, keep_first_and_third, NULL) : NULL;
+    if (f) fclose(f);
+    CsvMap* map = csv_map_open(path);
+    Vec* par_rows = map ? csv_read_mapped_pushdown(map, 4, keep_first_and_third, NULL) : NULL;
+
+    TEST(rows != NULL && par_rows != NULL && vec_length(rows) == 40002 && vec_length(par_rows) == 40002,
+         "projected reads return every row", "projected read row count wrong");
+
+    int ok = rows != NULL && par_rows != NULL && vec_length(rows) == vec_length(par_rows);
+    for (size_t r = 0; ok && r < vec_length(rows); r++) {
+        Vec* sources[] = { rows, par_rows };
+        for (int s = 0; ok && s < 2; s++) {
+            Row* row = vec_get(sources[s], r);
+            if (r == 0) {
+                ok = row_num_cells(row) == 4 && strcmp(row_get_cell(row, 3), "extra") == 0;
+            } else if (r == 40001) {
+                ok = row_num_cells(row) == 1 && strcmp(row_get_cell(row, 0), "short") == 0;
+            } else {
+                char id[24], score[24];
+                snprintf(id, sizeof(id), "%zu", r - 1);
+                snprintf(score, sizeof(score), "%zu", (r - 1) % 100);
+                ok = row_num_cells(row) == 3 && strcmp(row_get_cell(row, 0), id) == 0 &&
+                     strcmp(row_get_cell(row, 1), "") == 0 && strcmp(row_get_cell(row, 2), score) == 0 &&
+                     row_get_cell(row, 3) == NULL;
+            }
+        }
+    }
+    TEST(ok, "header is whole, data rows keep only columns 0 and 2", "projected rows differ");
+
+    free_rows(rows);
+    free_rows(par_rows);
+    csv_map_close(map);
+
+    // filtered reads keep the rows passing the condition (score is quoted
+    // and blank-padded in the file, and missing on the last line)
+    WhereCond *cond = NULL;
+    WhereCond *par_cond = NULL;
+    f = fopen(path, "r");
+    rows = f ? csv_read_pushdown(f, filter_by, &cond) : NULL;
+    if (f) fclose(f);
+    map = csv_map_open(path);
+    par_rows = map ? csv_read_mapped_pushdown(map, 4, filter_by, &par_cond) : NULL;
+
+    ok = rows != NULL && par_rows != NULL && vec_length(rows) == 2002 && vec_length(par_rows) == 2002;
+    for (size_t r = 1; ok && r < vec_length(rows); r++) {
+        Row* row = vec_get(rows, r);
+        Row* par_row = vec_get(par_rows, r);
+        ok = row_num_cells(row) == row_num_cells(par_row) &&
+             strcmp(row_get_cell(row, 0), row_get_cell(par_row, 0)) == 0 &&
+             (r == 2001 ? strcmp(row_get_cell(row, 0), "short") == 0
+                        : atoi(row_get_cell(row, 2)) < 5 && strcmp(row_get_cell(row, 3), "tail") == 0);
+    }
+    TEST(ok, "filtered reads keep exactly the matching rows, whole", "filtered rows differ");
+
+    free_rows(rows);
+    free_rows(par_rows);
+    where_free(cond);
+    where_free(par_cond);
+    csv_map_close(map);
+    remove(path);
+
+    // a reader can drop its projection again
+    FILE* tmp = tmpfile();
+    if (!tmp) return;
+    fputs("a,b,c\n1,2,3\n4,5,6\n", tmp);
+    rewind(tmp);
+    CsvReader* reader = csv_reader_open(tmp);
+    Row* header = reader ? csv_reader_next(reader) : NULL;
+    row_free(header);
+    unsigned char keep[3] = { 0, 1, 0 };
+    Row* row = csv_reader_project(reader, keep, 3) == 0 ? csv_reader_next(reader) : NULL;
+    TEST(row != NULL && row_num_cells(row) == 2 && strcmp(row_get_cell(row, 0), "") == 0 &&
+         strcmp(row_get_cell(row, 1), "2") == 0,
+         "csv_reader_project limits later rows", "csv_reader_project did not limit rows");
+    row_free(row);
+    row = csv_reader_project(reader, NULL, 3) == 0 ? csv_reader_next(reader) : NULL;
+    TEST(row != NULL && row_num_cells(row) == 3 && strcmp(row_get_cell(row, 2), "6") == 0,
+         "csv_reader_project(NULL) parses whole rows again", "projection not dropped");
+    row_free(row);
+    csv_reader_close(reader);
+    fclose(tmp);
+
+    TEST(csv_reader_project(NULL, keep, 3) == -1 && csv_reader_filter(NULL, NULL) == -1 &&
+         csv_read_mapped_pushdown(NULL, 2, NULL, NULL) == NULL,
+         "projection rejects NULL readers and maps", "projection accepted NULL input");
+}
+
+// Test: csv_read keeps lines longer than one read block intact
+static void test_csv_read_long_line(void) {
+    FILE* tmp = tmpfile();
+    TEST(tmp != NULL, "tmpfile created for long line test", "failed to create tmpfile for long line test");
+    if (!tmp) return;
+
+    const size_t long_len = 3u << 20; // spans several 1 MiB blocks
+    fputs("id,payload\n1,", tmp);
+    for (size_t i = 0; i < long_len; i++) fputc('x', tmp);
+    fputs("\n2,short\n", tmp);
+    rewind(tmp);
+
+    Vec* rows = csv_read(tmp);
+    fclose(tmp);
+
+    TEST(rows != NULL && vec_length(rows) == 3, "long line read as a single row", "long line split into several rows");
+    if (!rows) return;
+
+    const char* payload = row_get_cell(vec_get(rows, 1), 1);
+    TEST(payload != NULL && strlen(payload) == long_len, "long cell kept whole", "long cell truncated");
+    TEST(strcmp(row_get_cell(vec_get(rows, 2), 1), "short") == 0, "row after long line intact", "row after long line corrupted");
+
+    free_rows(rows);
+}
+
+// Test: csv_reader streams rows from a FILE* one at a time
+static void test_csv_reader_stream(void) {
+    FILE* tmp = tmpfile();
+    TEST(tmp != NULL, "tmpfile created for csv_reader test", "failed to create tmpfile for csv_reader");
+    if (!tmp) return;
+
+    fputs("name,age\nAlice,30\n\nBob,25\n", tmp);
+    rewind(tmp);
+
+    CsvReader* reader = csv_reader_open(tmp);
+    TEST(reader != NULL, "csv_reader_open succeeds", "csv_reader_open failed");
+    if (!reader) {
+        fclose(tmp);
+        return;
+    }
+
+    int count = 0;
+    int cells_ok = 1;
+    const char* expected[] = { "name", "Alice", "Bob" };
+    Row* row;
+    while ((row = csv_reader_next(reader)) != NULL) {
+        if (count >= 3 || strcmp(row_get_cell(row, 0), expected[count]) != 0) cells_ok = 0;
+        row_free(row);
+        count++;
+    }
+
+    TEST(count == 3 && cells_ok, "csv_reader_next returns each row in order", "csv_reader_next returned wrong rows");
+    TEST(csv_reader_failed(reader) == 0, "csv_reader ends without error", "csv_reader reported an error at end");
+
+    csv_reader_close(reader);
+    fclose(tmp);
+
+    TEST(csv_reader_open(NULL) == NULL, "csv_reader_open returns NULL for NULL input",
+         "csv_reader_open did not return NULL for NULL input");
+}
+
+// Test: csv_write_row writes selected cells of one row
+static void test_csv_write_row(void) {
+    Vec* rows = build_sample_rows();
+    FILE* tmp = tmpfile();
+    TEST(rows != NULL && tmp != NULL, "setup for csv_write_row", "setup for csv_write_row failed");
+    if (!rows || !tmp) {
+        if (tmp) fclose(tmp);
+        free_rows(rows);
+        return;
+    }
+
+    int indices[] = { 2, 0 };
+    TEST(csv_write_row(tmp, vec_get(rows, 1), indices, 2) == 0, "csv_write_row succeeds", "csv_write_row failed");
+    TEST(csv_write_row(tmp, NULL, NULL, 2) == -1, "csv_write_row fails on NULL row", "csv_write_row accepted NULL row");
+
+    rewind(tmp);
+    char buffer[64] = {0};
+    fread(buffer, 1, sizeof(buffer) - 1, tmp);
+    TEST(strcmp(buffer, "Seattle,Alice\n") == 0, "csv_write_row output matches", "csv_write_row output incorrect");
+
+    fclose(tmp);
+    free_rows(rows);
+}
+
+// Test: RFC 4180 quoted fields, empty fields and CRLF line endings
+static void test_csv_read_quoted(void) {
+    FILE* tmp = tmpfile();
+    TEST(tmp != NULL, "tmpfile created for quoted test", "failed to create tmpfile for quoted test");
+    if (!tmp) return;
+
+    fputs("name,note,city\r\n"
+          "\"Smith, Ann\",\"said \"\"hi\"\"\",Paris\r\n"
+          "Bob,\"two\nlines\",\r\n"
+          "a,,b\n", tmp);
+    rewind(tmp);
+
+    Vec* rows = csv_read(tmp);
+    fclose(tmp);
+    TEST(rows != NULL && vec_length(rows) == 4, "csv_read reads quoted rows", "csv_read quoted row count wrong");
+    if (!rows || vec_length(rows) != 4) {
+        free_rows(rows);
+        return;
+    }
+
+    Row* header = vec_get(rows, 0);
+    Row* r1 = vec_get(rows, 1);
+    Row* r2 = vec_get(rows, 2);
+    Row* r3 = vec_get(rows, 3);
+    TEST(strcmp(row_get_cell(header, 2), "city") == 0, "CRLF stripped from header", "CRLF left in header");
+    TEST(strcmp(row_get_cell(r1, 0), "Smith, Ann") == 0, "quoted comma kept in cell", "quoted comma split cell");
+    TEST(strcmp(row_get_cell(r1, 1), "said \"hi\"") == 0, "doubled quotes unescaped", "doubled quotes not unescaped");
+    TEST(strcmp(row_get_cell(r2, 1), "two\nlines") == 0, "quoted newline kept in cell", "quoted newline split row");
+    TEST(strcmp(row_get_cell(r2, 2), "") == 0, "empty last cell before CRLF", "empty last cell wrong");
+    TEST(row_num_cells(r3) == 3 && strcmp(row_get_cell(r3, 1), "") == 0 && strcmp(row_get_cell(r3, 2), "b") == 0,
+         "empty middle field kept", "empty middle field collapsed");
+
+    free_rows(rows);
+}
+
+// Test: a quote inside an unquoted field is an ordinary character, also when
+// the file is parsed in parallel chunks
+static void test_csv_read_mid_field_quote(void) {
+    FILE* tmp = tmpfile();
+    TEST(tmp != NULL, "tmpfile created for mid-field quote test", "failed to create tmpfile for mid-field quote test");
+    if (!tmp) return;
+
+    fputs("id,desc,qty\n1,12\" ruler,3\n2,pen,5\n3,cup,7\n", tmp);
+    rewind(tmp);
+    Vec* rows = csv_read(tmp);
+    fclose(tmp);
+    TEST(rows != NULL && vec_length(rows) == 4 && strcmp(row_get_cell(vec_get(rows, 1), 1), "12\" ruler") == 0 &&
+         strcmp(row_get_cell(vec_get(rows, 1), 2), "3") == 0 && strcmp(row_get_cell(vec_get(rows, 3), 1), "cup") == 0,
+         "mid-field quote kept literal", "mid-field quote opened a quoted field");
+    free_rows(rows);
+
+    const char *path = "test_csv_mid_quote.csv";
+    FILE* f = fopen(path, "w");
+    TEST(f != NULL, "file created for parallel mid-field quote test", "failed to create file for parallel mid-field quote test");
+    if (!f) return;
+
+    fputs("id,desc,note\n", f);
+    for (int i = 0; i < 40000; i++) {
+        if (i % 5 == 0) fprintf(f, "%d,%d\" ruler,\"a\nb\"\n", i, i);
+        else fprintf(f, "%d,%d\" ruler,plain\n", i, i);
+    }
+    fclose(f);
+
+    CsvMap* map = csv_map_open(path);
+    rows = map ? csv_read_mapped_parallel(map, 5) : NULL;
+    int same = rows != NULL && vec_length(rows) == 40001;
+    for (size_t r = 1; same && r < vec_length(rows); r++) {
+        Row* row = vec_get(rows, r);
+        char desc[32];
+        snprintf(desc, sizeof(desc), "%zu\" ruler", r - 1);
+        if (row_num_cells(row) != 3 || strcmp(row_get_cell(row, 1), desc) != 0 ||
+            strcmp(row_get_cell(row, 2), (r - 1) % 5 == 0 ? "a\nb" : "plain") != 0) {
+            same = 0;
+        }
+    }
+    TEST(same, "parallel read keeps mid-field quotes literal", "parallel read misplaced a mid-field quote");
+
+    free_rows(rows);
+    csv_map_close(map);
+    remove(path);
+}
+
+// Test: csv_write_row quotes cells that would not read back unchanged
+static void test_csv_write_quoting(void) {
+    Row* row = row_new(5);
+    FILE* tmp = tmpfile();
+    TEST(row != NULL && tmp != NULL, "setup for write quoting", "setup for write quoting failed");
+    if (!row || !tmp) {
+        if (tmp) fclose(tmp);
+        if (row) row_free(row);
+        return;
+    }
+
+    row_set_cell(row, 0, "a,b");
+    row_set_cell(row, 1, "say \"x\"");
+    row_set_cell(row, 2, " pad");
+    row_set_cell(row, 3, "\"x\" first");
+    row_set_cell(row, 4, "plain");
+    TEST(csv_write_row(tmp, row, NULL, 5) == 0, "csv_write_row with quoting succeeds", "csv_write_row with quoting failed");
+
+    rewind(tmp);
+    char buffer[128] = {0};
+    fread(buffer, 1, sizeof(buffer) - 1, tmp);
+    TEST(strcmp(buffer, "\"a,b\",say \"x\",\" pad\",\"\"\"x\"\" first\",plain\n") == 0,
+         "csv_write_row quotes special cells", "csv_write_row quoting incorrect");
+
+    rewind(tmp);
+    Vec* rows = csv_read(tmp);
+    Row* back = rows ? vec_get(rows, 0) : NULL;
+    TEST(back != NULL && strcmp(row_get_cell(back, 0), "a,b") == 0 && strcmp(row_get_cell(back, 1), "say \"x\"") == 0
+         && strcmp(row_get_cell(back, 2), " pad") == 0 && strcmp(row_get_cell(back, 3), "\"x\" first") == 0,
+         "quoted output reads back unchanged", "quoted output did not round-trip");
+
+    free_rows(rows);
+    fclose(tmp);
+    row_free(row);
+}
+
+// Test: csv_write and csv_write_row go through stdio, so they work on a
+// stream without a file descriptor and keep the order of other writes
+static void test_csv_write_memstream(void) {
+    Vec* rows = build_sample_rows();
+    char* text = NULL;
+    size_t size = 0;
+    FILE* mem = open_memstream(&text, &size);
+    TEST(rows != NULL && mem != NULL, "setup for memory stream output", "setup for memory stream output failed");
+    if (!rows || !mem) {
+        if (mem) fclose(mem);
+        free(text);
+        free_rows(rows);
+        return;
+    }
+
+    int indices[] = { 2, 0 };
+    fputs("# first\n", mem);
+    int row_rc = csv_write_row(mem, vec_get(rows, 1), indices, 2);
+    fputs("# then\n", mem);
+    int all_rc = csv_write(mem, rows, "city");
+    fclose(mem);
+
+    TEST(row_rc == 0 && all_rc == 0, "csv_write/csv_write_row succeed on a memory stream",
+         "csv_write/csv_write_row failed on a memory stream");
+    TEST(text != NULL && strcmp(text, "# first\nSeattle,Alice\n# then\ncity\nSeattle\nDenver\n") == 0,
+         "memory stream output keeps stdio order", "memory stream output wrong");
+
+    free(text);
+    free_rows(rows);
+}
+
+// Test: csv_write_to formats rows into a buffered Writer
+static void test_csv_write_to_writer(void) {
+    FILE* tmp = tmpfile();
+    Writer* writer = tmp ? writer_open_fd(fileno(tmp), 16) : NULL; // small buffer forces flushes
+    TEST(writer != NULL, "setup for writer output", "setup for writer output failed");
+    if (!writer) {
+        if (tmp) fclose(tmp);
+        return;
+    }
+
+    const char* header_cells[] = { "id", "note" };
+    const char* row_cells[] = { "1", "a \"long\", quoted note that spans the buffer" };
+    Vec* rows = vec_new(2);
+    vec_push(rows, row_new_from_cells(header_cells, 2));
+    vec_push(rows, row_new_from_cells(row_cells, 2));
+
+    TEST(csv_write_to(writer, rows, "note") == 0, "csv_write_to succeeds", "csv_write_to failed");
+    int indices[] = { 1, 0 };
+    TEST(csv_write_row_to(writer, vec_get(rows, 0), indices, 2) == 0, "csv_write_row_to succeeds", "csv_write_row_to failed");
+    TEST(writer_close(writer) == 0, "writer flushes on close", "writer failed on close");
+
+    rewind(tmp);
+    char buffer[128] = {0};
+    fread(buffer, 1, sizeof(buffer) - 1, tmp);
+    TEST(strcmp(buffer, "note\n\"a \"\"long\"\", quoted note that spans the buffer\"\nnote,id\n") == 0,
+         "csv_write_to output matches csv_write", "csv_write_to output incorrect");
+    TEST(csv_write_to(NULL, rows, NULL) == -1 && csv_write_row_to(NULL, vec_get(rows, 0), NULL, 2) == -1,
+         "csv_write_to rejects NULL writer", "csv_write_to accepted NULL writer");
+
+    free_rows(rows);
+    fclose(tmp);
+}
+
 // Test: csv_read handles NULL input
 static void test_csv_read_null_input(void) {
     Vec* rows = csv_read(NULL);
@@ -232,6 +799,19 @@ int main(void) {
     }
 
     test_csv_read_whitespace_and_missing();
+    test_csv_read_mapped();
+    test_csv_read_mapped_parallel();
+    test_csv_read_projected();
+    test_csv_read_table();
+    test_csv_reader_seek();
+    test_csv_read_long_line();
+    test_csv_reader_stream();
+    test_csv_write_row();
+    test_csv_read_quoted();
+    test_csv_read_mid_field_quote();
+    test_csv_write_quoting();
+    test_csv_write_memstream();
+    test_csv_write_to_writer();
     test_csv_read_null_input();
     test_csv_validate_columns_cases();
     test_csv_write_selected_columns();
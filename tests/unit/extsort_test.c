@@ -0,0 +1,210 @@
+/*
+* Unit tests for the external sorter
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE  // setenv, strdup
+
+#include "../../include/extsort.h"
+#include "../../include/sort.h"
+#include "../../include/vec.h"
+#include "../../include/row.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Checks the sorted rows against an expected order, one call per row
+typedef struct Expect {
+     Vec *rows;  // expected rows, in order
+     size_t seen;  // rows received so far
+     size_t stop_after;  // rows to accept before stopping (SIZE_MAX for all)
+     int matches;  // 0 once a row differs
+} Expect;
+
+static int check_row(const Row *row, void *arg) {
+     Expect *expect = arg;
+     Row *want = expect->seen < vec_length(expect->rows) ? vec_get(expect->rows, expect->seen) : NULL;
+     if (want == NULL || row_num_cells(row) != row_num_cells(want)) {
+          expect->matches = 0;
+     } else {
+          for (int i = 0; i < row_num_cells(row); i++) {
+               if (strcmp(row_get_cell(row, i), row_get_cell(want, i)) != 0) expect->matches = 0;
+          }
+     }
+     expect->seen++;
+     return expect->seen >= expect->stop_after;
+}
+
+// Builds count rows (id, score, padding); every 50th row lacks the score
+static Vec *make_rows(size_t count, unsigned seed) {
+     Vec *rows = vec_new(count);
+     srand(seed);
+     for (size_t i = 0; i < count; i++) {
+          char id[24], score[24];
+          snprintf(id, sizeof(id), "%zu", i);
+          snprintf(score, sizeof(score), i % 7 == 0 ? "%d.5" : "%d", rand() % 2000 - 1000);
+          const char *cells[] = { id, score, "padding padding padding" };
+          vec_push(rows, row_new_from_cells(cells, i % 50 == 3 ? 1 : 3));
+     }
+     return rows;
+}
+
+static void free_rows(Vec *rows) {
+     for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+     vec_free(rows);
+}
+
+// Sorts rows with a sorter and checks them against sort_rows_by_columns
+static int sorts_like_memory(Vec *rows, const SortColumn *cols, int num_cols, size_t memory_limit,
+                             size_t *num_runs) {
+     ExtSort *sorter = extsort_new(cols, num_cols, memory_limit, 2);
+     int added = sorter != NULL;
+     for (size_t i = 0; i < vec_length(rows) && added; i++) {
+          added = extsort_add(sorter, vec_get(rows, i)) == 0;
+     }
+     *num_runs = extsort_num_runs(sorter);
+
+     Vec *expected = vec_new(vec_length(rows));
+     for (size_t i = 0; i < vec_length(rows); i++) vec_push(expected, vec_get(rows, i));
+     sort_rows_by_columns(vec_get_data(expected), vec_length(expected), cols, num_cols, 1);
+
+     Expect expect = { expected, 0, SIZE_MAX, 1 };
+     int ok = added && extsort_finish(sorter, check_row, &expect) == 0 &&
+              expect.matches && expect.seen == vec_length(rows);
+     extsort_free(sorter);
+     vec_free(expected);
+     return ok;
+}
+
+// Test 1: Rows that fit the budget are sorted in memory
+void test_extsort_in_memory(void) {
+     Vec *rows = make_rows(1000, 1);
+     size_t num_runs = 0;
+     TEST(sorts_like_memory(rows, &(SortColumn){ 1, 1 }, 1, EXTSORT_MIN_MEMORY, &num_runs) && num_runs == 0,
+          "rows within the budget are sorted without runs",
+          "in-memory sort wrong or spilled"
+     );
+     free_rows(rows);
+     printf("Test 1: In-memory sort - Complete\n\n");
+}
+
+// Test 2: Larger inputs spill runs and merge back stably
+void test_extsort_runs(void) {
+     Vec *rows = make_rows(60000, 2);
+     size_t asc_runs = 0, desc_runs = 0;
+     int asc = sorts_like_memory(rows, &(SortColumn){ 1, 1 }, 1, EXTSORT_MIN_MEMORY, &asc_runs);
+     int desc = sorts_like_memory(rows, &(SortColumn){ 1, 0 }, 1, EXTSORT_MIN_MEMORY, &desc_runs);
+     TEST(asc && desc && asc_runs > 1 && desc_runs > 1,
+          "spilled runs merge into the in-memory order",
+          "merged runs differ from the in-memory order"
+     );
+     free_rows(rows);
+     printf("Test 2: Spilled runs - Complete\n\n");
+}
+
+// Test 3: Full levels of runs are merged while rows are added
+void test_extsort_levels(void) {
+     Vec *rows = make_rows(500000, 3);
+     size_t num_runs = 0;
+     TEST(sorts_like_memory(rows, &(SortColumn){ 1, 1 }, 1, EXTSORT_MIN_MEMORY, &num_runs) &&
+          num_runs < EXTSORT_MERGE_WIDTH,
+          "runs are merged level by level and stay few",
+          "level merges lost rows or left too many runs"
+     );
+     free_rows(rows);
+     printf("Test 3: Run levels - Complete\n\n");
+}
+
+// Test 4: Stopping early and bad input
+void test_extsort_stop(void) {
+     Vec *rows = make_rows(30000, 4);
+     ExtSort *sorter = extsort_new(&(SortColumn){ 1, 1 }, 1, EXTSORT_MIN_MEMORY, 1);
+     for (size_t i = 0; i < vec_length(rows); i++) extsort_add(sorter, vec_get(rows, i));
+
+     Vec *expected = vec_new(vec_length(rows));
+     for (size_t i = 0; i < vec_length(rows); i++) vec_push(expected, vec_get(rows, i));
+     sort_rows(vec_get_data(expected), vec_length(expected), 1, 1, 1);
+
+     Expect expect = { expected, 0, 10, 1 };
+     TEST(extsort_finish(sorter, check_row, &expect) == 0 && expect.seen == 10 && expect.matches,
+          "merge stops when the callback asks",
+          "merge did not stop"
+     );
+     extsort_free(sorter);
+     vec_free(expected);
+
+     TEST(extsort_new(&(SortColumn){ -1, 1 }, 1, 0, 1) == NULL && extsort_new(NULL, 1, 0, 1) == NULL && extsort_add(NULL, vec_get(rows, 0)) == -1 &&
+          extsort_finish(NULL, check_row, NULL) == -1,
+          "bad input is rejected",
+          "bad input accepted"
+     );
+     extsort_free(NULL);
+
+     // the spill directory is checked before any row is taken
+     const char *saved_tmpdir = getenv("TMPDIR");
+     char *tmpdir = saved_tmpdir != NULL ? strdup(saved_tmpdir) : NULL;
+     setenv("TMPDIR", "/nonexistent/csvlite", 1);
+     ExtSort *unwritable = extsort_new(&(SortColumn){ 1, 1 }, 1, 0, 1);
+     TEST(unwritable == NULL,
+          "an unusable TMPDIR is rejected by extsort_new",
+          "extsort_new accepted an unusable TMPDIR"
+     );
+     extsort_free(unwritable);
+     if (tmpdir != NULL) setenv("TMPDIR", tmpdir, 1); else unsetenv("TMPDIR");
+     free(tmpdir);
+
+     free_rows(rows);
+     printf("Test 4: Early stop and bad input - Complete\n\n");
+}
+
+// Test 5: Several sort columns, spilled and merged
+void test_extsort_multi_column(void) {
+     Vec *rows = make_rows(60000, 5);
+     for (size_t i = 0; i < vec_length(rows); i++) {
+          Row *row = vec_get(rows, i);
+          if (row_num_cells(row) == 3) row_set_cell(row, 2, i % 3 == 0 ? "a" : i % 3 == 1 ? "b" : "");
+     }
+     SortColumn cols[] = { { 2, 0 }, { 1, 1 }, { 0, 0 } };
+     size_t num_runs = 0;
+     TEST(sorts_like_memory(rows, cols, 3, EXTSORT_MIN_MEMORY, &num_runs) && num_runs > 1,
+          "several columns merge into the in-memory order",
+          "multi-column merge differs from the in-memory order"
+     );
+     free_rows(rows);
+     printf("Test 5: Several sort columns - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== External Sort Unit Tests ===\n\n");
+
+     test_extsort_in_memory();
+     test_extsort_runs();
+     test_extsort_levels();
+     test_extsort_stop();
+     test_extsort_multi_column();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
@@ -12,6 +12,7 @@
 #include "../../include/group.h"
 #include "../../include/vec.h"
 #include "../../include/row.h"
+#include "../../include/table.h"
 #include <assert.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -215,6 +216,34 @@ void test_group_two_keys() {
     printf("Test 8: Multiple unique keys handled correctly\n\n");
 }
 
+/* Tests whether group_table_by_column() keeps the first row per key
+ * of a column-oriented table, in input order.
+ *
+ * PARAMS:
+ * None
+ * 
+ * RETURNS:
+ *  None
+ */
+void test_group_table() {
+    Table *table = table_new(2);
+    const char *lines[] = { "dept\0name", "A\0x", "B\0y", "A\0z", "B\0w" };
+    const uint32_t offsets[][2] = { { 0, 5 }, { 0, 2 }, { 0, 2 }, { 0, 2 }, { 0, 2 } };
+    for (int i = 0; i < 5; i++) {
+        table_append_row(table, lines[i], offsets[i], 2);
+    }
+
+    assert(group_table_by_column(table, 0) == 0);
+    assert(table_num_rows(table) == 3);  // header, A, B
+    assert(strcmp(table_get_cell(table, 1, 1), "x") == 0);
+    assert(strcmp(table_get_cell(table, 2, 1), "y") == 0);
+    assert(group_table_by_column(table, 5) == -1);
+
+    table_free(table);
+
+    printf("Test 9: Table grouped in place correctly\n\n");
+}
+
 /* Entry point for the test program.
  * Runs unit tests for the group module.
  * 
@@ -233,10 +262,11 @@ int main() {
     test_group_null_middle_row();
     test_group_invalid_col_index();
     test_group_two_keys();
+    test_group_table();
     
     printf("=== Test Summary ===\n");
-    printf("Tests run: 8\n");
-    printf("Tests passed: 8\n");
+    printf("Tests run: 9\n");
+    printf("Tests passed: 9\n");
     printf("Tests failed: 0\n");
     
     return EXIT_SUCCESS;
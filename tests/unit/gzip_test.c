@@ -0,0 +1,162 @@
+/*
+* Unit tests for gzip-compressed input
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/gzip.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Lines of the generated content; several times the whole queue
+#define NUM_LINES 200000
+
+// Writes NUM_LINES numbered lines to a new temp file, compressed as one
+// gzip member per part, and returns the plain content (caller frees)
+static char *make_source(char *path, int parts, size_t *len) {
+     size_t cap = (size_t)NUM_LINES * 24;
+     char *content = malloc(cap);
+     *len = 0;
+     for (int i = 0; i < NUM_LINES; i++) {
+          *len += (size_t)snprintf(content + *len, cap - *len, "%d,row %d\n", i, i * 7);
+     }
+
+     close(mkstemp(path));
+     size_t part = *len / (size_t)parts;
+     for (int p = 0; p < parts; p++) {
+          // "ab" appends a new member
+          gzFile gz = gzopen(path, "ab");
+          size_t start = part * (size_t)p;
+          size_t end = p == parts - 1 ? *len : start + part;
+          gzwrite(gz, content + start, (unsigned)(end - start));
+          gzclose(gz);
+     }
+     return content;
+}
+
+// Reads a whole stream in odd-sized pieces
+static char *read_all(FILE *stream, size_t *len) {
+     size_t cap = 1024;
+     char *data = malloc(cap);
+     *len = 0;
+     size_t n;
+     while ((n = fread(data + *len, 1, 1000, stream)) > 0) {
+          *len += n;
+          if (cap - *len < 1000) {
+               cap *= 2;
+               data = realloc(data, cap);
+          }
+     }
+     return data;
+}
+
+// Test 1: Decompressed stream matches the original, across members
+void test_gzip_read(void) {
+     for (int parts = 1; parts <= 3; parts += 2) {
+          char path[] = "/tmp/gzip_testXXXXXX";
+          size_t len;
+          char *content = make_source(path, parts, &len);
+
+          TEST(gzip_detect(path) == 1, "gzip_detect() recognizes a gzip file", "gzip file not detected");
+
+          FILE *stream = gzip_open(path);
+          size_t got_len = 0;
+          char *got = stream != NULL ? read_all(stream, &got_len) : NULL;
+          TEST(got != NULL && got_len == len && memcmp(got, content, len) == 0 && !ferror(stream),
+               parts == 1 ? "single member decompresses exactly" : "concatenated members decompress back to back",
+               "decompressed content differs"
+          );
+          if (stream != NULL) fclose(stream);
+
+          free(got);
+          free(content);
+          unlink(path);
+     }
+     printf("Test 1: gzip reads - Complete\n\n");
+}
+
+// Test 2: Plain, corrupt, truncated and abandoned inputs
+void test_gzip_errors(void) {
+     char path[] = "/tmp/gzip_testXXXXXX";
+     size_t len;
+     free(make_source(path, 1, &len));
+
+     // closing while the inflater waits on a full queue must not hang
+     FILE *stream = gzip_open(path);
+     char buf[16];
+     TEST(stream != NULL && fread(buf, 1, sizeof(buf), stream) == sizeof(buf) && fclose(stream) == 0,
+          "stream closes before it is drained",
+          "early close failed"
+     );
+
+     // cut the file inside the compressed data
+     truncate(path, 2000);
+     stream = gzip_open(path);
+     size_t got_len = 0;
+     char *got = stream != NULL ? read_all(stream, &got_len) : NULL;
+     TEST(stream != NULL && ferror(stream) && got_len < len,
+          "truncated input sets the error indicator",
+          "truncated input not reported"
+     );
+     free(got);
+     if (stream != NULL) fclose(stream);
+
+     // corrupt the deflate data after the header
+     FILE *file = fopen(path, "r+b");
+     fseek(file, 20, SEEK_SET);
+     fwrite("garbagegarbagegarbage", 1, 21, file);
+     fclose(file);
+     stream = gzip_open(path);
+     got = stream != NULL ? read_all(stream, &got_len) : NULL;
+     TEST(stream != NULL && ferror(stream), "corrupt input sets the error indicator", "corrupt input not reported");
+     free(got);
+     if (stream != NULL) fclose(stream);
+
+     file = fopen(path, "w");
+     fputs("id,name\n1,Alice\n", file);
+     fclose(file);
+     TEST(gzip_detect(path) == 0, "plain CSV is not detected as gzip", "plain CSV detected as gzip");
+
+     TEST(gzip_open("/tmp/gzip_test_missing.gz") == NULL && gzip_open(NULL) == NULL && gzip_detect(NULL) == 0,
+          "missing file and NULL input are rejected",
+          "missing file or NULL accepted"
+     );
+     unlink(path);
+     printf("Test 2: gzip errors - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Gzip Unit Tests ===\n\n");
+
+     test_gzip_read();
+     test_gzip_errors();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
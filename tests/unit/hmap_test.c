@@ -7,6 +7,7 @@
 */
 
 #include "../../include/hmap.h"
+#include "../../include/arena.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -188,6 +189,30 @@ void test_hmap_capacity_one(void) {
     printf("Test 10: capacity = 1 - Complete\n\n");
 }
 
+// Test 11: Maps created while an arena is current live in the arena
+void test_hmap_arena(void) {
+    Arena *arena = arena_new(0);
+    arena_set_current(arena);
+
+    HMap *map = hmap_new(4);
+    int vals[3] = { 1, 2, 3 };
+    hmap_put(map, "a", &vals[0]);
+    hmap_put(map, "b", &vals[1]);
+    hmap_put(map, "c", &vals[2]);
+    TEST(hmap_size(map) == 3 && *(int *)hmap_get(map, "b") == 2, "arena map works", "arena map fails");
+    TEST(hmap_remove(map, "a") == &vals[0] && hmap_get(map, "a") == NULL,
+         "arena map remove works", "arena map remove fails");
+
+    ArenaStats stats;
+    arena_stats(arena, &stats);
+    TEST(stats.num_allocs == 5, "map, buckets and entries allocated from arena", "map not allocated from arena");
+
+    hmap_free(map); // no-op, memory belongs to the arena
+    arena_set_current(NULL);
+    arena_free(arena);
+    printf("Test 11: hmap in an arena - Complete\n\n");
+}
+
 int main(void) {
     printf("=== HMap Unit Tests ===\n\n");
     
@@ -201,6 +226,7 @@ int main(void) {
     test_hmap_empty_string_key();
     test_hmap_long_key();
     test_hmap_capacity_one();
+    test_hmap_arena();
     
     printf("=== Test Summary ===\n");
     printf("Tests run: %d\n", tests_run);
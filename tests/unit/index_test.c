@@ -0,0 +1,154 @@
+/*
+* Unit tests for the on-disk hash index
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/index.h"
+#include "../../include/csv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+static const char *DATA = "id,dept\n1,Sales\n2,Eng\n3,Sales\n4\n5,Ops\n";
+
+// Writes DATA to a temp file and returns its path in path
+static void make_source(char *path) {
+     int fd = mkstemp(path);
+     if (fd >= 0) {
+          if (write(fd, DATA, strlen(DATA)) != (ssize_t)strlen(DATA)) perror("write");
+          close(fd);
+     }
+}
+
+// Builds the index of column for the file at path
+static int build(const char *path, int column, const CacheKey *key) {
+     CsvMap *map = csv_map_open(path);
+     CsvReader *reader = csv_reader_open_mapped(map);
+     Row *header = csv_reader_next(reader);
+     row_free(header);
+     int result = index_build(reader, column, path, key);
+     csv_reader_close(reader);
+     csv_map_close(map);
+     return result;
+}
+
+// Removes the source file and its index of column
+static void remove_source(const char *path, int column) {
+     char index_path[256];
+     snprintf(index_path, sizeof(index_path), "%s.%d%s", path, column, INDEX_SUFFIX);
+     unlink(index_path);
+     unlink(path);
+}
+
+// Test 1: Lookups return the offsets of matching records in file order
+void test_index_lookup(void) {
+     char path[] = "/tmp/index_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     cache_key(path, &key);
+
+     TEST(index_open(path, 1, &key) == NULL, "no index before it is built", "index found before building");
+     TEST(build(path, 1, &key) == 0, "index_build() succeeds", "index_build() fails");
+
+     Index *index = index_open(path, 1, &key);
+     TEST(index != NULL, "index_open() succeeds", "index_open() fails");
+
+     size_t count = 0;
+     size_t *offsets = index_lookup(index, "Sales", &count);
+     TEST(offsets != NULL && count == 2 && offsets[0] == 8 && offsets[1] == 22,
+          "index_lookup() finds both Sales records in order",
+          "index_lookup() wrong offsets for Sales"
+     );
+     free(offsets);
+
+     // the recorded offsets are where the matching records start
+     CsvMap *map = csv_map_open(path);
+     CsvReader *reader = csv_reader_open_mapped(map);
+     offsets = index_lookup(index, "Ops", &count);
+     Row *row = (offsets != NULL && count == 1 && csv_reader_seek(reader, offsets[0]) == 0) ? csv_reader_next(reader) : NULL;
+     TEST(row != NULL && strcmp(row_get_cell(row, 0), "5") == 0, "offsets lead to the matching record", "offset led elsewhere");
+     row_free(row);
+     free(offsets);
+     csv_reader_close(reader);
+     csv_map_close(map);
+
+     offsets = index_lookup(index, "", &count);
+     TEST(offsets != NULL && count == 1 && offsets[0] == 30, "missing cells are indexed as empty", "missing cell not indexed");
+     free(offsets);
+     offsets = index_lookup(index, "Marketing", &count);
+     TEST(offsets != NULL && count == 0, "unknown values have no candidates", "unknown value had candidates");
+     free(offsets);
+
+     index_close(index);
+     index_close(NULL); // safe to pass NULL
+     remove_source(path, 1);
+     printf("Test 1: index lookups - Complete\n\n");
+}
+
+// Test 2: Stale, mismatched and damaged indexes are ignored
+void test_index_invalid(void) {
+     char path[] = "/tmp/index_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     cache_key(path, &key);
+     build(path, 0, &key);
+
+     CacheKey changed = key;
+     changed.mtime_sec++;
+     TEST(index_open(path, 0, &changed) == NULL, "index of an older version is stale", "stale index used");
+     TEST(index_open(path, 1, &key) == NULL, "index of another column is not used", "wrong column index used");
+     TEST(build(path, 0, &changed) == -1 && index_open(path, 0, &key) != NULL,
+          "a source changed during the build is not indexed",
+          "index written for a changed source"
+     );
+
+     char index_path[256];
+     snprintf(index_path, sizeof(index_path), "%s.0%s", path, INDEX_SUFFIX);
+     TEST(truncate(index_path, 80) == 0 && index_open(path, 0, &key) == NULL,
+          "truncated index is rejected",
+          "truncated index accepted"
+     );
+
+     TEST(index_open(NULL, 0, &key) == NULL && index_lookup(NULL, "x", NULL) == NULL &&
+          index_build(NULL, 0, path, &key) == -1,
+          "NULL input is rejected",
+          "NULL input accepted"
+     );
+     remove_source(path, 0);
+     printf("Test 2: invalid indexes - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Index Unit Tests ===\n\n");
+
+     test_index_lookup();
+     test_index_invalid();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
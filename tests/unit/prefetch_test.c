@@ -0,0 +1,141 @@
+/*
+* Unit tests for read-ahead input streams
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/prefetch.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Source that counts bytes up to a limit, then ends or fails
+typedef struct CountingSource {
+     size_t next;  // next byte value to produce (mod 251)
+     size_t limit;  // bytes to produce
+     int fail;  // 1 to fail at the limit instead of ending
+     atomic_int released;  // set by the release callback
+} CountingSource;
+
+static long counting_fill(void *source, char *buf, size_t cap) {
+     CountingSource *s = source;
+     if (s->next == s->limit) return s->fail ? -1 : 0;
+
+     size_t n = s->limit - s->next < cap ? s->limit - s->next : cap;
+     for (size_t i = 0; i < n; i++) buf[i] = (char)((s->next + i) % 251);
+     s->next += n;
+     return (long)n;
+}
+
+static void counting_release(void *source) {
+     CountingSource *s = source;
+     atomic_store(&s->released, 1);
+}
+
+// Reads a stream to its end, checking the counting pattern
+static size_t read_pattern(FILE *stream, int *matches) {
+     char buf[1000];
+     size_t total = 0;
+     size_t n;
+     *matches = 1;
+     while ((n = fread(buf, 1, sizeof(buf), stream)) > 0) {
+          for (size_t i = 0; i < n; i++) {
+               if (buf[i] != (char)((total + i) % 251)) *matches = 0;
+          }
+          total += n;
+     }
+     return total;
+}
+
+// Waits up to a second for the release callback
+static int wait_released(CountingSource *s) {
+     for (int i = 0; i < 1000 && !atomic_load(&s->released); i++) usleep(1000);
+     return atomic_load(&s->released);
+}
+
+// Test 1: Bytes arrive in order across buffers, failures after them
+void test_prefetch_fill(void) {
+     CountingSource ok = { 0, 100000, 0, 0 };
+     FILE *stream = prefetch_open(counting_fill, counting_release, &ok, 4096, 3);
+     int matches = 0;
+     size_t total = stream != NULL ? read_pattern(stream, &matches) : 0;
+     TEST(total == 100000 && matches && !ferror(stream), "bytes arrive in order across buffers", "bytes lost or reordered");
+     if (stream != NULL) fclose(stream);
+     TEST(wait_released(&ok), "source is released after close", "source not released");
+
+     CountingSource failing = { 0, 10000, 1, 0 };
+     stream = prefetch_open(counting_fill, counting_release, &failing, 4096, 2);
+     total = stream != NULL ? read_pattern(stream, &matches) : 0;
+     TEST(total == 10000 && matches && ferror(stream),
+          "a failed fill sets the error indicator after the bytes before it",
+          "failed fill not reported"
+     );
+     if (stream != NULL) fclose(stream);
+     wait_released(&failing);
+
+     TEST(prefetch_open(NULL, NULL, NULL, 4096, 2) == NULL && prefetch_open(counting_fill, NULL, &ok, 4096, 1) == NULL &&
+          prefetch_stream(NULL, 0) == NULL,
+          "bad parameters are rejected",
+          "bad parameters accepted"
+     );
+     printf("Test 1: prefetch fills - Complete\n\n");
+}
+
+// Test 2: Streams over pipes, including one that never ends
+void test_prefetch_pipe(void) {
+     int fds[2];
+     if (pipe(fds) != 0) return;
+
+     const char *data = "id,name\n1,Alice\n2,Bob\n";
+     if (write(fds[1], data, strlen(data)) != (ssize_t)strlen(data)) perror("write");
+     close(fds[1]);
+
+     FILE *stream = prefetch_stream(fdopen(fds[0], "r"), 1);
+     char buf[64] = {0};
+     size_t n = stream != NULL ? fread(buf, 1, sizeof(buf) - 1, stream) : 0;
+     TEST(n == strlen(data) && strcmp(buf, data) == 0, "pipe contents are read through", "pipe contents differ");
+     if (stream != NULL) fclose(stream);
+
+     // the writer stays silent, so the thread blocks in its read
+     if (pipe(fds) != 0) return;
+     stream = prefetch_stream(fdopen(fds[0], "r"), 1);
+     TEST(stream != NULL && fclose(stream) == 0, "closing does not wait on an idle pipe", "close failed");
+     close(fds[1]);  // lets the thread see the end and exit
+     usleep(10000);
+     printf("Test 2: prefetch pipes - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Prefetch Unit Tests ===\n\n");
+
+     test_prefetch_fill();
+     test_prefetch_pipe();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
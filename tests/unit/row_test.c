@@ -7,6 +7,7 @@
 */
 
 #include "../../include/row.h"
+#include "../../include/arena.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -151,6 +152,108 @@ void test_row_null_handling(void) {
      printf("Test 5: NULL handling - Complete\n\n");
 }
 
+// Test 6: View rows borrow cells from a tokenized line
+void test_row_view(void) {
+     char buffer[] = "left\0right";
+     uint32_t offsets[] = { 0, 5 };
+     Row *row = row_new_view(buffer, offsets, 2);
+     TEST(row != NULL, "row_new_view() succeeds", "row_new_view() fails");
+
+     TEST(row_get_cell(row, 1) == buffer + 5,
+          "row_get_cell() returns borrowed pointer",
+          "row_get_cell() does not return borrowed pointer"
+     );
+
+     TEST(row_set_cell(row, 0, "new") == 0, "row_set_cell() on view row succeeds", "row_set_cell() on view row fails");
+     TEST(strcmp(row_get_cell(row, 0), "new") == 0 && row_get_cell(row, 1) == buffer + 5,
+          "view row update copies only the changed cell",
+          "view row update wrong"
+     );
+     TEST(strcmp(buffer, "left") == 0, "borrowed buffer left untouched", "borrowed buffer modified");
+     row_free(row);
+
+     TEST(row_new_view(NULL, offsets, 2) == NULL && row_new_view(buffer, NULL, 2) == NULL,
+          "row_new_view() rejects NULL input",
+          "row_new_view() accepts NULL input"
+     );
+     printf("Test 6: row_new_view() - Complete\n\n");
+}
+
+// Test 7: Packed rows copy a tokenized line into one allocation
+void test_row_packed(void) {
+     char buffer[] = "a\0bb\0\0ccc";
+     uint32_t offsets[] = { 0, 2, 5, 6 };
+     Row *row = row_new_packed(buffer, sizeof(buffer), offsets, 4);
+     TEST(row != NULL, "row_new_packed() succeeds", "row_new_packed() fails");
+
+     buffer[0] = 'x'; // row must not depend on the source buffer
+     TEST(strcmp(row_get_cell(row, 0), "a") == 0 && strcmp(row_get_cell(row, 1), "bb") == 0 &&
+          strcmp(row_get_cell(row, 2), "") == 0 && strcmp(row_get_cell(row, 3), "ccc") == 0,
+          "row_new_packed() cells are correct",
+          "row_new_packed() cells are incorrect"
+     );
+
+     // updates grow the overflow buffer, including from the row's own cells
+     TEST(row_set_cell(row, 2, "a longer value than before") == 0 &&
+          row_set_cell(row, 0, row_get_cell(row, 2)) == 0 &&
+          row_set_cell(row, 2, "short") == 0,
+          "row_set_cell() on packed row succeeds",
+          "row_set_cell() on packed row fails"
+     );
+     TEST(strcmp(row_get_cell(row, 0), "a longer value than before") == 0 &&
+          strcmp(row_get_cell(row, 2), "short") == 0 && strcmp(row_get_cell(row, 3), "ccc") == 0,
+          "packed row updates are correct",
+          "packed row updates are incorrect"
+     );
+     row_free(row);
+     printf("Test 7: row_new_packed() - Complete\n\n");
+}
+
+// Test 8: Rows built from a list of strings
+void test_row_from_cells(void) {
+     const char *values[] = { "one", NULL, "" };
+     Row *row = row_new_from_cells(values, 3);
+     TEST(row != NULL && row_num_cells(row) == 3, "row_new_from_cells() succeeds", "row_new_from_cells() fails");
+     TEST(strcmp(row_get_cell(row, 0), "one") == 0 && row_get_cell(row, 1) == NULL &&
+          strcmp(row_get_cell(row, 2), "") == 0,
+          "row_new_from_cells() copies values and NULL cells",
+          "row_new_from_cells() values wrong"
+     );
+     row_free(row);
+
+     TEST(row_new_from_cells(NULL, 3) == NULL && row_new_from_cells(values, 0) == NULL,
+          "row_new_from_cells() rejects bad input",
+          "row_new_from_cells() accepts bad input"
+     );
+     printf("Test 8: row_new_from_cells() - Complete\n\n");
+}
+
+// Test 9: Rows built while an arena is current live in the arena
+void test_row_arena(void) {
+     Arena *arena = arena_new(0);
+     arena_set_current(arena);
+
+     const char *values[] = { "x", "y" };
+     Row *row = row_new_from_cells(values, 2);
+     TEST(row != NULL && row_set_cell(row, 0, "a much longer value") == 0,
+          "arena row built and updated",
+          "arena row failed"
+     );
+     TEST(strcmp(row_get_cell(row, 0), "a much longer value") == 0 && strcmp(row_get_cell(row, 1), "y") == 0,
+          "arena row cells correct",
+          "arena row cells wrong"
+     );
+     row_free(row); // no-op, memory belongs to the arena
+
+     ArenaStats stats;
+     arena_stats(arena, &stats);
+     TEST(stats.num_allocs == 2, "row and overflow buffer allocated from arena", "row not allocated from arena");
+
+     arena_set_current(NULL);
+     arena_free(arena);
+     printf("Test 9: rows in an arena - Complete\n\n");
+}
+
 int main(void) {
      printf("=== Row Unit Tests ===\n\n");
      
@@ -159,6 +262,10 @@ int main(void) {
      test_row_update();
      test_row_invalid_index();
      test_row_null_handling();
+     test_row_view();
+     test_row_packed();
+     test_row_from_cells();
+     test_row_arena();
      
      printf("=== Test Summary ===\n");
      printf("Tests run: %d\n", tests_run);
@@ -0,0 +1,267 @@
+/*
+* Unit tests for the structural character scanner
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#include "../../include/scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Reference classification: one byte at a time
+static void naive_masks(const char *data, size_t len, ScanMasks *out) {
+     out->comma = 0;
+     out->newline = 0;
+     out->quote = 0;
+     out->blank = 0;
+     for (size_t i = 0; i < len && i < SCAN_BLOCK_SIZE; i++) {
+          if (data[i] == ',') out->comma |= 1ULL << i;
+          if (data[i] == '\n') out->newline |= 1ULL << i;
+          if (data[i] == '"') out->quote |= 1ULL << i;
+          if (data[i] == ' ' || data[i] == '\t') out->blank |= 1ULL << i;
+     }
+}
+
+// Reference quote mask: one byte at a time over a whole block
+static uint64_t naive_quote_mask(const char *data, QuoteState *state) {
+     uint64_t mask = 0;
+     for (int i = 0; i < SCAN_BLOCK_SIZE; i++) {
+          char c = data[i];
+          if (state->inside) {
+               if (c == '"') {
+                    state->inside = 0;
+                    state->closed = 1;
+               }
+          } else if (c == '"' && (state->field_start || state->closed)) {
+               state->inside = 1;
+               state->field_start = 0;
+               state->closed = 0;
+          } else if (c == ',' || c == '\n') {
+               state->field_start = 1;
+               state->closed = 0;
+          } else if (c == ' ' || c == '\t') {
+               state->closed = 0;
+          } else {
+               state->field_start = 0;
+               state->closed = 0;
+          }
+          if (state->inside) mask |= 1ULL << i;
+     }
+     return mask;
+}
+
+// Quote mask of text padded to a block with 'a'
+static uint64_t quote_mask_of(const char *text, QuoteState *state) {
+     char block[SCAN_BLOCK_SIZE];
+     memset(block, 'a', sizeof(block));
+     memcpy(block, text, strlen(text));
+     ScanMasks masks;
+     scan_block(block, &masks);
+     return scan_quote_mask(&masks, state);
+}
+
+// Test 1: Known block layout
+void test_scan_known_block(void) {
+     char block[SCAN_BLOCK_SIZE];
+     memset(block, 'a', sizeof(block));
+     block[0] = ',';
+     block[31] = ',';
+     block[32] = '\n';
+     block[63] = ',';
+
+     ScanMasks masks;
+     scan_block(block, &masks);
+     TEST(masks.comma == ((1ULL << 0) | (1ULL << 31) | (1ULL << 63)),
+          "scan_block() finds commas at both lane edges",
+          "scan_block() comma mask wrong"
+     );
+     TEST(masks.newline == (1ULL << 32),
+          "scan_block() finds newline",
+          "scan_block() newline mask wrong"
+     );
+     printf("Test 1: scan_block() known layout - Complete\n\n");
+}
+
+// Test 2: Random blocks match the byte-by-byte reference
+void test_scan_random_blocks(void) {
+     const char alphabet[] = "ab,\n \"x\t";
+     int mismatches = 0;
+     srand(42);
+
+     for (int t = 0; t < 1000; t++) {
+          char block[SCAN_BLOCK_SIZE];
+          for (int i = 0; i < SCAN_BLOCK_SIZE; i++) {
+               block[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+          }
+
+          ScanMasks got, expected;
+          scan_block(block, &got);
+          naive_masks(block, SCAN_BLOCK_SIZE, &expected);
+          if (got.comma != expected.comma || got.newline != expected.newline ||
+              got.quote != expected.quote || got.blank != expected.blank) mismatches++;
+     }
+
+     TEST(mismatches == 0,
+          "scan_block() matches reference on random blocks",
+          "scan_block() differs from reference on random blocks"
+     );
+     printf("Test 2: scan_block() random blocks - Complete\n\n");
+}
+
+// Test 3: Partial blocks ignore bytes past the end
+void test_scan_partial(void) {
+     const char *text = "a,b\nc,d,,";
+     char block[SCAN_BLOCK_SIZE];
+     memset(block, ',', sizeof(block)); // garbage past len must not show up
+     memcpy(block, text, strlen(text));
+
+     ScanMasks got, expected;
+     scan_partial(block, 5, &got);
+     naive_masks(text, 5, &expected);
+     TEST(got.comma == expected.comma && got.newline == expected.newline && got.blank == expected.blank,
+          "scan_partial() masks bytes past len",
+          "scan_partial() reports bytes past len"
+     );
+
+     scan_partial(block, 0, &got);
+     TEST(got.comma == 0 && got.newline == 0,
+          "scan_partial() with len 0 returns empty masks",
+          "scan_partial() with len 0 returns non-empty masks"
+     );
+
+     scan_partial(block, SCAN_BLOCK_SIZE, &got);
+     naive_masks(block, SCAN_BLOCK_SIZE, &expected);
+     TEST(got.comma == expected.comma && got.newline == expected.newline,
+          "scan_partial() with a full block classifies all 64 bytes",
+          "scan_partial() with a full block failed"
+     );
+     printf("Test 3: scan_partial() - Complete\n\n");
+}
+
+// Test 4: Implementation name is reported
+void test_scan_impl_name(void) {
+     const char *name = scan_impl_name();
+     TEST(name != NULL && (strcmp(name, "avx2") == 0 || strcmp(name, "sse2") == 0 || strcmp(name, "scalar") == 0),
+          "scan_impl_name() reports a known implementation",
+          "scan_impl_name() reports an unknown implementation"
+     );
+     printf("[INFO] scan implementation: %s\n", name ? name : "(null)");
+     printf("Test 4: scan_impl_name() - Complete\n\n");
+}
+
+// Test 5: Quote mask covers quoted fields and carries across blocks
+void test_scan_quote_mask(void) {
+     QuoteState state = QUOTE_STATE_INIT;
+     // quotes at 0 and 4: bits 0..3 are inside (opening quote included)
+     uint64_t mask = quote_mask_of("\"a,b\",c", &state);
+     TEST(mask == 0xFULL && state.inside == 0,
+          "scan_quote_mask() marks a closed quoted field",
+          "scan_quote_mask() closed field wrong"
+     );
+
+     state = (QuoteState)QUOTE_STATE_INIT;
+     mask = quote_mask_of("1,12\" ruler,3", &state);
+     TEST(mask == 0 && state.inside == 0,
+          "scan_quote_mask() keeps a quote inside an unquoted field literal",
+          "scan_quote_mask() opened a quote inside an unquoted field"
+     );
+
+     state = (QuoteState)QUOTE_STATE_INIT;
+     mask = quote_mask_of("x, \t\"a\"\"b\",y", &state);
+     // the first quote of "" closes and the second reopens, so only 6 is clear
+     TEST(mask == (0x1BULL << 4) && state.inside == 0,
+          "scan_quote_mask() opens after leading blanks and keeps \"\" inside",
+          "scan_quote_mask() leading blanks or escaped quote wrong"
+     );
+
+     // an opening quote at 63 leaves the next block inside quotes
+     char block[SCAN_BLOCK_SIZE];
+     memset(block, 'a', sizeof(block));
+     block[62] = ',';
+     block[63] = '"';
+     ScanMasks masks;
+     scan_block(block, &masks);
+     state = (QuoteState)QUOTE_STATE_INIT;
+     mask = scan_quote_mask(&masks, &state);
+     TEST(mask == (1ULL << 63) && state.inside == 1,
+          "scan_quote_mask() carries an open quote out of the block",
+          "scan_quote_mask() did not carry an open quote"
+     );
+
+     // next block closes the quote at 3
+     mask = quote_mask_of("a,b\",c", &state);
+     TEST(mask == 0x7ULL && state.inside == 0,
+          "scan_quote_mask() closes a carried quote",
+          "scan_quote_mask() carried quote wrong"
+     );
+
+     // a field start carries too: comma then blanks up to byte 63
+     memset(block, 'a', sizeof(block));
+     memset(block + 60, ' ', 4);
+     block[59] = ',';
+     scan_block(block, &masks);
+     state = (QuoteState)QUOTE_STATE_INIT;
+     scan_quote_mask(&masks, &state);
+     mask = quote_mask_of("\"q\"", &state);
+     TEST(mask == 0x3ULL && state.inside == 0,
+          "scan_quote_mask() carries a field start across blocks",
+          "scan_quote_mask() lost the field start across blocks"
+     );
+
+     // random input matches the byte-by-byte state machine
+     const char alphabet[] = "ab,\n \"\"\t";
+     int mismatches = 0;
+     QuoteState ref = QUOTE_STATE_INIT;
+     state = (QuoteState)QUOTE_STATE_INIT;
+     srand(7);
+     for (int t = 0; t < 1000; t++) {
+          for (int i = 0; i < SCAN_BLOCK_SIZE; i++) {
+               block[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+          }
+          uint64_t expected = naive_quote_mask(block, &ref);
+          scan_block(block, &masks);
+          uint64_t got = scan_quote_mask(&masks, &state);
+          // only compare non-quote bytes; quote bytes themselves are never structural
+          if ((got & ~masks.quote) != (expected & ~masks.quote) || state.inside != ref.inside) mismatches++;
+     }
+     TEST(mismatches == 0,
+          "scan_quote_mask() matches the byte-by-byte state machine",
+          "scan_quote_mask() differs from the byte-by-byte state machine"
+     );
+     printf("Test 5: scan_quote_mask() - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Scan Unit Tests ===\n\n");
+
+     test_scan_known_block();
+     test_scan_random_blocks();
+     test_scan_partial();
+     test_scan_impl_name();
+     test_scan_quote_mask();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
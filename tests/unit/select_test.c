@@ -10,6 +10,7 @@
 #include "../../include/row.h"
 #include "../../include/vec.h"
 #include "../../include/hmap.h"
+#include "../../include/table.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -282,6 +283,39 @@ void test_select_project_rows_zero_indices(void) {
 
 /* ===================== MAIN ===================== */
 
+// Helper: appends one record given as separate cells to a table
+static void append_cells(Table *table, const char *const *cells, int n) {
+    char line[256];
+    uint32_t offsets[8];
+    size_t len = 0;
+    for (int i = 0; i < n; i++) {
+        offsets[i] = (uint32_t)len;
+        strcpy(line + len, cells[i]);
+        len += strlen(cells[i]) + 1;
+    }
+    table_append_row(table, line, offsets, n);
+}
+
+// Project a table onto columns without copying cells
+void test_select_project_table(void) {
+    Table *table = table_new(3);
+    append_cells(table, (const char *[]){ "name", "age", "gpa" }, 3);
+    append_cells(table, (const char *[]){ "Alice", "20", "3.9" }, 3);
+
+    int indices[] = { 2, 0 };
+    TEST(select_project_table(table, indices, 2) == 0 && table_num_cols(table) == 2,
+         "select_project_table keeps two columns",
+         "select_project_table failed");
+    TEST(strcmp(table_get_cell(table, 0, 0), "gpa") == 0 && strcmp(table_get_cell(table, 1, 1), "Alice") == 0,
+         "select_project_table reorders columns",
+         "select_project_table order wrong");
+    TEST(select_project_table(table, NULL, 1) == -1 && select_project_table(table, indices, 0) == -1,
+         "select_project_table rejects bad input",
+         "select_project_table accepted bad input");
+
+    table_free(table);
+}
+
 int main(void) {
     printf("=== Select Unit Tests ===\n\n");
 
@@ -298,6 +332,7 @@ int main(void) {
     test_select_parse_indices_name_without_hmap();
     test_select_project_rows_null_indices();
     test_select_project_rows_zero_indices();
+    test_select_project_table();
 
     printf("=== Test Summary ===\n");
     printf("Tests run: %d\n", tests_run);
@@ -9,6 +9,8 @@
 #include "../../include/sort.h"
 #include "../../include/vec.h"
 #include "../../include/row.h"
+#include "../../include/table.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -190,6 +192,378 @@ void test_sort_single_row(void) {
 }
 
 // Main test driver
+// Helper: appends one record given as separate cells to a table
+static void append_cells(Table *table, const char *const *cells, int n) {
+    char line[256];
+    uint32_t offsets[8];
+    size_t len = 0;
+    for (int i = 0; i < n; i++) {
+        offsets[i] = (uint32_t)len;
+        strcpy(line + len, cells[i]);
+        len += strlen(cells[i]) + 1;
+    }
+    table_append_row(table, line, offsets, n);
+}
+
+// Test 9: Sorting a table keeps the header first
+void test_sort_table(void) {
+    Table *table = table_new(2);
+    append_cells(table, (const char *[]){ "name", "score" }, 2);
+    append_cells(table, (const char *[]){ "Alice", "92" }, 2);
+    append_cells(table, (const char *[]){ "Bob", "80" }, 2);
+    append_cells(table, (const char *[]){ "Carol", "100" }, 2);
+
+    TEST(sort_table_by_column(table, 1, 1) == 0, "Table sort succeeds", "Table sort failed");
+    TEST(strcmp(table_get_cell(table, 0, 0), "name") == 0 && strcmp(table_get_cell(table, 1, 0), "Bob") == 0 &&
+         strcmp(table_get_cell(table, 3, 0), "Carol") == 0,
+         "Table sort: header first, numeric order",
+         "Table sort: wrong order");
+
+    TEST(sort_table_by_column(table, 0, 0) == 0 && strcmp(table_get_cell(table, 1, 0), "Carol") == 0,
+         "Table sort: descending text order",
+         "Table sort: descending wrong");
+    TEST(sort_table_by_column(table, 2, 1) == -1 && sort_table_by_column(NULL, 0, 1) == -1,
+         "Table sort rejects bad input",
+         "Table sort accepted bad input");
+
+    table_free(table);
+}
+
+// Sorts one vector per thread, in the direction passed as arg
+typedef struct SortJob {
+    Vec *rows;
+    int ascending;
+    Vec *sorted;
+} SortJob;
+
+static void *sort_job(void *arg) {
+    SortJob *job = arg;
+    for (int i = 0; i < 50; i++) {
+        vec_free(job->sorted);
+        job->sorted = sort_by_column(job->rows, 1, job->ascending);
+    }
+    return NULL;
+}
+
+// Test 10: Equal keys keep their order, and sorts can run concurrently
+void test_sort_stable_reentrant(void) {
+    Vec *rows = vec_new(6);
+    vec_push(rows, make_row("A", "10"));
+    vec_push(rows, make_row("B", "x"));
+    vec_push(rows, make_row("C", "10"));
+    vec_push(rows, make_row("D", "-3"));
+    vec_push(rows, make_row("E", "x"));
+    vec_push(rows, make_row("F", "-3"));
+
+    Vec *asc = sort_by_column(rows, 1, 1);
+    Vec *desc = sort_by_column(rows, 1, 0);
+    const char *asc_order = "DFACBE";
+    const char *desc_order = "BEACDF";
+    int asc_ok = asc != NULL, desc_ok = desc != NULL;
+    for (int i = 0; i < 6 && asc_ok && desc_ok; i++) {
+        asc_ok = row_get_cell(vec_get(asc, i), 0)[0] == asc_order[i];
+        desc_ok = row_get_cell(vec_get(desc, i), 0)[0] == desc_order[i];
+    }
+    TEST(asc_ok && desc_ok, "Equal keys keep their original order", "Equal keys reordered");
+
+    // Opposite directions on two threads at once
+    Vec *many = vec_new(1000);
+    for (int i = 0; i < 1000; i++) {
+        char score[16];
+        snprintf(score, sizeof(score), "%d", (i * 7919) % 1000);
+        vec_push(many, make_row("R", score));
+    }
+    SortJob jobs[2] = { { many, 1, NULL }, { many, 0, NULL } };
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) pthread_create(&threads[i], NULL, sort_job, &jobs[i]);
+    for (int i = 0; i < 2; i++) pthread_join(threads[i], NULL);
+
+    int ordered = jobs[0].sorted != NULL && jobs[1].sorted != NULL;
+    for (int i = 0; i < 1000 && ordered; i++) {
+        ordered = atoi(row_get_cell(vec_get(jobs[0].sorted, i), 1)) == i &&
+                  atoi(row_get_cell(vec_get(jobs[1].sorted, i), 1)) == 999 - i;
+    }
+    TEST(ordered, "Concurrent sorts keep their own direction", "Concurrent sorts interfered");
+
+    for (size_t i = 0; i < vec_length(many); i++) row_free(vec_get(many, i));
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(jobs[0].sorted);
+    vec_free(jobs[1].sorted);
+    vec_free(many);
+    vec_free(asc);
+    vec_free(desc);
+    vec_free(rows);
+    printf("Test 10: Stable and reentrant sort - Complete\n\n");
+}
+
+// Helper: checks that rows named by their original index are sorted on an
+// integer column, missing cells first and ties in original order
+static int int_order_ok(Vec *sorted, size_t len, int ascending) {
+    if (!sorted || vec_length(sorted) != len) return 0;
+    for (size_t i = 1; i < len; i++) {
+        Row *a = vec_get(sorted, i - 1);
+        Row *b = vec_get(sorted, i);
+        const char *ca = row_get_cell(a, 1);
+        const char *cb = row_get_cell(b, 1);
+        int cmp;
+        if (!ca || !cb) {
+            cmp = (cb == NULL) - (ca == NULL);
+        } else {
+            long long ia = strtoll(ca, NULL, 10), ib = strtoll(cb, NULL, 10);
+            cmp = (ia > ib) - (ia < ib);
+            if (!ascending) cmp = -cmp;
+        }
+        if (cmp > 0 || (cmp == 0 && atoi(row_get_cell(a, 0)) > atoi(row_get_cell(b, 0)))) return 0;
+    }
+    return 1;
+}
+
+// Test 11: Integer columns (radix sorted) with signs, extremes and gaps
+void test_sort_integer_keys(void) {
+    static const char *extremes[] = { "-9223372036854775808", "9223372036854775807", "+42", "-0", "0", "42" };
+    Vec *rows = vec_new(3000);
+    srand(7);
+    for (int i = 0; i < 3000; i++) {
+        char name[16], score[32];
+        snprintf(name, sizeof(name), "%d", i);
+        if (i % 500 == 0) {
+            snprintf(score, sizeof(score), "%s", extremes[(i / 500) % 6]);
+        } else if (i % 3 == 0) {
+            snprintf(score, sizeof(score), "%d", rand() % 1000 - 500);
+        } else {
+            snprintf(score, sizeof(score), "%d", rand() % 40 - 20);
+        }
+        Row *row = i % 97 == 5 ? row_new(1) : make_row(name, score);
+        if (i % 97 == 5) row_set_cell(row, 0, name);
+        vec_push(rows, row);
+    }
+
+    Vec *asc = sort_by_column(rows, 1, 1);
+    Vec *desc = sort_by_column(rows, 1, 0);
+    TEST(int_order_ok(asc, 3000, 1), "Integer keys: ascending, stable", "Integer keys: ascending order wrong");
+    TEST(int_order_ok(desc, 3000, 0), "Integer keys: descending, stable", "Integer keys: descending order wrong");
+    TEST(desc != NULL && row_get_cell(vec_get(desc, 0), 1) == NULL &&
+         row_get_cell(vec_get(desc, 31), 1) != NULL &&
+         strcmp(row_get_cell(vec_get(desc, 31), 1), "9223372036854775807") == 0,
+         "Integer keys: missing cells first, then the largest value",
+         "Integer keys: missing cells or extremes misplaced");
+
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(asc);
+    vec_free(desc);
+    vec_free(rows);
+    printf("Test 11: Integer keys - Complete\n\n");
+}
+
+// Test 12: Parallel sorts give the sequential order
+void test_sort_parallel(void) {
+    Vec *rows = vec_new(100000);
+    Table *table = table_new(2);
+    append_cells(table, (const char *[]){ "name", "score" }, 2);
+    srand(11);
+    for (int i = 0; i < 100000; i++) {
+        char name[16], score[16];
+        snprintf(name, sizeof(name), "n%d", rand() % 5000);
+        snprintf(score, sizeof(score), "%d", rand() % 20000 - 10000);
+        vec_push(rows, make_row(name, score));
+        append_cells(table, (const char *[]){ name, score }, 2);
+    }
+
+    // text and integer columns, both directions, even and odd thread counts
+    static const int threads[] = { 2, 3, 4, 7 };
+    int same = 1;
+    for (int col = 0; col < 2; col++) {
+        for (int asc = 0; asc < 2; asc++) {
+            Vec *expected = sort_by_column(rows, col, asc);
+            for (int t = 0; t < 4; t++) {
+                Vec *sorted = sort_by_column_parallel(rows, col, asc, threads[t]);
+                for (size_t i = 0; i < 100000 && same; i++) {
+                    same = sorted != NULL && expected != NULL && vec_get(sorted, i) == vec_get(expected, i);
+                }
+                vec_free(sorted);
+            }
+            vec_free(expected);
+        }
+    }
+    TEST(same, "Parallel row sorts match the sequential order", "Parallel row sort order differs");
+
+    int table_ok = sort_table_by_column_parallel(table, 0, 0, 4) == 0 &&
+                   sort_table_by_column_parallel(table, 1, 1, 4) == 0;
+    for (size_t i = 2; i <= 100000 && table_ok; i++) {
+        long prev = atol(table_get_cell(table, i - 1, 1)), cur = atol(table_get_cell(table, i, 1));
+        table_ok = prev < cur || (prev == cur && strcmp(table_get_cell(table, i - 1, 0), table_get_cell(table, i, 0)) >= 0);
+    }
+    TEST(table_ok, "Parallel table sort keeps earlier sorts for ties", "Parallel table sort order wrong");
+
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(rows);
+    table_free(table);
+    printf("Test 12: Parallel sort - Complete\n\n");
+}
+
+// Test 13: Numbers and text form one total order
+void test_sort_mixed_kinds(void) {
+    static const char *cells[] = { "10", "abc", "9.5", "", "-0.5", "99999999999999999999", "-1", " x", "0", "+9.50" };
+    static const char *expected[] = { "", " x", "-1", "-0.5", "0", "9.5", "+9.50", "10", "99999999999999999999", "abc" };
+    Vec *rows = vec_new(10);
+    for (int i = 0; i < 10; i++) vec_push(rows, make_row("r", cells[i]));
+
+    Vec *asc = sort_by_column(rows, 1, 1);
+    Vec *desc = sort_by_column(rows, 1, 0);
+    int asc_ok = asc != NULL, desc_ok = desc != NULL;
+    for (int i = 0; i < 10 && asc_ok && desc_ok; i++) {
+        asc_ok = strcmp(row_get_cell(vec_get(asc, i), 1), expected[i]) == 0;
+    }
+    // Descending reverses everything but the tie of 9.5 and +9.50
+    for (int i = 0; i < 10 && desc_ok; i++) {
+        const char *want = i == 3 ? "9.5" : i == 4 ? "+9.50" : expected[9 - i];
+        desc_ok = strcmp(row_get_cell(vec_get(desc, i), 1), want) == 0;
+    }
+    TEST(asc_ok, "Mixed kinds: texts below '+', numbers by value, then text",
+         "Mixed kinds: ascending order wrong");
+    TEST(desc_ok, "Mixed kinds: descending order", "Mixed kinds: descending order wrong");
+
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(asc);
+    vec_free(desc);
+    vec_free(rows);
+    printf("Test 13: Mixed numbers and text - Complete\n\n");
+}
+
+// Test 14: Encoded cells compare with memcmp like sort_key_compare
+void test_sort_key_encode(void) {
+    static const char *cells[] = { NULL, "", " x", "!", "+", "-", ".", "0", "-0", "0.00", ".5", "5.", "+05.50",
+                                   "-0.05", "-0.5", "-12", "-1.2e3", "7", "9", "10", "100.001", "1e3",
+                                   "99999999999999999999", "-99999999999999999999", "abc", "ab", "abcd" };
+    int n = (int)(sizeof(cells) / sizeof(cells[0]));
+    int agree = 1;
+    unsigned char a_buf[64], b_buf[64];
+    for (int dir = 0; dir <= 1; dir++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                SortKey a, b;
+                sort_key_init(&a, cells[i], 0);
+                sort_key_init(&b, cells[j], 0);
+                size_t a_len = sort_key_encode(a_buf, cells[i], dir);
+                size_t b_len = sort_key_encode(b_buf, cells[j], dir);
+                int bytes = memcmp(a_buf, b_buf, a_len < b_len ? a_len : b_len);
+                if (bytes == 0) bytes = (a_len > b_len) - (a_len < b_len);
+                int keys = sort_key_compare(&a, &b, dir);
+                if ((bytes > 0) - (bytes < 0) != (keys > 0) - (keys < 0)) agree = 0;
+            }
+        }
+    }
+    TEST(agree, "Encoded cells order like sort_key_compare", "Encoded cell order differs");
+    printf("Test 14: Encoded sort keys - Complete\n\n");
+}
+
+// Helper: builds a row of three cells
+static Row *make_row3(const char *a, const char *b, const char *c) {
+    Row *r = row_new(3);
+    row_set_cell(r, 0, a);
+    row_set_cell(r, 1, b);
+    row_set_cell(r, 2, c);
+    return r;
+}
+
+// Test 15: Sorting by several columns, each in its own direction
+void test_sort_multi_column(void) {
+    static const char *input[][3] = { { "eng", "90", "Cy" }, { "ops", "70", "Al" }, { "eng", "100", "Bo" },
+                                      { "eng", "90", "Ab" }, { "ops", "70.0", "Ab" }, { "art", "5", "Zed" } };
+    static const char *expected[] = { "Zed", "Bo", "Ab", "Cy", "Ab", "Al" };
+    SortColumn cols[] = { { 0, 1 }, { 1, 0 }, { 2, 1 } };
+
+    Vec *rows = vec_new(6);
+    Table *table = table_new(3);
+    append_cells(table, (const char *[]){ "dept", "score", "name" }, 3);
+    for (int i = 0; i < 6; i++) {
+        vec_push(rows, make_row3(input[i][0], input[i][1], input[i][2]));
+        append_cells(table, input[i], 3);
+    }
+
+    Vec *sorted = sort_by_columns(rows, cols, 3, 1);
+    int rows_ok = sorted != NULL;
+    for (int i = 0; i < 6 && rows_ok; i++) rows_ok = strcmp(row_get_cell(vec_get(sorted, i), 2), expected[i]) == 0;
+    TEST(rows_ok, "Rows sort by dept asc, score desc, name asc", "Multi-column row order wrong");
+
+    int table_ok = sort_table_by_columns(table, cols, 3, 1) == 0 && strcmp(table_get_cell(table, 0, 0), "dept") == 0;
+    for (int i = 0; i < 6 && table_ok; i++) table_ok = strcmp(table_get_cell(table, (size_t)i + 1, 2), expected[i]) == 0;
+    TEST(table_ok, "Table sorts by several columns", "Multi-column table order wrong");
+
+    SortColumn bad[] = { { 0, 1 }, { 3, 1 } };
+    TEST(sort_by_columns(rows, bad, 2, 1) == NULL && sort_by_columns(rows, NULL, 0, 1) == NULL &&
+         sort_table_by_columns(table, bad, 2, 1) == -1,
+         "Multi-column sort rejects bad columns", "Multi-column sort accepted bad columns");
+
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(sorted);
+    vec_free(rows);
+    table_free(table);
+
+    // Large input, with threads, matches stable sorts from the last column to the first
+    Vec *big = vec_new(100000);
+    srand(15);
+    for (int i = 0; i < 100000; i++) {
+        char a[16], b[16], c[16];
+        snprintf(a, sizeof(a), "d%d", rand() % 7);
+        snprintf(b, sizeof(b), i % 3 ? "%d" : "%d.5", rand() % 50 - 25);
+        snprintf(c, sizeof(c), "%d", i);
+        vec_push(big, make_row3(a, b, i % 97 ? c : "x"));
+    }
+    Vec *by_c = sort_by_column(big, 2, 0);
+    Vec *by_b = sort_by_column(by_c, 1, 1);
+    Vec *chained = sort_by_column(by_b, 0, 0);
+    SortColumn big_cols[] = { { 0, 0 }, { 1, 1 }, { 2, 0 } };
+    Vec *multi = sort_by_columns(big, big_cols, 3, 4);
+    int big_ok = chained != NULL && multi != NULL;
+    for (size_t i = 0; i < 100000 && big_ok; i++) big_ok = vec_get(chained, i) == vec_get(multi, i);
+    TEST(big_ok, "Parallel multi-column sort matches chained stable sorts",
+         "Parallel multi-column sort differs from chained sorts");
+
+    for (size_t i = 0; i < vec_length(big); i++) row_free(vec_get(big, i));
+    vec_free(by_c);
+    vec_free(by_b);
+    vec_free(chained);
+    vec_free(multi);
+    vec_free(big);
+    printf("Test 15: Multi-column sort - Complete\n\n");
+}
+
+// Test 16: Decimals and integers sort by value on every sort path
+void test_sort_decimal_column(void) {
+    static const char *cells[] = { "9.5", "10.25", "100", "2" };
+    static const char *expected[] = { "2", "9.5", "10.25", "100" };
+    Vec *rows = vec_new(4);
+    Table *table = table_new(1);
+    append_cells(table, (const char *[]){ "a" }, 1);
+    for (int i = 0; i < 4; i++) {
+        vec_push(rows, make_row("r", cells[i]));
+        append_cells(table, &cells[i], 1);
+    }
+
+    Vec *asc = sort_by_column(rows, 1, 1);
+    Vec *desc = sort_by_column(rows, 1, 0);
+    Vec *encoded = sort_by_columns(rows, &(SortColumn){ 1, 1 }, 1, 1);
+    int table_ok = sort_table_by_column(table, 0, 1) == 0;
+    int ok = asc != NULL && desc != NULL && encoded != NULL;
+    for (int i = 0; i < 4 && ok; i++) {
+        ok = strcmp(row_get_cell(vec_get(asc, i), 1), expected[i]) == 0 &&
+             strcmp(row_get_cell(vec_get(desc, i), 1), expected[3 - i]) == 0 &&
+             strcmp(row_get_cell(vec_get(encoded, i), 1), expected[i]) == 0;
+        table_ok = table_ok && strcmp(table_get_cell(table, (size_t)i + 1, 0), expected[i]) == 0;
+    }
+    TEST(ok, "Decimals sort by value among integers", "Decimal order wrong");
+    TEST(table_ok, "Table sort orders decimals by value", "Table decimal order wrong");
+
+    for (size_t i = 0; i < vec_length(rows); i++) row_free(vec_get(rows, i));
+    vec_free(asc);
+    vec_free(desc);
+    vec_free(encoded);
+    vec_free(rows);
+    table_free(table);
+    printf("Test 16: Decimal column - Complete\n\n");
+}
+
 int main(void) {
     printf("=== Sort Unit Tests ===\n\n");
 
@@ -201,6 +575,14 @@ int main(void) {
     // test_sort_null_row_inside();  // commented: NULL rows cannot exist via vec_push()
     test_sort_repeated_values();
     test_sort_single_row();
+    test_sort_table();
+    test_sort_stable_reentrant();
+    test_sort_integer_keys();
+    test_sort_parallel();
+    test_sort_mixed_kinds();
+    test_sort_key_encode();
+    test_sort_multi_column();
+    test_sort_decimal_column();
 
     printf("=== Test Summary ===\n");
     printf("Tests run: %d\n", tests_run);
@@ -0,0 +1,234 @@
+/*
+* Unit tests for the column-oriented table
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#include "../../include/table.h"
+#include "../../include/row.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Builds a 3-column table: header plus three records (the last one short)
+static Table *make_table(void) {
+     Table *table = table_new(3);
+     static const char header[] = "id\0name\0age";
+     static const char r1[] = "1\0Alice\0" "30";
+     static const char r2[] = "2\0Bob\0" "25";
+     static const char r3[] = "3\0Cara";  // short record: age missing
+     const uint32_t offsets[] = { 0, 3, 8 };
+     const uint32_t short_offsets[] = { 0, 2 };
+
+     table_append_row(table, header, offsets, 3);
+     table_append_row(table, r1, (const uint32_t[]){ 0, 2, 8 }, 3);
+     table_append_row(table, r2, (const uint32_t[]){ 0, 2, 6 }, 3);
+     table_append_row(table, r3, short_offsets, 2);
+     return table;
+}
+
+// Test 1: Appending records and reading cells back
+void test_table_append(void) {
+     Table *table = make_table();
+     TEST(table != NULL, "table_new() succeeds", "table_new() fails");
+     TEST(table_num_rows(table) == 4 && table_num_cols(table) == 3,
+          "table has 4 rows and 3 columns",
+          "table dimensions wrong"
+     );
+     TEST(strcmp(table_get_cell(table, 0, 1), "name") == 0 && strcmp(table_get_cell(table, 1, 1), "Alice") == 0 &&
+          strcmp(table_get_cell(table, 2, 2), "25") == 0,
+          "table_get_cell() returns stored cells",
+          "table_get_cell() returned wrong cells"
+     );
+     TEST(table_get_cell(table, 3, 2) == NULL && table_get_cell(table, 9, 0) == NULL && table_get_cell(table, 0, 3) == NULL,
+          "missing cells and bad indices return NULL",
+          "missing cells or bad indices not NULL"
+     );
+
+     const TableColumn *names = table_column(table, 1);
+     TEST(names != NULL && strcmp(table_column_cell(names, 3), "Cara") == 0,
+          "table_column() gives direct column access",
+          "table_column() access wrong"
+     );
+
+     // records over the column count are cut
+     static const char wide[] = "4\0Dan\0" "40\0extra";
+     TEST(table_append_row(table, wide, (const uint32_t[]){ 0, 2, 6, 9 }, 4) == 0 && table_num_rows(table) == 5 &&
+          strcmp(table_get_cell(table, 4, 2), "40") == 0,
+          "long records keep the first columns",
+          "long record not appended correctly"
+     );
+
+     TEST(table_new(-1) == NULL && table_append_row(NULL, "x", NULL, 0) == -1,
+          "bad input is rejected",
+          "bad input accepted"
+     );
+     table_free(table);
+     table_free(NULL); // safe to pass NULL
+     printf("Test 1: table_append_row() - Complete\n\n");
+}
+
+// Test 2: Visible rows can be reordered and shrunk in place
+void test_table_rows(void) {
+     Table *table = make_table();
+     size_t *rows = table_rows(table);
+
+     // keep the header and Bob only
+     rows[1] = rows[2];
+     TEST(table_set_num_rows(table, 2) == 0 && table_num_rows(table) == 2 &&
+          strcmp(table_get_cell(table, 1, 1), "Bob") == 0,
+          "table_set_num_rows() shrinks the selection",
+          "table_set_num_rows() wrong"
+     );
+     TEST(table_set_num_rows(table, 3) == -1, "selection cannot grow", "selection grew");
+
+     static const char r[] = "5\0Eve\0" "22";
+     TEST(table_append_row(table, r, (const uint32_t[]){ 0, 2, 6 }, 3) == -1,
+          "append is rejected after the selection changed",
+          "append accepted after the selection changed"
+     );
+     table_free(table);
+     printf("Test 2: table_rows() - Complete\n\n");
+}
+
+// Test 3: Projection and row copies
+void test_table_project(void) {
+     Table *table = make_table();
+     int indices[] = { 2, 1, 1 };
+     TEST(table_project(table, indices, 3) == 0 && table_num_cols(table) == 3,
+          "table_project() succeeds",
+          "table_project() fails"
+     );
+
+     Row *header = table_get_row(table, 0);
+     TEST(header != NULL && row_num_cells(header) == 3 && strcmp(row_get_cell(header, 0), "age") == 0 &&
+          strcmp(row_get_cell(header, 2), "name") == 0,
+          "table_get_row() follows the projection",
+          "table_get_row() ignores the projection"
+     );
+     row_free(header);
+
+     Row *short_row = table_get_row(table, 3);
+     TEST(short_row != NULL && row_get_cell(short_row, 0) == NULL && strcmp(row_get_cell(short_row, 1), "Cara") == 0,
+          "missing cells stay missing in row copies",
+          "missing cell copied wrong"
+     );
+     row_free(short_row);
+
+     int bad[] = { 3 };
+     TEST(table_project(table, bad, 1) == -1 && table_num_cols(table) == 3,
+          "out-of-range projection is rejected",
+          "out-of-range projection accepted"
+     );
+     table_free(table);
+     printf("Test 3: table_project() - Complete\n\n");
+}
+
+// Test 4: Empty table
+void test_table_empty(void) {
+     Table *table = table_new(0);
+     TEST(table != NULL && table_num_rows(table) == 0 && table_num_cols(table) == 0,
+          "empty table has no rows or columns",
+          "empty table wrong"
+     );
+     TEST(table_get_row(table, 0) == NULL && table_column(table, 0) == NULL,
+          "empty table has no cells",
+          "empty table returned cells"
+     );
+     table_free(table);
+     printf("Test 4: empty table - Complete\n\n");
+}
+
+// Appends one record whose cells are given as separate strings
+static void append_cells(Table *table, const char **cells, int count) {
+     char line[256];
+     uint32_t offsets[8];
+     size_t len = 0;
+     for (int i = 0; i < count; i++) {
+          offsets[i] = (uint32_t)len;
+          size_t n = strlen(cells[i]) + 1;
+          memcpy(line + len, cells[i], n);
+          len += n;
+     }
+     table_append_row(table, line, offsets, count);
+}
+
+// Test 5: Column types and native values
+void test_table_infer_types(void) {
+     Table *table = table_new(4);
+     append_cells(table, (const char *[]){ "id", "price", "name", "code" }, 4);
+     append_cells(table, (const char *[]){ "1", "2.5", "Alice", "7" }, 4);
+     append_cells(table, (const char *[]){ "-20", "3", "Bob", "x7" }, 4);
+     append_cells(table, (const char *[]){ "+3", "1e2" }, 2);  // short record
+
+     TEST(table_column(table, 0)->type == COLUMN_STRING, "columns start as text", "column typed before inference");
+     TEST(table_infer_types(table) == 0, "table_infer_types() succeeds", "table_infer_types() fails");
+
+     const TableColumn *ids = table_column(table, 0);
+     TEST(ids->type == COLUMN_INT64 && ids->ints[1] == 1 && ids->ints[2] == -20 && ids->ints[3] == 3,
+          "integer column gets int64 values",
+          "integer column typed or parsed wrong"
+     );
+     const TableColumn *prices = table_column(table, 1);
+     TEST(prices->type == COLUMN_DOUBLE && prices->reals[1] == 2.5 && prices->reals[3] == 100.0,
+          "decimal column gets double values",
+          "decimal column typed or parsed wrong"
+     );
+     TEST(table_column(table, 2)->type == COLUMN_STRING && table_column(table, 3)->type == COLUMN_STRING,
+          "text columns stay text",
+          "text column typed as numeric"
+     );
+     TEST(strcmp(table_column_cell(prices, 3), "1e2") == 0, "text is kept next to the values", "text lost");
+     table_free(table);
+
+     // a cell past the sample widens the column
+     table = table_new(1);
+     append_cells(table, (const char *[]){ "n" }, 1);
+     for (int i = 0; i < 1100; i++) append_cells(table, (const char *[]){ "5" }, 1);
+     append_cells(table, (const char *[]){ "0.5" }, 1);
+     append_cells(table, (const char *[]){ "99999999999999999999" }, 1);  // too big for int64
+     table_infer_types(table);
+     const TableColumn *column = table_column(table, 0);
+     TEST(column->type == COLUMN_DOUBLE && column->ints == NULL && column->reals[1101] == 0.5,
+          "late non-integer cells widen the column",
+          "late cell not handled"
+     );
+     table_free(table);
+
+     TEST(table_infer_types(NULL) == -1, "NULL table is rejected", "NULL table accepted");
+     printf("Test 5: table_infer_types() - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Table Unit Tests ===\n\n");
+
+     test_table_append();
+     test_table_rows();
+     test_table_project();
+     test_table_empty();
+     test_table_infer_types();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
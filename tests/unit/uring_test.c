@@ -0,0 +1,126 @@
+/*
+* Unit tests for io_uring input streams
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/uring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Writes size bytes of a counting pattern (mod 251) to a temp file
+static int write_pattern(char *path, size_t size) {
+     int fd = mkstemp(path);
+     if (fd < 0) return -1;
+
+     char buf[4096];
+     for (size_t done = 0; done < size;) {
+          size_t n = size - done < sizeof(buf) ? size - done : sizeof(buf);
+          for (size_t i = 0; i < n; i++) buf[i] = (char)((done + i) % 251);
+          if (write(fd, buf, n) != (ssize_t)n) {
+               close(fd);
+               return -1;
+          }
+          done += n;
+     }
+     close(fd);
+     return 0;
+}
+
+// Reads a stream to its end in odd-sized chunks, checking the pattern
+static size_t read_pattern(FILE *stream, int *matches) {
+     char buf[7777];
+     size_t total = 0;
+     size_t n;
+     *matches = 1;
+     while ((n = fread(buf, 1, sizeof(buf), stream)) > 0) {
+          for (size_t i = 0; i < n; i++) {
+               if (buf[i] != (char)((total + i) % 251)) *matches = 0;
+          }
+          total += n;
+     }
+     return total;
+}
+
+// Test 1: A file larger than the queue arrives whole and in order
+void test_uring_read(void) {
+     char path[] = "/tmp/csvlite_uring_XXXXXX";
+     size_t size = (size_t)URING_QUEUE_DEPTH * URING_BLOCK_SIZE * 2 + 12345;
+     if (write_pattern(path, size) != 0) return;
+
+     FILE *stream = uring_open(path);
+     int matches = 0;
+     size_t total = stream != NULL ? read_pattern(stream, &matches) : 0;
+     TEST(total == size && matches && !ferror(stream), "bytes arrive in order across blocks", "bytes lost or reordered");
+     if (stream != NULL) fclose(stream);
+
+     // closing with reads still in flight
+     stream = uring_open(path);
+     char buf[100];
+     TEST(stream != NULL && fread(buf, 1, sizeof(buf), stream) == sizeof(buf) && fclose(stream) == 0,
+          "closing with reads in flight succeeds",
+          "close with reads in flight failed"
+     );
+     unlink(path);
+     printf("Test 1: io_uring reads - Complete\n\n");
+}
+
+// Test 2: Empty, missing and non-regular files
+void test_uring_edge_cases(void) {
+     char path[] = "/tmp/csvlite_uring_XXXXXX";
+     if (write_pattern(path, 0) != 0) return;
+
+     FILE *stream = uring_open(path);
+     char buf[16];
+     TEST(stream != NULL && fread(buf, 1, sizeof(buf), stream) == 0 && feof(stream),
+          "empty file reads as end of input",
+          "empty file not handled"
+     );
+     if (stream != NULL) fclose(stream);
+     unlink(path);
+
+     TEST(uring_open(NULL) == NULL && uring_open("/tmp/csvlite_uring_missing.csv") == NULL && uring_open("/tmp") == NULL,
+          "missing and non-regular files are rejected",
+          "bad path accepted"
+     );
+     printf("Test 2: io_uring edge cases - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== io_uring Unit Tests ===\n\n");
+
+     if (uring_supported()) {
+          test_uring_read();
+          test_uring_edge_cases();
+     } else {
+          printf("io_uring unavailable, skipping\n\n");
+     }
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
@@ -9,6 +9,7 @@
 
 #include "../../include/where.h"
 #include "../../include/row.h"
+#include "../../include/table.h"
 #include "../../include/vec.h"
 
 #include <stdio.h>
@@ -394,6 +395,111 @@ static void test_where_missing_rhs(void) {
     printf("Test 4b: missing RHS - Complete\n\n");
 }
 
+/* Test 5: compiled condition checked row by row */
+static void test_where_compile_and_match(void) {
+    Vec *rows = build_sample_rows();
+    Row *header = vec_get(rows, 0);
+
+    WhereCond *cond = where_compile(header, "age>=19");
+    TEST(cond != NULL,
+         "where_compile accepts valid condition",
+         "where_compile rejected valid condition");
+    TEST(where_match(cond, vec_get(rows, 1)) == 1 && where_match(cond, vec_get(rows, 3)) == 0,
+         "where_match checks rows against compiled condition",
+         "where_match returned wrong result");
+    TEST(where_match(cond, NULL) == 0,
+         "where_match with NULL row returns 0",
+         "where_match with NULL row should return 0");
+    where_free(cond);
+
+    TEST(where_compile(header, "nosuchcol==1") == NULL,
+         "where_compile rejects unknown column",
+         "where_compile should reject unknown column");
+    TEST(where_compile(NULL, "age>=19") == NULL,
+         "where_compile rejects NULL header",
+         "where_compile should reject NULL header");
+    where_free(NULL);
+
+    free_sample(rows, NULL);
+    printf("Test 5: where_compile and where_match - Complete\n\n");
+}
+
+// Helper: appends one record given as separate cells to a table
+static void append_cells(Table *table, const char *const *cells, int n) {
+    char line[256];
+    uint32_t offsets[8];
+    size_t len = 0;
+    for (int i = 0; i < n; i++) {
+        offsets[i] = (uint32_t)len;
+        strcpy(line + len, cells[i]);
+        len += strlen(cells[i]) + 1;
+    }
+    table_append_row(table, line, offsets, n);
+}
+
+/* Test: column scan over a Table keeps the header and matching rows */
+static void test_where_filter_table(void) {
+    Table *table = table_new(3);
+    append_cells(table, (const char *[]){ "name", "age", "gpa" }, 3);
+    append_cells(table, (const char *[]){ "Alice", "20", "3.9" }, 3);
+    append_cells(table, (const char *[]){ "Bob", "19", "3.5" }, 3);
+    append_cells(table, (const char *[]){ "Carl", "17", "2.8" }, 3);
+
+    TEST(where_filter_table(table, "age>=18") == 0 && table_num_rows(table) == 3,
+         "where_filter_table keeps header plus two rows",
+         "where_filter_table kept wrong number of rows");
+    TEST(strcmp(table_get_cell(table, 0, 0), "name") == 0 && strcmp(table_get_cell(table, 1, 0), "Alice") == 0
+         && strcmp(table_get_cell(table, 2, 0), "Bob") == 0,
+         "where_filter_table keeps input order",
+         "where_filter_table order wrong");
+    TEST(where_filter_table(table, "name==Bob") == 0 && table_num_rows(table) == 2,
+         "where_filter_table narrows an already filtered table",
+         "second where_filter_table wrong");
+    TEST(where_filter_table(table, "missing==1") == -1 && where_filter_table(NULL, "age>1") == -1,
+         "where_filter_table rejects unknown column and NULL table",
+         "where_filter_table accepted bad input");
+
+    table_free(table);
+}
+
+/* Test: block summaries rule out blocks only when no row can match */
+static void test_where_may_match_range(void) {
+    Vec *rows = build_sample_rows();
+    Row *header = vec_get(rows, 0);
+
+    WhereCond *gt = where_compile(header, "age>18");
+    WhereCond *le = where_compile(header, "age<=-1");
+    WhereCond *lt = where_compile(header, "age<1");
+    WhereCond *eq = where_compile(header, "age==5");
+    int col = -1;
+
+    TEST(where_ordering(gt, &col) == 1 && col == 1 && where_ordering(eq, NULL) == 0,
+         "where_ordering reports ordering conditions and their column",
+         "where_ordering wrong");
+    TEST(where_column(eq) == 1 && where_column(NULL) == -1,
+         "where_column reports the tested column",
+         "where_column wrong");
+    TEST(where_may_match_range(gt, 10, 18, 0) == 0 && where_may_match_range(gt, 10, 19, 0) == 1,
+         "> is ruled out only when the block maximum fails",
+         "> range check wrong");
+    TEST(where_may_match_range(le, 0, 5, 0) == 0 && where_may_match_range(le, -3, 5, 0) == 1,
+         "<= is ruled out only when the block minimum fails",
+         "<= range check wrong");
+    TEST(where_may_match_range(gt, 1, 0, 1) == 0 && where_may_match_range(lt, 5, 9, 1) == 1,
+         "empty cells count as 0 and blocks without values match nothing else",
+         "empty cells handled wrong");
+    TEST(where_may_match_range(eq, 100, 200, 0) == 1,
+         "equality is never ruled out by a range",
+         "equality ruled out by a range");
+
+    where_free(gt);
+    where_free(le);
+    where_free(lt);
+    where_free(eq);
+    free_sample(rows, NULL);
+    printf("Test 6: where_may_match_range - Complete\n\n");
+}
+
 int main(void) {
     printf("=== WHERE Unit Tests ===\n\n");
 
@@ -412,6 +518,9 @@ int main(void) {
 
     test_where_invalid_condition();
     test_where_missing_rhs();
+    test_where_compile_and_match();
+    test_where_filter_table();
+    test_where_may_match_range();
 
     printf("=== Test Summary ===\n");
     printf("Tests run: %d\n", tests_run);
@@ -0,0 +1,161 @@
+/*
+* Unit tests for the buffered writer
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/writer.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Reads the whole file at path into buf (NUL-terminated), returns its length
+static size_t read_file(const char *path, char *buf, size_t cap) {
+     FILE *f = fopen(path, "rb");
+     if (f == NULL) return 0;
+     size_t n = fread(buf, 1, cap - 1, f);
+     buf[n] = '\0';
+     fclose(f);
+     return n;
+}
+
+// Test 1: Small writes are buffered until flush
+void test_writer_buffering(void) {
+     char path[] = "/tmp/writer_testXXXXXX";
+     int fd = mkstemp(path);
+     Writer *writer = writer_open_fd(fd, 0);
+     TEST(writer != NULL, "writer_open_fd() succeeds", "writer_open_fd() fails");
+
+     writer_write(writer, "id,name\n", 8);
+     writer_write(writer, "1,Alice\n", 8);
+     char buf[64];
+     TEST(read_file(path, buf, sizeof(buf)) == 0, "writes stay in the buffer", "writes reached the file early");
+
+     TEST(writer_flush(writer) == 0, "writer_flush() succeeds", "writer_flush() fails");
+     TEST(read_file(path, buf, sizeof(buf)) == 16 && strcmp(buf, "id,name\n1,Alice\n") == 0,
+          "writer_flush() writes buffered bytes",
+          "writer_flush() wrote wrong bytes"
+     );
+
+     TEST(writer_close(writer) == 0, "writer_close() succeeds", "writer_close() fails");
+     TEST(write(fd, "", 0) == 0, "writer_close() leaves a borrowed fd open", "writer_close() closed a borrowed fd");
+     close(fd);
+     unlink(path);
+
+     TEST(writer_open_fd(-1, 0) == NULL && writer_close(NULL) == 0,
+          "bad fd and NULL writer are handled",
+          "bad fd or NULL writer mishandled"
+     );
+     printf("Test 1: writer buffering - Complete\n\n");
+}
+
+// Test 2: Writes larger than the buffer keep their order
+void test_writer_large_writes(void) {
+     char path[] = "/tmp/writer_testXXXXXX";
+     int fd = mkstemp(path);
+     Writer *writer = writer_open_fd(fd, 8); // tiny buffer forces flushes and writev
+     char expected[256];
+     size_t len = 0;
+
+     const char *parts[] = { "abc", "defgh", "0123456789abcdef", "x", "yz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "!" };
+     for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+          writer_write(writer, parts[i], strlen(parts[i]));
+          memcpy(expected + len, parts[i], strlen(parts[i]));
+          len += strlen(parts[i]);
+     }
+     expected[len] = '\0';
+     TEST(writer_close(writer) == 0, "writer_close() succeeds", "writer_close() fails");
+
+     char buf[256];
+     TEST(read_file(path, buf, sizeof(buf)) == len && strcmp(buf, expected) == 0,
+          "mixed small and large writes arrive in order",
+          "mixed writes reordered or lost"
+     );
+     close(fd);
+     unlink(path);
+     printf("Test 2: writer large writes - Complete\n\n");
+}
+
+// Test 3: writer_open_path truncates and owns the file
+void test_writer_open_path(void) {
+     char path[] = "/tmp/writer_testXXXXXX";
+     int fd = mkstemp(path);
+     TEST(write(fd, "old contents\n", 13) == 13, "file prepared", "file not prepared");
+     close(fd);
+
+     Writer *writer = writer_open_path(path);
+     TEST(writer != NULL, "writer_open_path() succeeds", "writer_open_path() fails");
+     writer_write(writer, "new\n", 4);
+     TEST(writer_close(writer) == 0, "writer_close() succeeds", "writer_close() fails");
+
+     char buf[64];
+     TEST(read_file(path, buf, sizeof(buf)) == 4 && strcmp(buf, "new\n") == 0,
+          "writer_open_path() truncates the file",
+          "writer_open_path() kept old contents"
+     );
+     unlink(path);
+
+     TEST(writer_open_path("/nonexistent_dir/out.csv") == NULL && writer_open_path(NULL) == NULL,
+          "writer_open_path() returns NULL for bad paths",
+          "writer_open_path() accepted a bad path"
+     );
+     printf("Test 3: writer_open_path() - Complete\n\n");
+}
+
+// Test 4: A failed write is sticky and reported by writer_close
+void test_writer_errors(void) {
+     int fd = open("/dev/null", O_RDONLY); // not writable
+     Writer *writer = writer_open_fd(fd, 0);
+
+     TEST(writer_write(writer, "data", 4) == 0 && !writer_failed(writer),
+          "buffered write succeeds before flush",
+          "buffered write failed early"
+     );
+     TEST(writer_flush(writer) == -1 && writer_failed(writer), "failed flush is reported", "failed flush not reported");
+     TEST(writer_write(writer, "more", 4) == -1, "writes fail after an error", "write succeeded after an error");
+     TEST(writer_close(writer) == -1, "writer_close() reports the error", "writer_close() hid the error");
+     close(fd);
+
+     TEST(writer_write(NULL, "x", 1) == -1 && writer_flush(NULL) == -1 && writer_failed(NULL),
+          "NULL writer is rejected",
+          "NULL writer not rejected"
+     );
+     printf("Test 4: writer errors - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Writer Unit Tests ===\n\n");
+
+     test_writer_buffering();
+     test_writer_large_writes();
+     test_writer_open_path();
+     test_writer_errors();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}
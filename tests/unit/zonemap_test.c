@@ -0,0 +1,171 @@
+/*
+* Unit tests for the on-disk zone map
+*
+* AUTHOR: Billy Wu
+* DATE: October 16, 2026
+* VERSION: v2.1.0
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "../../include/zonemap.h"
+#include "../../include/csv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+// Macro for testing assertions
+#define TEST(condition, success_message, failure_message) \
+     do { \
+          tests_run++; \
+          if (condition) { \
+               tests_passed++; \
+               printf("PASS: %s\n", success_message); \
+          } else { \
+               printf("FAIL: %s\n", failure_message); \
+          } \
+     } while(0)
+
+// Number of data records: two full blocks and a partial one
+#define NUM_RECORDS (2 * ZONEMAP_BLOCK_ROWS + 10)
+
+// Writes "id,val" plus NUM_RECORDS records to a temp file and returns its
+// path in path; val counts up from 0, except one empty cell in the last block
+static void make_source(char *path) {
+     FILE *file = fdopen(mkstemp(path), "w");
+     if (file == NULL) return;
+
+     fprintf(file, "id,val\n");
+     for (int i = 0; i < NUM_RECORDS; i++) {
+          if (i == NUM_RECORDS - 1) {
+               fprintf(file, "%d,\n", i);
+          } else {
+               fprintf(file, "%d,%d\n", i, i);
+          }
+     }
+     fclose(file);
+}
+
+// Builds the zone map of column for the file at path
+static int build(const char *path, int column, const CacheKey *key) {
+     CsvMap *map = csv_map_open(path);
+     CsvReader *reader = csv_reader_open_mapped(map);
+     Row *header = csv_reader_next(reader);
+     row_free(header);
+     int result = zonemap_build(reader, column, path, key);
+     csv_reader_close(reader);
+     csv_map_close(map);
+     return result;
+}
+
+// Removes the source file and its zone map of column
+static void remove_source(const char *path, int column) {
+     char zonemap_path[256];
+     snprintf(zonemap_path, sizeof(zonemap_path), "%s.%d%s", path, column, ZONEMAP_SUFFIX);
+     unlink(zonemap_path);
+     unlink(path);
+}
+
+// Test 1: Blocks cover the records in order with their value ranges
+void test_zonemap_blocks(void) {
+     char path[] = "/tmp/zonemap_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     cache_key(path, &key);
+
+     TEST(zonemap_open(path, 1, &key) == NULL, "no zone map before it is built", "zone map found before building");
+     TEST(build(path, 1, &key) == 0, "zonemap_build() succeeds", "zonemap_build() fails");
+
+     ZoneMap *zonemap = zonemap_open(path, 1, &key);
+     TEST(zonemap != NULL && zonemap_num_blocks(zonemap) == 3, "zone map has three blocks", "wrong number of blocks");
+
+     const ZoneBlock *first = zonemap_block(zonemap, 0);
+     const ZoneBlock *second = zonemap_block(zonemap, 1);
+     const ZoneBlock *last = zonemap_block(zonemap, 2);
+     TEST(first != NULL && first->start == 7 && first->num_rows == ZONEMAP_BLOCK_ROWS &&
+          first->min_value == 0 && first->max_value == ZONEMAP_BLOCK_ROWS - 1 && first->num_empty == 0,
+          "first block starts after the header and spans its values",
+          "first block wrong"
+     );
+     TEST(second != NULL && second->start == first->end && second->min_value == ZONEMAP_BLOCK_ROWS &&
+          last != NULL && last->start == second->end && last->end == key.size,
+          "blocks are contiguous and the last one ends with the file",
+          "block ranges wrong"
+     );
+     TEST(last != NULL && last->num_rows == 10 && last->num_empty == 1 &&
+          last->max_value == NUM_RECORDS - 2,
+          "empty cells are counted, not ranged",
+          "empty cells handled wrong"
+     );
+     TEST(zonemap_block(zonemap, 3) == NULL, "out-of-bounds block is NULL", "out-of-bounds block returned");
+
+     // a block's start is where its first record begins
+     CsvMap *map = csv_map_open(path);
+     CsvReader *reader = csv_reader_open_mapped(map);
+     Row *row = (second != NULL && csv_reader_seek(reader, second->start) == 0) ? csv_reader_next(reader) : NULL;
+     TEST(row != NULL && atoi(row_get_cell(row, 0)) == ZONEMAP_BLOCK_ROWS,
+          "block start leads to its first record",
+          "block start led elsewhere"
+     );
+     row_free(row);
+     csv_reader_close(reader);
+     csv_map_close(map);
+
+     zonemap_close(zonemap);
+     zonemap_close(NULL); // safe to pass NULL
+     remove_source(path, 1);
+     printf("Test 1: zone map blocks - Complete\n\n");
+}
+
+// Test 2: Stale, mismatched and damaged zone maps are ignored
+void test_zonemap_invalid(void) {
+     char path[] = "/tmp/zonemap_testXXXXXX";
+     make_source(path);
+     CacheKey key;
+     cache_key(path, &key);
+     build(path, 0, &key);
+
+     CacheKey changed = key;
+     changed.mtime_sec++;
+     TEST(zonemap_open(path, 0, &changed) == NULL, "zone map of an older version is stale", "stale zone map used");
+     TEST(zonemap_open(path, 1, &key) == NULL, "zone map of another column is not used", "wrong column zone map used");
+     ZoneMap *kept = build(path, 0, &changed) == -1 ? zonemap_open(path, 0, &key) : NULL;
+     TEST(kept != NULL,
+          "a source changed during the build is not summarized",
+          "zone map written for a changed source"
+     );
+     zonemap_close(kept);
+
+     char zonemap_path[256];
+     snprintf(zonemap_path, sizeof(zonemap_path), "%s.0%s", path, ZONEMAP_SUFFIX);
+     TEST(truncate(zonemap_path, 100) == 0 && zonemap_open(path, 0, &key) == NULL,
+          "truncated zone map is rejected",
+          "truncated zone map accepted"
+     );
+
+     TEST(zonemap_open(NULL, 0, &key) == NULL && zonemap_num_blocks(NULL) == 0 &&
+          zonemap_build(NULL, 0, path, &key) == -1,
+          "NULL input is rejected",
+          "NULL input accepted"
+     );
+     remove_source(path, 0);
+     printf("Test 2: invalid zone maps - Complete\n\n");
+}
+
+int main(void) {
+     printf("=== Zone Map Unit Tests ===\n\n");
+
+     test_zonemap_blocks();
+     test_zonemap_invalid();
+
+     printf("=== Test Summary ===\n");
+     printf("Tests run: %d\n", tests_run);
+     printf("Tests passed: %d\n", tests_passed);
+     printf("Tests failed: %d\n", tests_run - tests_passed);
+
+     return (tests_run == tests_passed) ? 0 : 1;
+}